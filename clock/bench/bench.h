@@ -0,0 +1,120 @@
+#pragma once
+// -----------------------------------------------------------------------------
+// Минимальная обвязка для микробенчмарков (без внешних зависимостей)
+//
+// Результаты печатаются в консоль; если задана переменная окружения
+// WRCLOCK_BENCH_JSON=<файл>, при выходе они же пишутся в JSON (по объекту
+// на строку) — такие файлы сравнивает bench_compare.
+// -----------------------------------------------------------------------------
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#ifndef BENCH_SUITE
+#define BENCH_SUITE "bench"
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+template <typename T>
+inline void DoNotOptimize(const T& v) { asm volatile("" : : "r,m"(v) : "memory"); }
+#else
+template <typename T>
+inline void DoNotOptimize(const T& v)
+{
+    static volatile const void* sink;
+    sink = &v;
+}
+#endif
+
+inline int64_t BenchNowNs()
+{
+    using namespace std::chrono;
+    return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+struct BenchResult {
+    const char* name;
+    int64_t     ops;
+    double      nsPerOp;
+};
+
+// Накопитель результатов для JSON; пишет файл в деструкторе (при выходе из main)
+class BenchJson {
+public:
+    static BenchJson& Get()
+    {
+        static BenchJson json;
+        return json;
+    }
+
+    void Timing(const char* name, int64_t ops, double nsPerOp)
+    {
+        m_rows.push_back(Row{ name, "ns/op", nsPerOp, ops });
+    }
+    void Metric(const char* name, double value, const char* unit)
+    {
+        m_rows.push_back(Row{ name, unit, value, 0 });
+    }
+
+    ~BenchJson()
+    {
+        const char* path = std::getenv("WRCLOCK_BENCH_JSON");
+        if (!path || !*path) return;
+        FILE* f = std::fopen(path, "w");
+        if (!f) { std::fprintf(stderr, "cannot write %s\n", path); return; }
+        std::fprintf(f, "{\"suite\": \"%s\", \"results\": [\n", BENCH_SUITE);
+        for (size_t i = 0; i < m_rows.size(); ++i)
+        {
+            const Row& r = m_rows[i];
+            std::fprintf(f, "  {\"name\": \"%s\", \"unit\": \"%s\", \"value\": %.4f, \"ops\": %lld}%s\n",
+                         Escape(r.name).c_str(), r.unit.c_str(), r.value,
+                         static_cast<long long>(r.ops), i + 1 < m_rows.size() ? "," : "");
+        }
+        std::fprintf(f, "]}\n");
+        std::fclose(f);
+    }
+
+private:
+    struct Row {
+        std::string name;
+        std::string unit;
+        double      value;
+        int64_t     ops;
+    };
+
+    static std::string Escape(const std::string& s)
+    {
+        std::string out;
+        for (char c : s)
+        {
+            if (c == '"' || c == '\\') out.push_back('\\');
+            out.push_back(c);
+        }
+        return out;
+    }
+
+    std::vector<Row> m_rows;
+};
+
+// Произвольная величина (пропускная способность, число пробуждений и т.п.)
+inline void BenchMetric(const char* name, double value, const char* unit)
+{
+    BenchJson::Get().Metric(name, value, unit);
+}
+
+// Выполняет fn(i) для i = 0..ops-1 и печатает среднее время одной операции
+template <typename F>
+BenchResult RunBench(const char* name, int64_t ops, F&& fn)
+{
+    for (int64_t i = 0; i < ops / 16; ++i) fn(i);   // прогрев
+    int64_t t0 = BenchNowNs();
+    for (int64_t i = 0; i < ops; ++i) fn(i);
+    int64_t t1 = BenchNowNs();
+    BenchResult r{ name, ops, double(t1 - t0) / double(ops) };
+    std::printf("%-40s %12.2f ns/op\n", r.name, r.nsPerOp);
+    BenchJson::Get().Timing(r.name, r.ops, r.nsPerOp);
+    return r;
+}
@@ -0,0 +1,109 @@
+// Разметка логов игровым временем: пропускная способность на одном и на всех
+// ядрах, цена разбора метки против sscanf и перевод пачкой против GameMinute
+#include <cstdio>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include "bench.h"
+#include "log_annotate.h"
+
+class NullLogSink : public LogSink {
+public:
+    bool Write(const LogSpan* spans, size_t count) override
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            DoNotOptimize(spans[i].data);
+            bytes += spans[i].size;
+        }
+        return true;
+    }
+    size_t bytes = 0;
+};
+
+static std::string MakeLog(size_t lines)
+{
+    std::mt19937 rng(3);
+    auto r = [&](unsigned n) { return static_cast<unsigned>(rng() % n); };
+    std::string s;
+    char line[160];
+    unsigned sec = 0;
+    for (size_t i = 0; i < lines; ++i)
+    {
+        sec += r(3);
+        int n;
+        if (r(10) == 0)
+            n = std::snprintf(line, sizeof(line), "    at handler.cpp:%u (stack frame %u)\n", r(900), r(20));
+        else
+            n = std::snprintf(line, sizeof(line),
+                              "2025-03-%02u %02u:%02u:%02u.%03u INFO [chat] player%u: message number %u\n",
+                              11 + sec / 86400 % 17, sec / 3600 % 24, sec / 60 % 60, sec % 60, r(1000),
+                              r(5000), r(100000));
+        s.append(line, static_cast<size_t>(n));
+    }
+    return s;
+}
+
+int main()
+{
+    const size_t lines = 2000000;
+    std::string log = MakeLog(lines);
+    double mb = double(log.size()) / (1 << 20);
+    GameClock clock;
+    int64_t now = WallTicksNow();
+    clock.SetGameTime(now, 12 * 60);
+
+    unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+    for (unsigned threads : { 1u, cores })
+    {
+        NullLogSink sink;
+        LogAnnotateOptions options;
+        options.threads = threads;
+        LogAnnotateReport report;
+        int64_t t0 = BenchNowNs();
+        AnnotateLog(log.data(), log.size(), clock, now, options, &sink, &report);
+        double sec = double(BenchNowNs() - t0) / 1e9;
+        char name[64];
+        std::snprintf(name, sizeof(name), "AnnotateLog, %u thread%s", threads, threads == 1 ? "" : "s");
+        std::printf("%-40s %8.1f MB/s  %zu lines, %zu annotated\n", name, mb / sec, report.lines,
+                    report.annotated);
+        BenchMetric(name, mb / sec, "MB/s");
+        if (cores == 1) break;
+    }
+
+    // Метка времени по отдельности
+    std::vector<std::string> stamps;
+    for (size_t p = 0; stamps.size() < 4096; p = log.find('\n', p) + 1)
+        if (log[p] == '2') stamps.push_back(log.substr(p, 23));
+    const int64_t ops = 2000000;
+    RunBench("sscanf %d-%d-%d %d:%d:%d.%d", ops, [&](int64_t i) {
+        int y, mo, d, h, mi, s, ms;
+        std::sscanf(stamps[i & 4095].c_str(), "%d-%d-%d %d:%d:%d.%d", &y, &mo, &d, &h, &mi, &s, &ms);
+        DoNotOptimize(y + mo + d + h + mi + s + ms);
+    });
+    RunBench("ParseLogTimestamp", ops, [&](int64_t i) {
+        const std::string& s = stamps[i & 4095];
+        int64_t t = 0;
+        DoNotOptimize(ParseLogTimestamp(s.data(), s.data() + s.size(), 0, &t));
+        DoNotOptimize(t);
+    });
+
+    // Перевод в игровые минуты
+    std::vector<int64_t> at(4096), minutes(4096);
+    for (size_t i = 0; i < at.size(); ++i) at[i] = now + int64_t(i) * 3333333;
+    RunBench("GameClock::GameMinute", ops, [&](int64_t i) {
+        DoNotOptimize(clock.GameMinute(at[i & 4095]));
+    });
+    const int64_t batches = ops / 4096;
+    int64_t t0 = BenchNowNs();
+    for (int64_t b = 0; b < batches; ++b)
+    {
+        clock.GameMinutes(at.data(), minutes.data(), at.size());
+        DoNotOptimize(minutes[b & 4095]);
+    }
+    double ns = double(BenchNowNs() - t0) / double(batches * 4096);
+    std::printf("%-40s %8.2f ns/op\n", "GameClock::GameMinutes (x4096)", ns);
+    BenchJson::Get().Timing("GameClock::GameMinutes (x4096)", batches * 4096, ns);
+    return 0;
+}
@@ -0,0 +1,84 @@
+// Календарь событий: поиск ближайших событий по индексу против перебора правил
+#include <cstdio>
+#include <random>
+#include <vector>
+#include "bench.h"
+#include "game_calendar.h"
+
+// Перебор: у каждого правила ближайшее событие после минуты, затем минимум
+static int64_t NaiveNext(const std::vector<CalendarRule>& rules, int64_t minute, uint32_t* id)
+{
+    int64_t best = INT64_MAX;
+    for (const CalendarRule& r : rules)
+    {
+        int64_t m = minute + 1 + FloorMod(r.phase - (minute + 1), r.period);
+        if (m < best) { best = m; *id = r.id; }
+    }
+    return best;
+}
+
+static void Fill(std::vector<CalendarRule>* rules, size_t n, bool mixed, std::mt19937_64& rng)
+{
+    static const int HOURS[] = { 1, 2, 3, 4, 6, 8, 12 };
+    for (uint32_t i = 0; i < n; ++i)
+    {
+        int kind = rng() % 3;
+        int minute = static_cast<int>(rng() % MINUTES_IN_DAY);
+        if (kind == 0)
+            rules->push_back(CalendarRule::Daily(minute, i));
+        else if (kind == 1)
+            rules->push_back(CalendarRule::Every(HOURS[rng() % 7] * 60, rng() % 720, i));
+        else
+        {
+            // "Смешанный" набор: периоды в днях от 2 до 30 — общий период огромен
+            int days = mixed ? 2 + rng() % 29 : 7;
+            rules->push_back(CalendarRule::EveryNthDay(days, static_cast<int>(rng() % days), minute, i));
+        }
+    }
+}
+
+int main()
+{
+    std::mt19937_64 rng(11);
+    GameClock clock;
+    clock.SetGameTime(133000000000000000LL, 0);
+    const int64_t t0 = 133000000000000000LL;
+    const size_t N = 10000;
+
+    for (bool mixed : { false, true })
+    {
+        std::vector<CalendarRule> rules;
+        Fill(&rules, N, mixed, rng);
+        GameCalendar cal;
+        for (const CalendarRule& r : rules) cal.Add(r);
+        int64_t b0 = BenchNowNs();
+        cal.Build();
+        std::printf("%zu rules, %s index, build %.2f ms\n", N, cal.Flat() ? "flat" : "grouped",
+                    double(BenchNowNs() - b0) / 1e6);
+
+        CalendarOccurrence occ[16];
+        uint32_t id = 0;
+        RunBench("naive scan: next event", 2000, [&](int64_t i) {
+            DoNotOptimize(NaiveNext(rules, i * 7919, &id));
+        });
+        RunBench("GameCalendar::Next (1)", 200000, [&](int64_t i) {
+            DoNotOptimize(cal.Next(clock, t0 + i * 7919 * GAME_MINUTE_TICKS, 1, occ));
+        });
+        RunBench("naive scan: next 16 events", 200, [&](int64_t i) {
+            int64_t m = i * 7919;
+            for (int k = 0; k < 16; ++k) m = NaiveNext(rules, m, &id);
+            DoNotOptimize(m);
+        });
+        RunBench("GameCalendar::Next (16)", 200000, [&](int64_t i) {
+            DoNotOptimize(cal.Next(clock, t0 + i * 7919 * GAME_MINUTE_TICKS, 16, occ));
+        });
+        std::vector<CalendarOccurrence> range;
+        RunBench("GameCalendar::Range (1 game hour)", 20000, [&](int64_t i) {
+            range.clear();
+            int64_t from = t0 + i * 7919 * GAME_MINUTE_TICKS;
+            cal.Range(clock, from, from + 60 * GAME_MINUTE_TICKS, &range);
+            DoNotOptimize(range.size());
+        });
+    }
+    return 0;
+}
@@ -0,0 +1,89 @@
+// Seqlock в разделяемой памяти: читатели против одного писателя
+#include <atomic>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sys/mman.h>
+#include <unistd.h>
+#include "bench.h"
+#include "clock_shm.h"
+
+struct ReaderStats {
+    int64_t reads = 0;
+    int64_t retries = 0;
+    int64_t torn = 0;    // несогласованные снимки (должно быть 0)
+    char    pad[40];
+};
+
+// writerPauseNs: 0 — писатель публикует без остановки (худший случай)
+static void Run(const char* name, int readers, int64_t writerPauseNs, int64_t durationNs)
+{
+    ClockPublisher pub;
+    pub.Open(name);
+    GameClockState s;
+    pub.Publish(s);
+
+    std::atomic<bool> stop{ false };
+    std::vector<ReaderStats> stats(readers);
+    std::vector<std::thread> pool;
+    for (int r = 0; r < readers; ++r)
+    {
+        pool.emplace_back([&, r] {
+            ClockSubscriber sub;
+            sub.Open(name);
+            ReaderStats& st = stats[r];
+            ClockSnapshot snap;
+            uint64_t lastGen = 0;
+            while (!stop.load(std::memory_order_relaxed))
+            {
+                if (!sub.TryRead(&snap)) { ++st.retries; continue; }
+                // Писатель держит start == offset, поколения не убывают
+                if (snap.state.start != snap.state.offset || snap.generation < lastGen)
+                    ++st.torn;
+                lastGen = snap.generation;
+                ++st.reads;
+            }
+        });
+    }
+
+    int64_t writes = 0;
+    int64_t t0 = BenchNowNs();
+    while (BenchNowNs() - t0 < durationNs)
+    {
+        s.start = s.offset = writes + 1;
+        pub.Publish(s);
+        ++writes;
+        if (writerPauseNs)
+        {
+            int64_t until = BenchNowNs() + writerPauseNs;
+            while (BenchNowNs() < until) std::this_thread::yield();
+        }
+    }
+    stop = true;
+    for (auto& t : pool) t.join();
+    double secs = double(BenchNowNs() - t0) / 1e9;
+
+    int64_t reads = 0, retries = 0, torn = 0;
+    for (auto& st : stats) { reads += st.reads; retries += st.retries; torn += st.torn; }
+    std::printf("readers %3d  writer %-10s  writes/s %11.0f  reads/s %12.0f  retry %5.2f%%  torn %lld\n",
+                readers, writerPauseNs ? "1 ms gap" : "flat out", double(writes) / secs,
+                double(reads) / secs, 100.0 * double(retries) / double(reads + retries + 1),
+                static_cast<long long>(torn));
+
+    std::string key = "readers " + std::to_string(readers) + (writerPauseNs ? " gap" : " flat");
+    BenchMetric((key + " reads/s").c_str(), double(reads) / secs, "ops/s");
+    BenchMetric((key + " torn").c_str(), double(torn), "count");
+}
+
+int main()
+{
+    std::string name = "wrclock-bench-" + std::to_string(getpid());
+    for (int readers : { 1, 2, 4, 8, 16 })
+    {
+        Run(name.c_str(), readers, 0, 300000000);
+        Run(name.c_str(), readers, 1000000, 300000000);
+    }
+    shm_unlink(("/" + name).c_str());
+    return 0;
+}
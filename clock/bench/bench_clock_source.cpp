@@ -0,0 +1,59 @@
+// Источники времени: стоимость одного чтения; прогон недель игрового времени
+// на виртуальных часах
+#include <cstdio>
+#include <memory>
+#include <vector>
+#include "bench.h"
+#include "clock_source.h"
+#include "clock_view.h"
+#include "game_calendar.h"
+
+int main()
+{
+    RunBench("WallTicksNow", 5000000, [](int64_t) { DoNotOptimize(WallTicksNow()); });
+    RunBench("MonotonicTicksNow", 5000000, [](int64_t) { DoNotOptimize(MonotonicTicksNow()); });
+    RunBench("CoarseMonotonicTicksNow", 5000000, [](int64_t) { DoNotOptimize(CoarseMonotonicTicksNow()); });
+
+    for (const char* spec : { "wall", "monotonic", "coarse", "anchored", "virtual:60", "virtual:0" })
+    {
+        std::unique_ptr<ClockSource> src = CreateClockSource(spec);
+        char name[64];
+        std::snprintf(name, sizeof(name), "ClockSource::Now (%s)", spec);
+        ClockSource* p = src.get();   // вызов через базовый класс, как в приложении
+        RunBench(name, 5000000, [&](int64_t) { DoNotOptimize(p->Now()); });
+    }
+
+    // Четыре недели игровых суток: часы, планировщик, модель отображения и
+    // календарь работают на виртуальном времени, которое двигается скачками
+    const int DAYS = 28;
+    VirtualClockSource virt(133000000000000000LL);
+    GameClock clock;
+    clock.SetGameTime(virt.Now(), 0);
+    TickScheduler sched(virt.Now());
+    ClockViewModel model;
+    RecordingViewSink rec;
+    model.Attach(&rec);
+    GameCalendar cal;
+    cal.Add(CalendarRule::Daily(6 * 60, 1));
+    cal.Add(CalendarRule::Every(180, 0, 2));
+    cal.Add(CalendarRule::EveryNthDay(7, 0, 22 * 60, 3));
+
+    int64_t end = clock.DeadlineOf(int64_t(DAYS) * MINUTES_IN_DAY);
+    size_t events = 0;
+    int64_t t0 = BenchNowNs();
+    while (virt.Now() < end)
+    {
+        int64_t now = virt.Now();
+        model.Update(clock, now);
+        sched.OnDisplayed(clock, now);
+        // События, наступающие до следующего пробуждения включительно
+        std::vector<CalendarOccurrence> due;
+        events += cal.Range(clock, now + 1, sched.NextWakeup() + 1, &due);
+        virt.Set(sched.NextWakeup());
+    }
+    std::printf("%d game days (%.1f real hours) simulated in %.2f ms: %zu screen updates, "
+                "%zu calendar events\n",
+                DAYS, double(end - clock.DeadlineOf(0)) / TICKS_PER_SECOND / 3600,
+                double(BenchNowNs() - t0) / 1e6, rec.entries.size(), events);
+    return 0;
+}
@@ -0,0 +1,76 @@
+// Пакетный расчёт ClockTable: скалярный путь против AVX2 и масштабирование по потокам
+#include <cstdio>
+#include <random>
+#include <thread>
+#include <vector>
+#include "bench.h"
+#include "clock_table.h"
+
+static double ClocksPerSecond(ClockTable& table, int64_t now, SimdPath path, int threads, int rounds)
+{
+    size_t n = table.Size();
+    size_t chunk = (n + threads - 1) / threads;
+    int64_t t0 = BenchNowNs();
+    for (int round = 0; round < rounds; ++round)
+    {
+        std::vector<std::thread> pool;
+        for (int t = 1; t < threads; ++t)
+            pool.emplace_back([&, t] { table.Evaluate(now + round, t * chunk, chunk, path); });
+        table.Evaluate(now + round, 0, chunk, path);
+        for (auto& th : pool) th.join();
+    }
+    int64_t t1 = BenchNowNs();
+    return double(n) * rounds * 1e9 / double(t1 - t0);
+}
+
+int main()
+{
+    const size_t N = 1 << 20;
+    const int64_t now = WallTicksNow();
+    std::mt19937_64 rng(7);
+
+    ClockTable table(now);
+    table.Reserve(N);
+    for (size_t i = 0; i < N; ++i)
+    {
+        GameClockState s;
+        s.start          = now - static_cast<int64_t>(rng() % (365ULL * 86400 * TICKS_PER_SECOND));
+        s.offset         = static_cast<int64_t>(rng() % (1ULL << 40));
+        s.ticksPerMinute = 50000000 + static_cast<int64_t>(rng() % 100000000);
+        s.minutesPerDay  = (i & 1) ? MINUTES_IN_DAY : 600 + static_cast<int32_t>(rng() % 1400);
+        table.Add(s);
+    }
+
+    // Оба пути обязаны давать одинаковый результат
+    std::vector<int32_t> a(N), b(N), c(N);
+    table.Evaluate(now, SimdPath::Scalar);
+    for (size_t i = 0; i < N; ++i)
+    {
+        a[i] = table.MinuteOfDay()[i];
+        b[i] = table.MinutesToMidnight()[i];
+        c[i] = table.RealSecondsToMidnight()[i];
+    }
+    table.Evaluate(now, SimdPath::Avx2);
+    size_t mismatches = 0;
+    for (size_t i = 0; i < N; ++i)
+        mismatches += a[i] != table.MinuteOfDay()[i] || b[i] != table.MinutesToMidnight()[i] ||
+                      c[i] != table.RealSecondsToMidnight()[i];
+    std::printf("clocks: %zu, AVX2 available: %s, scalar/AVX2 mismatches: %zu\n",
+                N, CpuHasAvx2() ? "yes" : "no", mismatches);
+
+    auto report = [](const char* name, double rate) {
+        std::printf("%-40s %14.0f clocks/s\n", name, rate);
+        BenchMetric(name, rate, "clocks/s");
+    };
+    report("scalar, 1 thread", ClocksPerSecond(table, now, SimdPath::Scalar, 1, 20));
+    report("AVX2, 1 thread", ClocksPerSecond(table, now, SimdPath::Avx2, 1, 20));
+
+    unsigned hw = std::thread::hardware_concurrency();
+    for (unsigned threads = 2; threads <= (hw > 1 ? hw : 1); threads *= 2)
+    {
+        char name[64];
+        std::snprintf(name, sizeof(name), "AVX2, %u threads", threads);
+        report(name, ClocksPerSecond(table, now, SimdPath::Avx2, static_cast<int>(threads), 20));
+    }
+    return 0;
+}
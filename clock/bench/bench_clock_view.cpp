@@ -0,0 +1,63 @@
+// Модель отображения: сколько обновлений полей доходит до окна за игровые сутки
+#include <cstdio>
+#include "bench.h"
+#include "clock_view.h"
+#include "time_format.h"
+
+// Форматирует изменившиеся поля так же, как окно, но без SetWindowText
+class FormatSink : public ClockViewSink {
+public:
+    void Present(const ClockView& v, unsigned changed) override
+    {
+        if (changed & FIELD_TIME) { AppendHHMM(buf, v.minuteOfDay); ++writes; }
+        if (changed & FIELD_COUNTDOWN) { AppendHHMM(buf, v.minutesToMidnight); ++writes; }
+        if (changed & FIELD_REAL_COUNTDOWN) { AppendMMSS(buf, v.realSeconds); ++writes; }
+        DoNotOptimize(buf);
+    }
+    wchar_t buf[64];
+    long    writes = 0;
+};
+
+int main()
+{
+    const int64_t start = 133000000000000000LL;
+    GameClock clock;
+    clock.SetGameTime(start, 0);
+    const int64_t day = clock.State().ticksPerMinute * clock.State().minutesPerDay;
+
+    // Пробуждения планировщика в течение суток: так их видит UpdateClock
+    for (unsigned fields : { unsigned(FIELD_ALL), unsigned(FIELD_TIME | FIELD_COUNTDOWN) })
+    {
+        TickScheduler sched(start, fields);
+        ClockViewModel model;
+        RecordingViewSink rec;
+        model.Attach(&rec);
+        long wakes = 0;
+        for (int64_t now = start; now < start + day; now = sched.NextWakeup())
+        {
+            model.Update(clock, now);
+            sched.OnDisplayed(clock, now);
+            ++wakes;
+        }
+        std::printf("fields=%u: %ld wakeups/day, SetWindowText before %ld, after %zu "
+                    "(time %zu, countdown %zu, real %zu)\n",
+                    fields, wakes, wakes * 3,
+                    rec.CountOf(FIELD_TIME) + rec.CountOf(FIELD_COUNTDOWN) + rec.CountOf(FIELD_REAL_COUNTDOWN),
+                    rec.CountOf(FIELD_TIME), rec.CountOf(FIELD_COUNTDOWN),
+                    rec.CountOf(FIELD_REAL_COUNTDOWN));
+    }
+
+    // Стоимость одного обновления при опросе раз в 100 мс
+    FormatSink sink;
+    ClockViewModel model;
+    model.Attach(&sink);
+    RunBench("ClockViewModel::Update (100 ms poll)", 1000000, [&](int64_t i) {
+        model.Update(clock, start + i * (TICKS_PER_SECOND / 10));
+    });
+    FormatSink naive;
+    RunBench("format all fields every call", 1000000, [&](int64_t i) {
+        naive.Present(ComputeClockView(clock, start + i * (TICKS_PER_SECOND / 10)), FIELD_ALL);
+    });
+    std::printf("field writes per 1M updates: model %ld, naive %ld\n", sink.writes, naive.writes);
+    return 0;
+}
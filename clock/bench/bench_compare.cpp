@@ -0,0 +1,118 @@
+// -----------------------------------------------------------------------------
+// bench_compare — сравнение двух прогонов бенчмарков (файлы или каталоги
+// с JSON от WRCLOCK_BENCH_JSON).
+//
+//   bench_compare [--threshold PCT] BASELINE CURRENT
+//
+// Сравниваются замеры в ns/op (меньше — лучше); код возврата 1, если хоть
+// один стал медленнее больше чем на порог (по умолчанию 10%).
+// -----------------------------------------------------------------------------
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <string>
+#include <dirent.h>
+#include <sys/stat.h>
+
+struct Entry {
+    std::string unit;
+    double      value;
+};
+
+// Извлекает строковое поле "key": "..." из строки-объекта
+static bool Field(const std::string& line, const char* key, std::string* out)
+{
+    std::string k = std::string("\"") + key + "\": ";
+    size_t p = line.find(k);
+    if (p == std::string::npos) return false;
+    p += k.size();
+    if (line[p] == '"')
+    {
+        out->clear();
+        for (++p; p < line.size() && line[p] != '"'; ++p)
+        {
+            if (line[p] == '\\' && p + 1 < line.size()) ++p;
+            out->push_back(line[p]);
+        }
+        return true;
+    }
+    size_t e = line.find_first_of(",}", p);
+    *out = line.substr(p, e - p);
+    return true;
+}
+
+// Файл: одна строка — один результат; одинаковые имена нумеруются по порядку
+static void LoadFile(const std::string& path, std::map<std::string, Entry>* out)
+{
+    std::ifstream in(path);
+    std::string line, suite, name, unit, value;
+    std::map<std::string, int> seen;
+    while (std::getline(in, line))
+    {
+        if (Field(line, "suite", &suite)) continue;
+        if (!Field(line, "name", &name) || !Field(line, "unit", &unit) || !Field(line, "value", &value))
+            continue;
+        std::string key = suite + ": " + name;
+        int n = ++seen[key];
+        if (n > 1) key += " #" + std::to_string(n);
+        (*out)[key] = Entry{ unit, std::atof(value.c_str()) };
+    }
+}
+
+static void Load(const std::string& path, std::map<std::string, Entry>* out)
+{
+    struct stat st;
+    if (stat(path.c_str(), &st) != 0) return;
+    if (!S_ISDIR(st.st_mode)) { LoadFile(path, out); return; }
+    DIR* d = opendir(path.c_str());
+    while (dirent* e = d ? readdir(d) : nullptr)
+    {
+        size_t len = std::strlen(e->d_name);
+        if (len > 5 && !std::strcmp(e->d_name + len - 5, ".json"))
+            LoadFile(path + "/" + e->d_name, out);
+    }
+    if (d) closedir(d);
+}
+
+int main(int argc, char** argv)
+{
+    double threshold = 10.0;
+    const char* paths[2] = {};
+    int np = 0;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (!std::strcmp(argv[i], "--threshold") && i + 1 < argc) threshold = std::atof(argv[++i]);
+        else if (np < 2) paths[np++] = argv[i];
+    }
+    if (np != 2)
+    {
+        std::fprintf(stderr, "usage: bench_compare [--threshold PCT] BASELINE CURRENT\n");
+        return 2;
+    }
+
+    std::map<std::string, Entry> base, cur;
+    Load(paths[0], &base);
+    Load(paths[1], &cur);
+    if (base.empty() || cur.empty())
+    {
+        std::fprintf(stderr, "bench_compare: no results in %s\n", base.empty() ? paths[0] : paths[1]);
+        return 2;
+    }
+
+    int regressions = 0;
+    for (const auto& c : cur)
+    {
+        auto b = base.find(c.first);
+        if (b == base.end() || b->second.unit != c.second.unit || b->second.value <= 0) continue;
+        double change = (c.second.value / b->second.value - 1.0) * 100.0;
+        bool timed = c.second.unit == "ns/op";
+        bool bad = timed && change > threshold;
+        regressions += bad;
+        std::printf("%-60s %12.2f -> %12.2f %-9s %+7.1f%%%s\n", c.first.c_str(), b->second.value,
+                    c.second.value, c.second.unit.c_str(), change, bad ? "  REGRESSION" : "");
+    }
+    std::printf("%d regression(s) over %.1f%%\n", regressions, threshold);
+    return regressions ? 1 : 0;
+}
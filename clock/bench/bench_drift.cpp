@@ -0,0 +1,94 @@
+// Подстройка скорости: сколько раз приходится переставлять часы вручную,
+// цена одного наблюдения и пакетная подгонка миллиона наблюдений
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+#include "bench.h"
+#include "drift_estimator.h"
+
+static const int64_t HOUR_TICKS = 3600 * TICKS_PER_SECOND;
+
+// Игра идёт на rateError быстрее номинала; пользователь сверяет часы с игрой
+// раз в 10 минут и переставляет их, когда они разошлись больше чем на минуту
+// (на одну минуту они расходятся и у точных часов — на границе минуты)
+static int SimulateResyncs(double rateError, int days, bool drift)
+{
+    double trueTpm = double(GAME_MINUTE_TICKS) / (1.0 + rateError);
+    int64_t t0 = WallTicksNow();
+    GameClock clock;
+    clock.SetGameTime(t0, 0);
+    DriftEstimator estimator;
+    std::mt19937_64 rng(3);
+
+    int resyncs = 0;
+    for (int64_t t = t0; t < t0 + days * 24 * HOUR_TICKS; t += 600 * TICKS_PER_SECOND)
+    {
+        // Пользователь замечает расхождение не сразу
+        int64_t seen = t + static_cast<int64_t>(rng() % 600) * TICKS_PER_SECOND;
+        int64_t truth = static_cast<int64_t>(std::floor(double(seen - t0) / trueTpm));
+        int mod = static_cast<int>(FloorMod(truth, MINUTES_IN_DAY));
+        int64_t off = FloorMod(clock.MinuteOfDay(seen) - mod + MINUTES_IN_DAY / 2, MINUTES_IN_DAY) -
+                      MINUTES_IN_DAY / 2;
+        if (off >= -1 && off <= 1) continue;
+        ++resyncs;
+        if (drift) ApplyObservation(&estimator, &clock, seen, mod);
+        else clock.SetGameTime(seen, mod);
+    }
+    return resyncs;
+}
+
+int main()
+{
+    const int days = 60;
+    for (double error : { 1e-4, 5e-4, 2e-3 })
+    {
+        int naive = SimulateResyncs(error, days, false);
+        int fitted = SimulateResyncs(error, days, true);
+        std::printf("rate error %.0e: %5.2f resyncs/day nominal, %5.2f with drift fit\n", error,
+                    double(naive) / days, double(fitted) / days);
+        char name[64];
+        std::snprintf(name, sizeof(name), "resyncs/day at %.0e (fitted)", error);
+        BenchMetric(name, double(fitted) / days, "count");
+    }
+
+    // Миллион наблюдений за год: ввод раз в 30 секунд, 1% выбросов
+    const size_t n = 1000000;
+    const double rateError = 3e-4;
+    double trueTpm = double(GAME_MINUTE_TICKS) / (1.0 + rateError);
+    std::vector<int64_t> at(n);
+    std::vector<double> minute(n);
+    std::mt19937_64 rng(11);
+    int64_t t0 = WallTicksNow() - int64_t(n) * 30 * TICKS_PER_SECOND;
+    for (size_t i = 0; i < n; ++i)
+    {
+        at[i] = t0 + int64_t(i) * 30 * TICKS_PER_SECOND;
+        minute[i] = std::floor(double(at[i] - t0) / trueTpm) + 0.5;
+        if (rng() % 100 == 0) minute[i] += double(rng() % 1000) - 500;
+    }
+    int64_t now = at[n - 1];
+
+    DriftFit scalar, avx2;
+    RunBench("FitDriftBatch 1M, scalar", 10, [&](int64_t) {
+        scalar = FitDriftBatch(at.data(), minute.data(), n, now, DriftOptions(), nullptr, SimdPath::Scalar);
+    });
+    RunBench("FitDriftBatch 1M, avx2", 10, [&](int64_t) {
+        avx2 = FitDriftBatch(at.data(), minute.data(), n, now, DriftOptions(), nullptr, SimdPath::Avx2);
+    });
+    std::printf("ticks/minute: truth %.1f, scalar %lld, avx2 %lld; minute now: scalar %.3f, avx2 %.3f\n",
+                trueTpm, static_cast<long long>(scalar.TicksPerMinute()),
+                static_cast<long long>(avx2.TicksPerMinute()), scalar.Predict(now), avx2.Predict(now));
+
+    // Наблюдения идут строго по порядку, поэтому без прогрева RunBench
+    DriftEstimator online;
+    int64_t t1 = BenchNowNs();
+    for (size_t i = 0; i < n; ++i)
+        online.Observe(at[i], minute[i]);
+    double observeNs = double(BenchNowNs() - t1) / double(n);
+    std::printf("%-40s %12.2f ns/op\n", "DriftEstimator::Observe", observeNs);
+    BenchJson::Get().Timing("DriftEstimator::Observe", static_cast<int64_t>(n), observeNs);
+    std::printf("online: %lld ticks/minute, %zu accepted, %zu outliers\n",
+                static_cast<long long>(online.Fit().TicksPerMinute()), online.Accepted(),
+                online.Outliers());
+    return 0;
+}
@@ -0,0 +1,102 @@
+// Журнал событий: стоимость вызова Log() против синхронной записи строки
+#include <algorithm>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <unistd.h>
+#include "bench.h"
+#include "event_log.h"
+
+static void Percentiles(const char* name, EventLog& log, int64_t n)
+{
+    std::vector<int64_t> lat(static_cast<size_t>(n));
+    for (int64_t i = 0; i < n; ++i)
+    {
+        int64_t t0 = BenchNowNs();
+        log.Log(LOG_GAME_TIME_SET, i % 24, i % 60);
+        lat[static_cast<size_t>(i)] = BenchNowNs() - t0;
+        if ((i & 1023) == 1023) usleep(500);   // даём фоновому потоку разгрести кольцо
+    }
+    std::sort(lat.begin(), lat.end());
+    BenchMetric("EventLog::Log p99", double(lat[n * 99 / 100]), "ns");
+    std::printf("%-40s p50 %lld ns, p99 %lld ns, p99.9 %lld ns\n", name,
+                static_cast<long long>(lat[n / 2]), static_cast<long long>(lat[n * 99 / 100]),
+                static_cast<long long>(lat[n * 999 / 1000]));
+}
+
+int main()
+{
+    std::string base = "/tmp/wrclock-bench-" + std::to_string(getpid());
+    std::string text = base + ".log";
+    std::string bin = base + ".evlog";
+    const int64_t N = 200000;
+
+    {
+        EventLog log;
+        log.Start(text, LogFormat::Text, LogPolicy::Block, 1 << 16);
+        RunBench("EventLog::Log (text, block)", N, [&](int64_t i) {
+            log.Log(LOG_GAME_TIME_SET, i % 24, i % 60);
+        });
+        Percentiles("EventLog::Log latency (text)", log, 100000);
+        log.Stop();
+        std::printf("  written %llu, dropped %llu\n",
+                    static_cast<unsigned long long>(log.Written()),
+                    static_cast<unsigned long long>(log.Dropped()));
+    }
+    {
+        EventLog log;
+        log.Start(bin, LogFormat::Binary, LogPolicy::Block, 1 << 16);
+        RunBench("EventLog::Log (binary, block)", N, [&](int64_t i) {
+            log.Log(LOG_GAME_TIME_SET, i % 24, i % 60);
+        });
+        log.Stop();
+    }
+    {
+        // Маленькое кольцо и поток, не успевающий за производителем
+        EventLog log;
+        log.Start(bin, LogFormat::Binary, LogPolicy::Drop, 256);
+        RunBench("EventLog::Log (drop, 256-entry ring)", N, [&](int64_t i) {
+            log.Log(LOG_GAME_TIME_SET, i % 24, i % 60);
+        });
+        log.Stop();
+        std::printf("  written %llu, dropped %llu\n",
+                    static_cast<unsigned long long>(log.Written()),
+                    static_cast<unsigned long long>(log.Dropped()));
+    }
+
+    // Синхронная запись: форматирование и fflush в вызывающем потоке
+    {
+        FILE* f = std::fopen(text.c_str(), "a");
+        char line[512];
+        LogRecord r{};
+        r.event = LOG_GAME_TIME_SET;
+        RunBench("snprintf + fwrite + fflush", N / 10, [&](int64_t i) {
+            r.ns = LogNowNs();
+            r.args[0] = i % 24;
+            r.args[1] = i % 60;
+            size_t n = FormatLogRecord(r, line, sizeof(line));
+            std::fwrite(line, 1, n, f);
+            std::fflush(f);
+        });
+        std::fclose(f);
+    }
+    // Как было в приложении: открыть, дописать строку, закрыть
+    {
+        char line[512];
+        LogRecord r{};
+        r.event = LOG_GAME_TIME_SET;
+        RunBench("fopen + fwrite + fclose per line", N / 20, [&](int64_t i) {
+            r.ns = LogNowNs();
+            r.args[0] = i % 24;
+            r.args[1] = i % 60;
+            size_t n = FormatLogRecord(r, line, sizeof(line));
+            FILE* f = std::fopen(text.c_str(), "a");
+            std::fwrite(line, 1, n, f);
+            std::fclose(f);
+        });
+    }
+
+    std::remove(text.c_str());
+    std::remove(bin.c_str());
+    return 0;
+}
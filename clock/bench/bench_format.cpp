@@ -0,0 +1,56 @@
+// Сравнение табличного форматирования с прежним FormatTime на wostringstream
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include "bench.h"
+#include "time_format.h"
+
+// Прежняя реализация из game_clock.cpp
+static std::wstring FormatTime(int minutes)
+{
+    int h = (minutes / 60) % 24;
+    int m = minutes % 60;
+    std::wostringstream ss;
+    ss << std::setw(2) << std::setfill(L'0') << h
+       << L":"
+       << std::setw(2) << std::setfill(L'0') << m;
+    return ss.str();
+}
+
+static std::wstring FormatReal(int64_t realSeconds)
+{
+    std::wostringstream ss;
+    ss << L"Реальное время: " << std::setw(2) << std::setfill(L'0') << realSeconds / 60
+       << L":" << std::setw(2) << std::setfill(L'0') << realSeconds % 60;
+    return ss.str();
+}
+
+int main()
+{
+    const int64_t N = 2000000;
+
+    RunBench("FormatTime (wostringstream)", N, [](int64_t i) {
+        std::wstring s = FormatTime(static_cast<int>(i % MINUTES_IN_DAY));
+        DoNotOptimize(s);
+    });
+    RunBench("AppendHHMM<wchar_t>", N, [](int64_t i) {
+        wchar_t buf[8];
+        AppendHHMM(buf, static_cast<int>(i % MINUTES_IN_DAY));
+        DoNotOptimize(buf);
+    });
+    RunBench("AppendHHMM<char>", N, [](int64_t i) {
+        char buf[8];
+        AppendHHMM(buf, static_cast<int>(i % MINUTES_IN_DAY));
+        DoNotOptimize(buf);
+    });
+    RunBench("real countdown (wostringstream)", N, [](int64_t i) {
+        std::wstring s = FormatReal(i % 12600);
+        DoNotOptimize(s);
+    });
+    RunBench("real countdown (AppendMMSS)", N, [](int64_t i) {
+        wchar_t buf[48];
+        AppendMMSS(AppendLiteral(buf, L"Реальное время: "), i % 12600);
+        DoNotOptimize(buf);
+    });
+    return 0;
+}
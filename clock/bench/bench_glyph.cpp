@@ -0,0 +1,44 @@
+// Большие часы из атласа символов: цена построения атласа и кадра за смену
+// минуты, полная перерисовка против перерисовки изменившихся ячеек
+#include <cstdio>
+#include "bench.h"
+#include "glyph_atlas.h"
+#include "time_format.h"
+
+int main()
+{
+    SegmentRasterizer rasterizer(48);
+    GlyphAtlas atlas;
+    RunBench("GlyphAtlas::Build 48 px", 200, [&](int64_t) {
+        atlas.Build(&rasterizer, DARK_THEME.text, DARK_THEME.bg);
+        DoNotOptimize(atlas.Height());
+    });
+
+    char text[MINUTES_IN_DAY][HHMM_LEN + 1];
+    for (int m = 0; m < MINUTES_IN_DAY; ++m)
+        AppendHHMM(text[m], m);
+
+    ClockCompositor full, partial;
+    for (ClockCompositor* c : { &full, &partial })
+    {
+        c->SetAtlas(&atlas);
+        c->Resize(230, 56);
+    }
+    PixelRect damage[MAX_CLOCK_CELLS];
+    size_t fullPixels = 0, partialPixels = 0, rects = 0, fullFrames = 0, partialFrames = 0;
+    RunBench("ClockCompositor full redraw", 100000, [&](int64_t i) {
+        full.Invalidate();
+        full.Compose(text[i % MINUTES_IN_DAY], HHMM_LEN, damage, MAX_CLOCK_CELLS);
+        fullPixels += full.PixelsDrawn();
+        ++fullFrames;
+    });
+    RunBench("ClockCompositor changed cells", 100000, [&](int64_t i) {
+        rects += partial.Compose(text[i % MINUTES_IN_DAY], HHMM_LEN, damage, MAX_CLOCK_CELLS);
+        partialPixels += partial.PixelsDrawn();
+        ++partialFrames;
+    });
+    std::printf("pixels per frame: full %zu, changed cells %zu; %.2f damage rects per frame\n",
+                fullPixels / fullFrames, partialPixels / partialFrames, double(rects) / double(partialFrames));
+    BenchMetric("pixels per minute change", double(partialPixels) / double(partialFrames), "px");
+    return 0;
+}
@@ -0,0 +1,107 @@
+// История поправок: размер на диске, выборки и агрегаты по пяти годам записей
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+#include <unistd.h>
+#include "bench.h"
+#include "correction_history.h"
+
+static const int64_t DAY_TICKS = 86400 * TICKS_PER_SECOND;
+
+int main()
+{
+    // Пять лет по 1..8 поправок в день на несколько секунд — минут
+    std::mt19937_64 rng(7);
+    std::vector<Correction> cs;
+    int64_t at = WallTicksNow() - 5 * 365 * DAY_TICKS;
+    int64_t phase = 0;
+    for (int day = 0; day < 5 * 365; ++day)
+    {
+        int n = 1 + static_cast<int>(rng() % 8);
+        for (int k = 0; k < n; ++k)
+        {
+            Correction c;
+            c.at = at + static_cast<int64_t>(rng() % static_cast<uint64_t>(DAY_TICKS / n));
+            c.oldOffset = phase;
+            c.newOffset = phase + (static_cast<int64_t>(rng() % 1200) - 600) * TICKS_PER_SECOND;
+            c.source = (rng() % 10) ? CORRECTION_DIALOG : CORRECTION_FOLLOW;
+            phase = c.newOffset;
+            cs.push_back(c);
+            at = c.at;
+        }
+        at += DAY_TICKS / 2;
+    }
+
+    std::vector<uint8_t> image(CORRECTION_HEADER_SIZE);
+    std::memcpy(image.data(), &CORRECTION_FILE_MAGIC, 4);
+    std::memcpy(image.data() + 4, &CORRECTION_FILE_VERSION, 4);
+    for (size_t i = 0; i < cs.size(); i += CORRECTION_BLOCK_RECORDS)
+        EncodeCorrectionBlock(&cs[i], std::min(CORRECTION_BLOCK_RECORDS, cs.size() - i), &image);
+    std::printf("%zu corrections: %zu bytes (%.2f bytes/record, raw %zu)\n", cs.size(),
+                image.size(), double(image.size()) / double(cs.size()), cs.size() * 26);
+    BenchMetric("bytes per record", double(image.size()) / double(cs.size()), "bytes");
+
+    CorrectionReader r;
+    RunBench("Attach (headers + CRC of every block)", 2000, [&](int64_t) {
+        r.Attach(image.data(), image.size());
+        DoNotOptimize(r);
+    });
+    if (r.Size() != cs.size()) std::printf("MISMATCH: %zu records read\n", r.Size());
+
+    int64_t last = r.LastAt() + 1;
+    std::vector<Correction> out;
+    RunBench("Range, last 30 days", 20000, [&](int64_t) {
+        r.Range(last - 30 * DAY_TICKS, last, &out);
+        DoNotOptimize(out);
+    });
+    RunBench("Aggregate, last 30 days", 20000, [&](int64_t) {
+        CorrectionStats s = r.Aggregate(last - 30 * DAY_TICKS, last);
+        DoNotOptimize(s);
+    });
+    RunBench("Aggregate, all time (headers)", 200000, [&](int64_t) {
+        CorrectionStats s = r.Aggregate(INT64_MIN, INT64_MAX);
+        DoNotOptimize(s);
+    });
+    std::vector<CorrectionStats> buckets;
+    RunBench("Buckets, daily over a year", 2000, [&](int64_t) {
+        r.Buckets(last - 365 * DAY_TICKS, last, DAY_TICKS, &buckets);
+        DoNotOptimize(buckets);
+    });
+    RunBench("Range, everything (full decode)", 200, [&](int64_t) {
+        r.Range(INT64_MIN, INT64_MAX, &out);
+        DoNotOptimize(out);
+    });
+
+    // Сверка: распаковка совпадает с исходными записями, агрегаты — с наивными
+    size_t bad = out.size() != cs.size();
+    for (size_t i = 0; !bad && i < cs.size(); ++i)
+        bad += out[i].at != cs[i].at || out[i].oldOffset != cs[i].oldOffset ||
+               out[i].newOffset != cs[i].newOffset || out[i].source != cs[i].source;
+    CorrectionStats naive;
+    for (const Correction& c : cs)
+        if (c.at >= last - 30 * DAY_TICKS) naive.Add(c.Shift());
+    CorrectionStats month = r.Aggregate(last - 30 * DAY_TICKS, last);
+    bad += naive.count != month.count || naive.sum != month.sum || naive.max != month.max;
+    std::printf("check: %zu mismatches, drift over the last month %+.2f s/day\n", bad,
+                DriftPerDay(month, last - 30 * DAY_TICKS, last) / TICKS_PER_SECOND);
+
+    // Дозапись: последний блок переписывается целиком
+    std::string path = "/tmp/wrclock-bench-" + std::to_string(getpid()) + ".history";
+    CorrectionHistory h;
+    h.Open(path);
+    RunBench("CorrectionHistory::Append (no sync)", 2048, [&](int64_t i) {
+        h.Append(cs[static_cast<size_t>(i)], false);
+    });
+    RunBench("CorrectionHistory::Append (fdatasync)", 64, [&](int64_t i) {
+        h.Append(cs[static_cast<size_t>(2048 + i)], true);
+    });
+    h.Close();
+    h.Open(path);
+    std::printf("reopened: %zu records\n", h.Records());
+    h.Close();
+    RemoveFile(path);
+    return 0;
+}
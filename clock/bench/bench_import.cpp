@@ -0,0 +1,104 @@
+// Импорт расписаний: пропускная способность на одном и на всех ядрах и цена
+// разбора одного поля времени против swscanf, как было в диалоге
+#include <cstdio>
+#include <cwchar>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include "bench.h"
+#include "schedule_import.h"
+#include "time_parse.h"
+
+class NullScheduleSink : public ScheduleSink {
+public:
+    bool Write(const char* data, size_t size) override
+    {
+        DoNotOptimize(data);
+        bytes += size;
+        return true;
+    }
+    size_t bytes = 0;
+};
+
+static std::string MakeSchedule(size_t rows)
+{
+    std::mt19937 rng(5);
+    auto r = [&](unsigned n) { return static_cast<unsigned>(rng() % n); };
+    std::string s = "day,time,event,note\n";
+    char line[96];
+    for (size_t i = 0; i < rows; ++i)
+    {
+        int n = std::snprintf(line, sizeof(line), "%u,%02u:%02u,event %u,shift %c\n",
+                              r(7), r(24), r(60), r(1000), 'A' + r(3));
+        s.append(line, static_cast<size_t>(n));
+    }
+    return s;
+}
+
+int main()
+{
+    const size_t rows = 2000000;
+    std::string csv = MakeSchedule(rows);
+    double mb = double(csv.size()) / (1 << 20);
+    GameClock clock;
+    int64_t now = WallTicksNow();
+    clock.SetGameTime(now, 12 * 60);
+
+    unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+    for (unsigned threads : { 1u, cores })
+    {
+        for (bool write : { false, true })
+        {
+            NullScheduleSink sink;
+            ScheduleReport report;
+            int64_t t0 = BenchNowNs();
+            ImportSchedule(csv.data(), csv.size(), clock, now, ScheduleLayout(), threads,
+                           write ? &sink : nullptr, &report);
+            double sec = double(BenchNowNs() - t0) / 1e9;
+            char name[64];
+            std::snprintf(name, sizeof(name), "ImportSchedule %s, %u thread%s",
+                          write ? "convert" : "validate", threads, threads == 1 ? "" : "s");
+            std::printf("%-40s %8.1f MB/s  %zu rows, %zu skipped\n", name, mb / sec, report.rows,
+                        report.skipped);
+            BenchMetric(name, mb / sec, "MB/s");
+        }
+        if (cores == 1) break;
+    }
+
+    // Поле времени по отдельности
+    std::vector<std::string> fields;
+    std::vector<std::wstring> wfields;
+    std::mt19937 rng(9);
+    auto r = [&](unsigned n) { return static_cast<unsigned>(rng() % n); };
+    for (int i = 0; i < 4096; ++i)
+    {
+        char buf[8];
+        std::snprintf(buf, sizeof(buf), "%02u:%02u", r(24), r(60));
+        fields.push_back(buf);
+        wfields.push_back(std::wstring(buf, buf + 5));
+    }
+    const int64_t ops = 2000000;
+    RunBench("swscanf %d%*[^0-9]%d", ops, [&](int64_t i) {
+        int h, m;
+        std::swscanf(wfields[i & 4095].c_str(), L"%d%*[^0-9]%d", &h, &m);
+        DoNotOptimize(h * 60 + m);
+    });
+    RunBench("ParseClockText<wchar_t>", ops, [&](int64_t i) {
+        const std::wstring& w = wfields[i & 4095];
+        int m = 0;
+        DoNotOptimize(ParseClockText(w.data(), w.data() + w.size(), &m));
+        DoNotOptimize(m);
+    });
+    RunBench("ParseTimeField", ops, [&](int64_t i) {
+        int m = 0;
+        DoNotOptimize(ParseTimeField(fields[i & 4095].data(), 5, &m));
+        DoNotOptimize(m);
+    });
+    RunBench("ParseHHMM5", ops, [&](int64_t i) {
+        int m = 0;
+        DoNotOptimize(ParseHHMM5(fields[i & 4095].data(), &m));
+        DoNotOptimize(m);
+    });
+    return 0;
+}
@@ -0,0 +1,78 @@
+// Журнал состояния: загрузка при старте, дозапись, сжатие; для сравнения — разбор INI
+#include <cstdio>
+#include <string>
+#include <unistd.h>
+#include "bench.h"
+#include "game_ini.h"
+#include "state_journal.h"
+
+int main()
+{
+    std::string dir = "/tmp/wrclock-bench-" + std::to_string(getpid());
+    std::string path = dir + ".journal";
+    std::string ini = dir + ".ini";
+
+    GameClockState s;
+    s.start = WallTicksNow();
+    s.offset = 720 * GAME_MINUTE_TICKS;
+
+    StateJournal j;
+    j.Open(path);
+    JournalEntry e;
+    e.state = s;
+    RunBench("StateJournal::Append (no sync)", 1024, [&](int64_t i) {
+        e.kind = (i % 50) ? JOURNAL_CHECKPOINT : JOURNAL_SET;
+        e.at = s.start + i;
+        j.Append(e);
+    });
+    RunBench("StateJournal::Append (fdatasync)", 64, [&](int64_t i) {
+        e.kind = JOURNAL_SET;
+        e.at = s.start + i;
+        j.Append(e, true);
+    });
+    std::printf("journal: %zu records\n", j.Records());
+
+    JournalLoad load;
+    RunBench("LoadJournal (mmap + scan)", 2000, [&](int64_t) {
+        LoadJournal(path, &load);
+        DoNotOptimize(load);
+    });
+
+    int64_t t0 = BenchNowNs();
+    j.Compact(e);
+    double compactUs = double(BenchNowNs() - t0) / 1000.0;
+    std::printf("%-40s %12.2f us (%zu records kept)\n", "StateJournal::Compact", compactUs, j.Records());
+    BenchMetric("StateJournal::Compact", compactUs, "us");
+    RunBench("LoadJournal after compaction", 2000, [&](int64_t) {
+        LoadJournal(path, &load);
+        DoNotOptimize(load);
+    });
+    j.Close();
+
+    // Оборванная запись в конце (kill -9 посреди write) не мешает загрузке
+    {
+        OutputFile f;
+        f.Open(path, false);
+        f.Write("\x12\x34\x56", 3);
+    }
+    LoadJournal(path, &load);
+    std::printf("torn tail: found=%d records=%zu valid=%llu of %llu bytes\n", load.found,
+                load.records, static_cast<unsigned long long>(load.validBytes),
+                static_cast<unsigned long long>(load.fileBytes));
+
+    {
+        FILE* f = std::fopen(ini.c_str(), "wb");
+        std::fprintf(f, "[Game]\r\nGameTime=123456\r\nCloseTime=%lld\r\n",
+                     static_cast<long long>(s.start));
+        std::fclose(f);
+    }
+    SavedGameTime saved;
+    RunBench("ReadGameIni (fopen + parse)", 2000, [&](int64_t) {
+        ReadGameIni(ini.c_str(), &saved);
+        DoNotOptimize(saved);
+    });
+
+    RemoveFile(path);
+    RemoveFile(ini);
+    return 0;
+}
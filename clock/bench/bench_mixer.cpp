@@ -0,0 +1,92 @@
+// Микшер будильника: цена смешивания блока при 1/4/16 голосах и задержка
+// от Trigger до первого сэмпла на выходе при устройстве с периодом 256
+// кадров. Необязательный аргумент — WAV, куда записать вывод прогона задержки.
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <thread>
+#include <vector>
+#include "alarm_mixer.h"
+#include "bench.h"
+
+// Короткий сигнал будильника, 0.4 с
+static PcmBuffer MakeBeep(uint16_t channels, double freq)
+{
+    const double PI = 3.14159265358979323846;
+    PcmBuffer pcm;
+    pcm.channels = channels;
+    pcm.sampleRate = 44100;
+    const size_t frames = 17640;
+    pcm.samples.resize(frames * channels);
+    for (size_t i = 0; i < frames; ++i)
+    {
+        double t = double(i) / pcm.sampleRate;
+        int16_t v = static_cast<int16_t>(std::exp(-4.0 * t) * std::sin(2 * PI * freq * t) * 6000);
+        for (uint16_t c = 0; c < channels; ++c) pcm.samples[i * channels + c] = v;
+    }
+    return pcm;
+}
+
+int main(int argc, char** argv)
+{
+    PcmBuffer stereo = MakeBeep(2, 880.0), mono = MakeBeep(1, 660.0);
+
+    // Нагрузка: блок 256 кадров при N звучащих голосах (Pump + Render вручную)
+    for (size_t voices : { size_t(1), size_t(4), size_t(16) })
+    {
+        MixerConfig config;
+        config.prebufferFrames = config.blockFrames;
+        AlarmMixer mixer(config);
+        int clips[2] = { mixer.AddClip(&stereo), mixer.AddClip(&mono) };
+        std::vector<int16_t> out(config.blockFrames * config.format.channels);
+        char name[64];
+        std::snprintf(name, sizeof(name), "mix block 256 frames, %zu voices", voices);
+        RunBench(name, 20000, [&](int64_t) {
+            while (mixer.ActiveVoices() < voices)
+            {
+                mixer.Trigger(clips[mixer.ActiveVoices() & 1], 0.5f);
+                mixer.Pump();
+            }
+            mixer.Pump();
+            mixer.Render(out.data(), config.blockFrames);
+            DoNotOptimize(out.data());
+        });
+    }
+
+    // Задержка: устройство отсчитывает период в реальном времени, микшер в
+    // своём потоке, Trigger — из этого потока каждые 50 мс
+    NullAudioSink nullSink;
+    WavAudioSink wavSink(argc > 1 ? argv[1] : "");
+    ClockedAudioDevice device(argc > 1 ? static_cast<AudioSink*>(&wavSink) : &nullSink);
+    MixerConfig config;
+    AlarmMixer mixer(config);
+    int clip = mixer.AddClip(&stereo);
+    mixer.Start();
+    if (!device.Start(&mixer, config.format, 256))
+    {
+        std::fprintf(stderr, "cannot start audio device\n");
+        return 1;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    for (int i = 0; i < 40; ++i)
+    {
+        mixer.Trigger(clip, 0.5f);
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    }
+    device.Stop();
+    mixer.Stop();
+
+    MixerStats s = mixer.Stats();
+    double avgUs = s.latencies ? double(s.latencySumNs) / s.latencies / 1e3 : 0;
+    double maxUs = double(s.latencyMaxNs) / 1e3;
+    double bufferUs = double(config.prebufferFrames + 256) * 1e6 / config.format.sampleRate;
+    std::printf("trigger -> first sample: %llu of %llu measured, avg %.0f us, max %.0f us "
+                "(prebuffer + period %.0f us)\n",
+                (unsigned long long)s.latencies, (unsigned long long)s.triggers, avgUs, maxUs, bufferUs);
+    std::printf("underruns %llu in %llu frames, mix %.2f us per block\n", (unsigned long long)s.underruns,
+                (unsigned long long)device.Frames(), s.blocks ? double(s.mixNs) / s.blocks / 1e3 : 0);
+    BenchMetric("trigger latency avg", avgUs, "us");
+    BenchMetric("trigger latency max", maxUs, "us");
+    BenchMetric("underruns", double(s.underruns), "count");
+    return 0;
+}
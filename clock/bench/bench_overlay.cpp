@@ -0,0 +1,76 @@
+// Кадры для оверлея: байт в секунду и время на кадр при 30 кадрах/с —
+// прямоугольники изменений против полного кадра
+#include <cstdio>
+#include "bench.h"
+#include "frame_stream.h"
+
+struct StreamStats {
+    double   ns = 0;
+    uint64_t bytes = 0;
+    uint64_t sent = 0;
+};
+
+// Час игрового времени по часам номинальной скорости; кадры по расписанию fps
+static StreamStats Stream(bool full, double fps, int seconds)
+{
+    SegmentRasterizer big(48), small(24);
+    OverlayRenderer renderer;
+    renderer.Setup(&big, &small, DARK_THEME, 192);
+    GameClock clock;
+    int64_t t0 = WallTicksNow();
+    clock.SetGameTime(t0, 12 * 60);
+
+    StreamStats s;
+    std::vector<uint8_t> msg;
+    PixelRect damage[16];
+    int64_t period = static_cast<int64_t>(TICKS_PER_SECOND / fps);
+    int64_t frames = static_cast<int64_t>(fps * seconds);
+    int64_t nextKey = t0;
+    int64_t start = BenchNowNs();
+    for (int64_t i = 0; i < frames; ++i)
+    {
+        int64_t now = t0 + i * period;
+        size_t n = renderer.Render(ComputeClockView(clock, now), damage, 16);
+        bool key = full || now >= nextKey;
+        if (key) nextKey = now + 10 * TICKS_PER_SECOND;
+        if (!key && !n) continue;
+        EncodeFrame(renderer.Frame(), damage, n, uint64_t(i), now, key, &msg);
+        DoNotOptimize(msg.data());
+        s.bytes += msg.size();
+        ++s.sent;
+    }
+    s.ns = double(BenchNowNs() - start) / double(frames);
+    s.bytes /= static_cast<uint64_t>(seconds);
+    return s;
+}
+
+int main()
+{
+    const double fps = 30;
+    const int seconds = 3600;
+    StreamStats damage = Stream(false, fps, seconds);
+    StreamStats full = Stream(true, fps, seconds);
+    std::printf("%-28s %10.1f KB/s %8.1f ns/frame %6.2f messages/s\n", "damage rects, key every 10 s",
+                double(damage.bytes) / 1024, damage.ns, double(damage.sent) / seconds);
+    std::printf("%-28s %10.1f KB/s %8.1f ns/frame %6.2f messages/s\n", "full frames", double(full.bytes) / 1024,
+                full.ns, double(full.sent) / seconds);
+    BenchMetric("overlay bytes/s (damage)", double(damage.bytes), "B/s");
+    BenchMetric("overlay bytes/s (full)", double(full.bytes), "B/s");
+    BenchJson::Get().Timing("overlay frame (damage)", int64_t(fps * seconds), damage.ns);
+    BenchJson::Get().Timing("overlay frame (full)", int64_t(fps * seconds), full.ns);
+
+    // Кольцо в памяти процесса: запись одного ключевого кадра
+    FrameRing ring;
+    if (ring.Open("wrclock-bench-overlay", 1 << 20))
+    {
+        SegmentRasterizer big(48), small(24);
+        OverlayRenderer renderer;
+        renderer.Setup(&big, &small, DARK_THEME, 192);
+        PixelRect d[16];
+        renderer.Render(ClockView(), d, 16);
+        std::vector<uint8_t> msg;
+        EncodeFrame(renderer.Frame(), d, 0, 0, 0, true, &msg);
+        RunBench("FrameRing::Send key frame", 100000, [&](int64_t) { ring.Send(msg.data(), msg.size()); });
+    }
+    return 0;
+}
@@ -0,0 +1,59 @@
+// Профили скорости: деление на константы профиля против деления на переменную
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "bench.h"
+#include "rate_profile.h"
+
+int main()
+{
+    const size_t N = 1 << 16;
+    const int64_t t0 = 133000000000000000LL;
+    std::vector<int64_t> now(N);
+    for (size_t i = 0; i < N; ++i) now[i] = t0 + int64_t(i) * 3333331;
+    std::vector<ClockReading> out(N);
+
+    size_t count;
+    const RateProfileInfo* profiles = RateProfiles(&count);
+    for (size_t p = 0; p < count; ++p)
+    {
+        GameClock clock;
+        clock.SetState(GameClockState());
+        ApplyRateProfile(&clock, profiles[p], t0);
+        GameClockState s = clock.State();
+        std::printf("profile %s (%s)\n", profiles[p].name, profiles[p].description);
+
+        BenchResult g = RunBench("  generic, 64k batch", 200, [&](int64_t) {
+            ReadClockGeneric(s, now.data(), N, out.data());
+            DoNotOptimize(out[N - 1]);
+        });
+        ReadClockFn fn = SelectReadClock(s);
+        BenchResult f = RunBench("  specialized, 64k batch", 200, [&](int64_t) {
+            fn(s, now.data(), N, out.data());
+            DoNotOptimize(out[N - 1]);
+        });
+        std::printf("  per reading: generic %.2f ns, specialized %.2f ns\n",
+                    g.nsPerOp / N, f.nsPerOp / N);
+        std::string label = std::string("per reading, ") + profiles[p].name;
+        BenchMetric((label + ", generic").c_str(), g.nsPerOp / N, "ns");
+        BenchMetric((label + ", specialized").c_str(), f.nsPerOp / N, "ns");
+    }
+
+    // Одиночные вызовы: то, что делает UpdateClock
+    GameClock generic;
+    generic.SetGameTime(t0, 600);
+    FixedRateClock<DefaultRate> fixed(generic.State());
+    RunBench("GameClock::MinuteOfDay", 10000000, [&](int64_t i) {
+        DoNotOptimize(generic.MinuteOfDay(t0 + i * 3333331));
+    });
+    RunBench("FixedRateClock<Default>::MinuteOfDay", 10000000, [&](int64_t i) {
+        DoNotOptimize(fixed.MinuteOfDay(t0 + i * 3333331));
+    });
+    RunBench("GameClock::TicksToMidnight", 10000000, [&](int64_t i) {
+        DoNotOptimize(generic.TicksToMidnight(t0 + i * 3333331));
+    });
+    RunBench("FixedRateClock<Default>::TicksToMidnight", 10000000, [&](int64_t i) {
+        DoNotOptimize(fixed.TicksToMidnight(t0 + i * 3333331));
+    });
+    return 0;
+}
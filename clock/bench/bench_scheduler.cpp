@@ -0,0 +1,80 @@
+// Колесо таймеров и число пробуждений планировщика за час реального времени
+#include <cstdio>
+#include <random>
+#include <vector>
+#include "bench.h"
+#include "tick_scheduler.h"
+
+static int64_t g_fired = 0;
+static void CountFire(WheelTimer*, int64_t) { ++g_fired; }
+
+static int64_t SimulateWakeups(unsigned fields, bool visible)
+{
+    const int64_t begin = 130000000000000000LL;
+    const int64_t end = begin + 3600 * TICKS_PER_SECOND;
+    GameClock clock;
+    clock.SetGameTime(begin, 600);
+    TickScheduler sched(begin, fields);
+    sched.SetVisible(visible);
+
+    int64_t wakeups = 0;
+    int64_t now = begin;
+    if (sched.DisplayDue(now)) sched.OnDisplayed(clock, now);
+    for (;;)
+    {
+        int64_t next = sched.NextWakeup();
+        if (next >= end) break;
+        now = next;
+        ++wakeups;
+        sched.RunAlarms(now);
+        if (sched.DisplayDue(now)) sched.OnDisplayed(clock, now);
+    }
+    return wakeups;
+}
+
+int main()
+{
+    const int N = 1000000;
+    const int64_t base = 130000000000000000LL;
+    std::mt19937_64 rng(42);
+    std::vector<WheelTimer> timers(N);
+    std::vector<int64_t> deadlines(N);
+    for (int i = 0; i < N; ++i)
+    {
+        timers[i].fire = CountFire;
+        deadlines[i] = base + static_cast<int64_t>(rng() % (4ULL * 3600 * TICKS_PER_SECOND));
+    }
+
+    TimerWheel wheel(TICKS_PER_SECOND / 1000, base);
+    RunBench("TimerWheel::Arm (1M, 4h spread)", N, [&](int64_t i) {
+        wheel.Arm(&timers[i], deadlines[i]);
+    });
+    int64_t t0 = BenchNowNs();
+    for (int64_t now = base; wheel.Count(); now += TICKS_PER_SECOND)
+        wheel.Advance(now);
+    int64_t t1 = BenchNowNs();
+    std::printf("%-40s %12.2f ns/op (%lld fired)\n", "TimerWheel::Advance per fire",
+                double(t1 - t0) / double(g_fired), static_cast<long long>(g_fired));
+    BenchJson::Get().Timing("TimerWheel::Advance per fire", g_fired, double(t1 - t0) / double(g_fired));
+
+    TimerWheel wheel2(TICKS_PER_SECOND / 1000, base);
+    RunBench("TimerWheel::Arm + Cancel", N, [&](int64_t i) {
+        wheel2.Arm(&timers[i], deadlines[i]);
+        wheel2.Cancel(&timers[i]);
+    });
+
+    std::printf("\nWakeups per real hour:\n");
+    std::printf("  %-38s %8d\n", "SetTimer(1000 ms) poll", 3600);
+    struct { const char* name; unsigned fields; bool visible; } cases[] = {
+        { "wakeups/h, default (MM:SS)",   FIELD_ALL,                      true  },
+        { "wakeups/h, minutes only",      FIELD_TIME | FIELD_COUNTDOWN,   true  },
+        { "wakeups/h, minimized",         FIELD_ALL,                      false },
+    };
+    for (const auto& c : cases)
+    {
+        long long n = static_cast<long long>(SimulateWakeups(c.fields, c.visible));
+        std::printf("  %-38s %8lld\n", c.name, n);
+        BenchMetric(c.name, double(n), "wakeups/h");
+    }
+    return 0;
+}
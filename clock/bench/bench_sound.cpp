@@ -0,0 +1,92 @@
+// Звук уведомления: декодирование IMA ADPCM и PCM из памяти, память до и
+// после декодирования и цена запуска — ленивый кэш против прежней выгрузки
+// ресурса во временный файл. Необязательный аргумент — свой WAV PCM 16 бит.
+#include <cmath>
+#include <cstdio>
+#include <vector>
+#include "bench.h"
+#include "file_io.h"
+#include "sound_decoder.h"
+
+// Аккорд с затуханием, 3.2 с стерео 44.1 кГц — как gamemus.wav
+static PcmBuffer MakeChime()
+{
+    const double PI = 3.14159265358979323846;
+    PcmBuffer pcm;
+    pcm.channels = 2;
+    pcm.sampleRate = 44100;
+    const size_t frames = 141000;
+    pcm.samples.resize(frames * 2);
+    for (size_t i = 0; i < frames; ++i)
+    {
+        double t = double(i) / pcm.sampleRate;
+        double v = std::exp(-1.5 * t) *
+                   (std::sin(2 * PI * 523.25 * t) + 0.6 * std::sin(2 * PI * 659.25 * t) +
+                    0.4 * std::sin(2 * PI * 783.99 * t));
+        pcm.samples[2 * i] = static_cast<int16_t>(v * 9000);
+        pcm.samples[2 * i + 1] = static_cast<int16_t>(v * 8000);
+    }
+    return pcm;
+}
+
+int main(int argc, char** argv)
+{
+    PcmBuffer source;
+    MappedFile input;
+    if (argc > 1 && (!input.Open(argv[1]) || !DecodeSound(input.Data(), input.Size(), &source)))
+    {
+        std::fprintf(stderr, "cannot decode %s\n", argv[1]);
+        return 1;
+    }
+    if (argc <= 1) source = MakeChime();
+
+    std::vector<uint8_t> pcmWave, adpcmWave;
+    EncodePcmWave(source, &pcmWave);
+    EncodeImaAdpcmWave(source, IMA_ADPCM_CHANNEL_BLOCK, &adpcmWave);
+    double seconds = double(source.Frames()) / source.sampleRate;
+    std::printf("%.2f s of audio: PCM %zu KB, IMA ADPCM %zu KB\n", seconds, pcmWave.size() / 1024,
+                adpcmWave.size() / 1024);
+    BenchMetric("embedded PCM", double(pcmWave.size()) / 1024, "KB");
+    BenchMetric("embedded IMA ADPCM", double(adpcmWave.size()) / 1024, "KB");
+
+    // Декодирование целиком (первое проигрывание)
+    PcmBuffer out;
+    RunBench("DecodeSound ima-adpcm", 64, [&](int64_t) {
+        DecodeSound(adpcmWave.data(), adpcmWave.size(), &out);
+        DoNotOptimize(out.samples.data());
+    });
+    RunBench("DecodeSound pcm16", 64, [&](int64_t) {
+        DecodeSound(pcmWave.data(), pcmWave.size(), &out);
+        DoNotOptimize(out.samples.data());
+    });
+
+    // Память: до первого звука — только отображённый ресурс, после — одна
+    // копия PCM в виде WAV, которую и проигрывает PlaySound
+    SoundCache cache;
+    cache.SetSource(adpcmWave.data(), adpcmWave.size());
+    std::printf("%-40s %12zu KB\n", "resident before first play", size_t(0));
+    const std::vector<uint8_t>* wave = cache.Wave();
+    std::printf("%-40s %12zu KB (decoded in %.2f ms)\n", "resident after first play",
+                wave ? wave->size() / 1024 : 0, double(cache.DecodeNs()) / 1e6);
+    BenchMetric("resident after first play", wave ? double(wave->size()) / 1024 : 0, "KB");
+    BenchMetric("SoundCache first Wave", double(cache.DecodeNs()) / 1e3, "us");
+
+    // Запуск: прежний путь писал ресурс во временный файл и открывал его
+    const NativePath temp = BENCH_SUITE ".tmp";
+    RunBench("startup: extract to temp file", 32, [&](int64_t) {
+        OutputFile f;
+        f.Open(temp, true);
+        f.Write(pcmWave.data(), pcmWave.size());
+        f.Close();
+        MappedFile m;
+        m.Open(temp);
+        DoNotOptimize(m.Data());
+    });
+    RemoveFile(temp);
+    RunBench("startup: SoundCache::SetSource", 1000000, [&](int64_t) {
+        SoundCache c;
+        c.SetSource(adpcmWave.data(), adpcmWave.size());
+        DoNotOptimize(c);
+    });
+    return 0;
+}
@@ -0,0 +1,65 @@
+// Кэш темы: сколько объектов создаётся при перерисовках и переключениях тем
+#include <cstdio>
+#include "bench.h"
+#include "theme_cache.h"
+
+static const int REDRAWS  = 10000;   // наведение/нажатие на кнопки
+static const int SWITCHES = 200;     // переключения темы
+static const int DIALOGS  = 100;     // открытия диалогов (ApplyTheme)
+
+int main()
+{
+    // Как было: кисть и перо на каждую отрисовку, фоновая кисть на каждый ApplyTheme
+    {
+        CountingDrawBackend gdi;
+        DrawHandle background = nullptr;
+        auto applyTheme = [&](const Theme& t) {
+            gdi.DeleteObject(background);
+            background = gdi.CreateBrush(t.bg);
+        };
+        Theme t = LIGHT_THEME;
+        applyTheme(t);
+        for (int i = 0; i < REDRAWS; ++i)
+        {
+            gdi.DeleteObject(gdi.CreateBrush(i & 1 ? t.accent : t.buttonBg));
+            gdi.DeleteObject(gdi.CreatePen(t.accent, 1));
+        }
+        for (int i = 0; i < SWITCHES; ++i) { t = (i & 1) ? LIGHT_THEME : DARK_THEME; applyTheme(t); }
+        for (int i = 0; i < DIALOGS; ++i) applyTheme(t);
+        gdi.DeleteObject(background);
+        std::printf("%-40s created %llu, deleted %llu\n", "per-draw objects",
+                    static_cast<unsigned long long>(gdi.Created()),
+                    static_cast<unsigned long long>(gdi.deleted));
+    }
+
+    {
+        CountingDrawBackend gdi;
+        {
+            ThemeCache cache(&gdi);
+            Theme t = LIGHT_THEME;
+            ThemeResources r = cache.Resources(t);
+            for (int i = 0; i < REDRAWS; ++i)
+            {
+                r = cache.Resources(t);
+                DoNotOptimize(i & 1 ? r.pressed : r.button);
+                DoNotOptimize(r.border);
+            }
+            for (int i = 0; i < SWITCHES; ++i) { t = (i & 1) ? LIGHT_THEME : DARK_THEME; r = cache.Resources(t); }
+            for (int i = 0; i < DIALOGS; ++i) r = cache.Resources(t);
+            std::printf("%-40s created %llu, live %llu, lookups %llu\n", "ThemeCache",
+                        static_cast<unsigned long long>(gdi.Created()),
+                        static_cast<unsigned long long>(gdi.Live()),
+                        static_cast<unsigned long long>(cache.Lookups()));
+        }
+        std::printf("%-40s live after destruction %llu\n", "ThemeCache",
+                    static_cast<unsigned long long>(gdi.Live()));
+    }
+
+    CountingDrawBackend gdi;
+    ThemeCache cache(&gdi);
+    RunBench("ThemeCache::Resources (theme toggle)", 10000000, [&](int64_t i) {
+        ThemeResources r = cache.Resources(i & 1 ? DARK_THEME : LIGHT_THEME);
+        DoNotOptimize(r);
+    });
+    return 0;
+}
@@ -0,0 +1,71 @@
+// Один тик окна целиком: чтение времени, модель отображения с форматированием
+// строк, перевзвод планировщика (всё, что делают WM_TIMER и UpdateClock, кроме
+// вызовов Win32)
+#include <cstdio>
+#include "bench.h"
+#include "clock_source.h"
+#include "clock_view.h"
+#include "time_format.h"
+
+// Форматирует строки так же, как WindowViewSink в game_clock.cpp
+class TextSink : public ClockViewSink {
+public:
+    void Present(const ClockView& v, unsigned changed) override
+    {
+        if (changed & FIELD_TIME)
+            AppendHHMM(time, v.minuteOfDay);
+        if (changed & FIELD_COUNTDOWN)
+            AppendHHMM(AppendLiteral(countdown, L"До полуночи: "), v.minutesToMidnight);
+        if (changed & FIELD_REAL_COUNTDOWN)
+            AppendMMSS(AppendLiteral(real, L"Реальное время: "), v.realSeconds);
+        DoNotOptimize(time);
+        DoNotOptimize(countdown);
+        DoNotOptimize(real);
+    }
+    wchar_t time[8], countdown[32], real[48];
+};
+
+int main()
+{
+    const int64_t start = 133000000000000000LL;
+    VirtualClockSource virt(start);
+    GameClock clock;
+    clock.SetGameTime(start, 0);
+    TickScheduler sched(start);
+    ClockViewModel model;
+    TextSink sink;
+    model.Attach(&sink);
+
+    // Каждый вызов — очередное пробуждение по планировщику
+    RunBench("tick: scheduler wakeup + UpdateClock", 2000000, [&](int64_t) {
+        int64_t now = virt.Now();
+        sched.RunAlarms(now);
+        if (sched.DisplayDue(now))
+        {
+            model.Update(clock, now);
+            sched.OnDisplayed(clock, now);
+        }
+        virt.Set(sched.NextWakeup());
+    });
+
+    // Все три строки на каждом тике (как до модели отображения)
+    RunBench("tick: all fields forced", 2000000, [&](int64_t) {
+        int64_t now = virt.Now();
+        model.Invalidate();
+        model.Update(clock, now);
+        sched.OnDisplayed(clock, now);
+        virt.Set(sched.NextWakeup());
+    });
+
+    // С реальным источником времени (anchored, как в приложении)
+    AnchoredClockSource anchored;
+    GameClock live;
+    live.SetGameTime(anchored.Now(), 600);
+    RunBench("tick: anchored source + UpdateClock", 2000000, [&](int64_t) {
+        int64_t now = anchored.Now();
+        model.Update(live, now);
+        sched.OnDisplayed(live, now);
+        DoNotOptimize(sched.NextWakeup());
+    });
+    return 0;
+}
@@ -0,0 +1,128 @@
+// Подписки на игровое время: цена рассылки на тысячи подписчиков (события в
+// секунду) и задержка доставки в другие потоки через очереди.
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <thread>
+#include <vector>
+#include "bench.h"
+#include "time_events.h"
+
+const int SUBSCRIBERS = 4096;
+const int CONSUMERS   = 4;
+
+static void CountEvent(const TimeEvent&, void* ctx) { ++*static_cast<uint64_t*>(ctx); }
+
+int main()
+{
+    GameClockState state;
+    state.start = 0;
+    GameClock clock(state);
+    const int64_t hour = 60 * GAME_MINUTE_TICKS;
+    const int64_t day = MINUTES_IN_DAY * GAME_MINUTE_TICKS;
+
+    // Рассылка вызовом: 4096 подписчиков на начало часа, Advance на каждой границе
+    {
+        TimeEventBus bus(SUBSCRIBERS);
+        uint64_t seen = 0;
+        for (int i = 0; i < SUBSCRIBERS; ++i) bus.Subscribe(TIME_EVENT_HOUR, CountEvent, &seen);
+        bus.Reset(clock, 0);
+        int64_t now = 0;
+        BenchResult r = RunBench("Advance hour, 4096 callbacks", 2000, [&](int64_t) {
+            now += hour;
+            bus.Advance(clock, now);
+        });
+        double rate = 1e3 * SUBSCRIBERS / r.nsPerOp;
+        std::printf("%-40s %12.1f ns/event, %.0f Mevents/s\n", "", r.nsPerOp / SUBSCRIBERS, rate);
+        BenchMetric("callback dispatch", rate, "Mevents/s");
+        DoNotOptimize(seen);
+    }
+
+    // "До полуночи" с 4096 разными сроками (1..3600 с): Advance раз в
+    // реальную секунду, почти всегда без событий
+    {
+        TimeEventBus bus(SUBSCRIBERS);
+        uint64_t seen = 0;
+        for (int i = 0; i < SUBSCRIBERS; ++i)
+            bus.Subscribe(TIME_EVENT_BEFORE_MIDNIGHT, CountEvent, &seen, (i % 3600 + 1) * TICKS_PER_SECOND);
+        int64_t now = day - 3601 * TICKS_PER_SECOND;
+        bus.Reset(clock, now);
+        RunBench("Advance per second, 4096 before-midnight", 100000, [&](int64_t) {
+            now += TICKS_PER_SECOND;
+            bus.Advance(clock, now);
+        });
+        DoNotOptimize(seen);
+        std::printf("%-40s %12llu delivered, %llu missed\n", "  before-midnight",
+                    (unsigned long long)bus.Stats().delivered, (unsigned long long)bus.Stats().missed);
+    }
+
+    // Доставка в другие потоки: 4096 подписок на 4 очереди, часы с минутой
+    // 0.1 мс (игровой час — 6 мс), рассылка по реальному времени
+    {
+        TimeEventBus bus(SUBSCRIBERS);
+        std::vector<TimeEventQueue*> queues;
+        for (int c = 0; c < CONSUMERS; ++c) queues.push_back(new TimeEventQueue(2 * SUBSCRIBERS / CONSUMERS));
+        for (int i = 0; i < SUBSCRIBERS; ++i) bus.Subscribe(TIME_EVENT_HOUR, queues[i % CONSUMERS]);
+
+        GameClockState fast;
+        fast.ticksPerMinute = 1000;
+        fast.start = BenchNowNs() / 100;
+        GameClock fastClock(fast);
+
+        std::atomic<bool> stop{ false };
+        std::vector<uint64_t> received(CONSUMERS), latencySum(CONSUMERS), latencyMax(CONSUMERS);
+        std::vector<std::thread> consumers;
+        for (int c = 0; c < CONSUMERS; ++c)
+            consumers.emplace_back([&, c] {
+                TimeEvent batch[256];
+                for (;;)
+                {
+                    size_t n = queues[c]->PopSome(batch, 256);
+                    if (!n)
+                    {
+                        if (stop.load(std::memory_order_acquire) && !queues[c]->Size()) break;
+                        std::this_thread::yield();
+                        continue;
+                    }
+                    uint64_t at = uint64_t(BenchNowNs() / 100);
+                    for (size_t i = 0; i < n; ++i)
+                    {
+                        uint64_t late = (at - uint64_t(batch[i].deadline)) * 100;
+                        latencySum[c] += late;
+                        if (late > latencyMax[c]) latencyMax[c] = late;
+                    }
+                    received[c] += n;
+                }
+            });
+
+        int64_t begin = BenchNowNs(), advanceNs = 0;
+        bus.Reset(fastClock, begin / 100);
+        while (BenchNowNs() - begin < 500000000)
+        {
+            int64_t next = bus.NextDeadline();
+            while (BenchNowNs() / 100 < next) std::this_thread::yield();
+            int64_t t0 = BenchNowNs();
+            bus.Advance(fastClock, t0 / 100);
+            advanceNs += BenchNowNs() - t0;
+        }
+        stop.store(true, std::memory_order_release);
+        for (std::thread& t : consumers) t.join();
+
+        uint64_t total = 0, sum = 0, max = 0;
+        for (int c = 0; c < CONSUMERS; ++c)
+        {
+            total += received[c];
+            sum += latencySum[c];
+            max = std::max(max, latencyMax[c]);
+        }
+        double avgUs = total ? double(sum) / total / 1e3 : 0;
+        std::printf("%-40s %12llu events (%.2f M/s), %llu dropped\n", "queued to 4 threads",
+                    (unsigned long long)total, double(total) / 0.5 / 1e6, (unsigned long long)bus.Stats().dropped);
+        std::printf("%-40s %12.1f ns/event in Advance\n", "", total ? double(advanceNs) / total : 0);
+        std::printf("%-40s %12.1f us avg, %.1f us max\n", "  deadline -> consumer", avgUs, double(max) / 1e3);
+        BenchMetric("queued delivery latency avg", avgUs, "us");
+        BenchMetric("queued delivery latency max", double(max) / 1e3, "us");
+        for (TimeEventQueue* q : queues) delete q;
+    }
+    return 0;
+}
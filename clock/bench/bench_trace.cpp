@@ -0,0 +1,41 @@
+// Трассировка: цена интервалов, счётчиков и гистограмм во включённом и
+// выключенном состоянии
+#include <cstdio>
+#include <string>
+#include <unistd.h>
+#include "bench.h"
+#include "trace.h"
+
+static TraceCounter   s_calls("bench.calls");
+static TraceHistogram s_values("bench.values");
+
+int main()
+{
+    volatile int64_t sink = 0;
+    RunBench("empty body", 10000000, [&](int64_t i) { sink = i; });
+
+    TraceEnable(false);
+    RunBench("TRACE_SPAN (disabled)", 10000000, [&](int64_t i) {
+        TRACE_SPAN("bench");
+        sink = i;
+    });
+    RunBench("TraceCounter::Add (disabled)", 10000000, [&](int64_t) { s_calls.Add(); });
+    RunBench("TraceHistogram::Record (disabled)", 10000000, [&](int64_t i) { s_values.Record(i & 4095); });
+
+    TraceEnable(true);
+    RunBench("TRACE_SPAN (enabled)", 2000000, [&](int64_t i) {
+        TRACE_SPAN("bench");
+        sink = i;
+    });
+    RunBench("TraceCounter::Add (enabled)", 10000000, [&](int64_t) { s_calls.Add(); });
+    RunBench("TraceHistogram::Record (enabled)", 10000000, [&](int64_t i) { s_values.Record(i & 4095); });
+
+    std::string path = "/tmp/wrclock-bench-" + std::to_string(getpid()) + ".trace.json";
+    int64_t t0 = BenchNowNs();
+    bool ok = TraceWriteChrome(path);
+    std::printf("%-40s %12.2f ms (%zu spans, %s)\n", "TraceWriteChrome", double(BenchNowNs() - t0) / 1e6,
+                TraceSpanCount(), ok ? "ok" : "failed");
+    std::fputs(TraceReport().c_str(), stdout);
+    std::remove(path.c_str());
+    return 0;
+}
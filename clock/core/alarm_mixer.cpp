@@ -0,0 +1,250 @@
+#include "alarm_mixer.h"
+#include <algorithm>
+#include <chrono>
+
+AlarmMixer::AlarmMixer(const MixerConfig& config)
+    : m_config(config),
+      m_commands(config.commandCapacity),
+      m_ring((config.prebufferFrames + config.blockFrames) * config.format.channels),
+      m_marks(config.maxVoices * 2)
+{
+    m_clips.reserve(config.maxClips);
+    m_voices.resize(config.maxVoices);
+    m_accum.resize(config.blockFrames * config.format.channels);
+    m_block.resize(config.blockFrames * config.format.channels);
+}
+
+int AlarmMixer::AddClip(const PcmBuffer* pcm)
+{
+    if (!pcm || m_clips.size() >= m_config.maxClips || pcm->sampleRate != m_config.format.sampleRate ||
+        (pcm->channels != 1 && pcm->channels != m_config.format.channels))
+        return -1;
+    m_clips.push_back(pcm);
+    return static_cast<int>(m_clips.size() - 1);
+}
+
+// -----------------------------------------------------------------------------
+// Управляющий поток
+// -----------------------------------------------------------------------------
+bool AlarmMixer::Trigger(int clip, float gain)
+{
+    if (clip < 0 || static_cast<size_t>(clip) >= m_clips.size()) return false;
+    gain = std::min(std::max(gain, 0.0f), 2.0f);   // sample * Q15 в int32
+    MixerCommand c{ MixerCommand::PLAY, static_cast<uint16_t>(clip), static_cast<int32_t>(gain * 32768.0f),
+                    AudioNowNs() };
+    if (m_commands.TryPush(c))
+    {
+        Wake();
+        return true;
+    }
+    m_dropped.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+bool AlarmMixer::StopAll()
+{
+    MixerCommand c{ MixerCommand::STOP_ALL, 0, 0, AudioNowNs() };
+    if (m_commands.TryPush(c))
+    {
+        Wake();
+        return true;
+    }
+    m_dropped.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+// -----------------------------------------------------------------------------
+// Поток микшера
+// -----------------------------------------------------------------------------
+void AlarmMixer::Apply(const MixerCommand& c)
+{
+    if (c.type == MixerCommand::STOP_ALL)
+    {
+        for (Voice& v : m_voices) v.clip = nullptr;
+        m_active.store(0, std::memory_order_relaxed);
+        return;
+    }
+    // Свободный голос, иначе самый давно запущенный
+    Voice* slot = nullptr;
+    for (Voice& v : m_voices)
+        if (!v.clip) { slot = &v; break; }
+    if (!slot)
+    {
+        slot = &*std::min_element(m_voices.begin(), m_voices.end(),
+                                  [](const Voice& a, const Voice& b) { return a.started < b.started; });
+        m_stolen.fetch_add(1, std::memory_order_relaxed);
+    }
+    else
+        m_active.fetch_add(1, std::memory_order_relaxed);
+    slot->clip = m_clips[c.clip];
+    slot->pos = 0;
+    slot->gain = c.gain;
+    slot->triggerNs = c.triggerNs;
+    slot->started = ++m_started;
+    slot->marked = false;
+    m_triggers.fetch_add(1, std::memory_order_relaxed);
+}
+
+void AlarmMixer::MixBlock()
+{
+    const size_t ch = m_config.format.channels;
+    const size_t frames = m_config.blockFrames;
+    std::fill(m_accum.begin(), m_accum.end(), 0);
+    for (Voice& v : m_voices)
+    {
+        if (!v.clip) continue;
+        if (!v.marked)
+        {
+            // Клип начинается с этого блока
+            if (m_marks.TryPush(LatencyMark{ m_mixedFrames, v.triggerNs })) v.marked = true;
+        }
+        const PcmBuffer& clip = *v.clip;
+        size_t n = std::min(frames, clip.Frames() - v.pos);
+        const int16_t* src = clip.samples.data() + v.pos * clip.channels;
+        int32_t* acc = m_accum.data();
+        const int32_t g = v.gain;
+        if (clip.channels == ch)
+            for (size_t i = 0; i < n * ch; ++i)
+                acc[i] += (src[i] * g) >> 15;
+        else
+            for (size_t i = 0; i < n; ++i)
+            {
+                int32_t s = (src[i] * g) >> 15;   // моно на все каналы
+                for (size_t c = 0; c < ch; ++c) acc[i * ch + c] += s;
+            }
+        v.pos += n;
+        if (v.pos >= clip.Frames())
+        {
+            v.clip = nullptr;
+            m_active.fetch_sub(1, std::memory_order_relaxed);
+        }
+    }
+    for (size_t i = 0; i < frames * ch; ++i)
+        m_block[i] = static_cast<int16_t>(std::min(std::max(m_accum[i], -32768), 32767));
+}
+
+size_t AlarmMixer::Pump()
+{
+    MixerCommand c;
+    while (m_commands.TryPop(&c)) Apply(c);
+
+    const size_t ch = m_config.format.channels;
+    const size_t want = m_config.prebufferFrames * ch;
+    const size_t block = m_config.blockFrames * ch;
+    size_t mixed = 0;
+    while (m_ring.Size() < want && m_ring.FreeSpace() >= block)
+    {
+        int64_t t0 = AudioNowNs();
+        MixBlock();
+        m_ring.PushSome(m_block.data(), block);
+        m_mixedFrames += m_config.blockFrames;
+        mixed += m_config.blockFrames;
+        m_mixNs.fetch_add(AudioNowNs() - t0, std::memory_order_relaxed);
+        m_blocks.fetch_add(1, std::memory_order_relaxed);
+    }
+    return mixed;
+}
+
+void AlarmMixer::Start()
+{
+    Stop();
+    m_stop.store(false, std::memory_order_relaxed);
+    m_thread = std::thread(&AlarmMixer::Run, this);
+}
+
+void AlarmMixer::Stop()
+{
+    if (!m_thread.joinable()) return;
+    m_stop.store(true, std::memory_order_relaxed);
+    Wake();
+    m_thread.join();
+    m_idle.store(false, std::memory_order_relaxed);
+}
+
+// Команды проверяются под m_wakeMutex, а Wake берёт его перед notify:
+// команда, положенная до засыпания, не теряется
+void AlarmMixer::Wake()
+{
+    std::lock_guard<std::mutex> g(m_wakeMutex);
+    m_wakeCv.notify_one();
+}
+
+void AlarmMixer::Run()
+{
+    const size_t ch = m_config.format.channels;
+    const int64_t rate = m_config.format.sampleRate;
+    auto woken = [this] { return m_stop.load(std::memory_order_relaxed) || m_commands.Size() != 0; };
+    while (!m_stop.load(std::memory_order_relaxed))
+    {
+        Pump();
+        std::unique_lock<std::mutex> lock(m_wakeMutex);
+        if (m_active.load(std::memory_order_relaxed) == 0)
+        {
+            // Тишину не смешиваем: устройство досыплет её само
+            m_idle.store(true, std::memory_order_relaxed);
+            m_wakeCv.wait(lock, woken);
+            m_idle.store(false, std::memory_order_relaxed);
+            continue;
+        }
+        // Следующий блок влезет, когда устройство заберёт лишнее сверх
+        // prebufferFrames и ещё один кадр
+        size_t queued = m_ring.Size() / ch;
+        size_t frames = queued >= m_config.prebufferFrames ? queued - m_config.prebufferFrames + 1 : 0;
+        if (frames)
+            m_wakeCv.wait_for(lock, std::chrono::nanoseconds(int64_t(frames) * 1000000000 / rate), woken);
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Поток устройства
+// -----------------------------------------------------------------------------
+void AlarmMixer::Render(int16_t* out, size_t frames)
+{
+    const size_t ch = m_config.format.channels;
+    size_t got = m_ring.PopSome(out, frames * ch);
+    if (got < frames * ch)
+    {
+        std::fill(out + got, out + frames * ch, int16_t(0));
+        if (!m_idle.load(std::memory_order_relaxed)) m_underruns.fetch_add(1, std::memory_order_relaxed);
+    }
+    // Кадры потока, которые микшер успел смешать, идут в устройство по
+    // порядку: метка с номером кадра < уже отданных — клип зазвучал
+    m_renderedFrames += got / ch;
+    int64_t now = -1;
+    while (m_hasMark || m_marks.TryPop(&m_pendingMark))
+    {
+        m_hasMark = true;
+        if (m_pendingMark.frame >= m_renderedFrames) break;
+        if (now < 0) now = AudioNowNs();
+        int64_t latency = now - m_pendingMark.triggerNs;
+        m_latencies.fetch_add(1, std::memory_order_relaxed);
+        m_latencySumNs.fetch_add(latency, std::memory_order_relaxed);
+        if (latency > m_latencyMaxNs.load(std::memory_order_relaxed))
+            m_latencyMaxNs.store(latency, std::memory_order_relaxed);
+        m_hasMark = false;
+    }
+}
+
+MixerStats AlarmMixer::Stats() const
+{
+    MixerStats s;
+    s.triggers = m_triggers.load(std::memory_order_relaxed);
+    s.dropped = m_dropped.load(std::memory_order_relaxed);
+    s.stolen = m_stolen.load(std::memory_order_relaxed);
+    s.blocks = m_blocks.load(std::memory_order_relaxed);
+    s.mixNs = m_mixNs.load(std::memory_order_relaxed);
+    s.underruns = m_underruns.load(std::memory_order_relaxed);
+    s.latencies = m_latencies.load(std::memory_order_relaxed);
+    s.latencySumNs = m_latencySumNs.load(std::memory_order_relaxed);
+    s.latencyMaxNs = m_latencyMaxNs.load(std::memory_order_relaxed);
+    return s;
+}
+
+// -----------------------------------------------------------------------------
+// Планировщик
+// -----------------------------------------------------------------------------
+void FireAlarmCue(WheelTimer* timer, int64_t)
+{
+    const AlarmCue* cue = static_cast<const AlarmCue*>(timer->ctx);
+    if (cue && cue->mixer) cue->mixer->Trigger(cue->clip, cue->gain);
+}
@@ -0,0 +1,151 @@
+#pragma once
+// -----------------------------------------------------------------------------
+// Микшер звуков будильника.
+//
+// Клипы (уже декодированный PCM, см. sound_decoder.h) держатся в памяти;
+// звучать одновременно может до maxVoices клипов. Три потока, и ни один не
+// ждёт другого:
+//   управляющий (окно, планировщик) — Trigger/StopAll кладут команду в
+//       очередь SpscQueue<MixerCommand> и будят поток микшера;
+//   поток микшера — Pump разбирает команды, смешивает блоки по blockFrames
+//       кадров и доливает кольцо сэмплов до prebufferFrames. Пока звучат
+//       клипы, он спит ровно до того, как в кольце освободится блок; без
+//       клипов — до следующей команды, а кольцо просто опустошается;
+//   поток устройства — Render забирает сэмплы из кольца; если их не хватило,
+//       досыпает тишину и, если микшер не простаивает, считает опустошение.
+// Память выделяется только в конструкторе и AddClip.
+//
+// Задержка от Trigger до выхода первого сэмпла из Render меряется по меткам:
+// микшер отмечает, на каком кадре потока начался клип, Render — когда этот
+// кадр ушёл в устройство.
+// -----------------------------------------------------------------------------
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "audio_output.h"
+#include "sound_decoder.h"
+#include "spsc_queue.h"
+#include "timer_wheel.h"
+
+struct MixerConfig {
+    AudioFormat format;
+    size_t blockFrames = 256;       // кадров за одно смешивание
+    size_t prebufferFrames = 512;   // сколько держать готовым в кольце
+    size_t maxVoices = 16;
+    size_t maxClips = 16;
+    size_t commandCapacity = 64;
+};
+
+struct MixerCommand {
+    enum Type : uint16_t { PLAY, STOP_ALL };
+    uint16_t type;
+    uint16_t clip;
+    int32_t  gain;        // Q15: 32768 — без изменения громкости
+    int64_t  triggerNs;   // AudioNowNs() в момент команды
+};
+
+struct MixerStats {
+    uint64_t triggers = 0;      // клипов запущено
+    uint64_t dropped = 0;       // команд не влезло в очередь
+    uint64_t stolen = 0;        // голосов отобрано у самых старых
+    uint64_t blocks = 0;        // блоков смешано
+    int64_t  mixNs = 0;         // суммарное время смешивания
+    uint64_t underruns = 0;     // Render получил меньше, чем просил
+    uint64_t latencies = 0;     // измерено задержек
+    int64_t  latencySumNs = 0;
+    int64_t  latencyMaxNs = 0;
+};
+
+class AlarmMixer : public AudioRenderer {
+public:
+    explicit AlarmMixer(const MixerConfig& config = MixerConfig());
+    ~AlarmMixer() override { Stop(); }
+    AlarmMixer(const AlarmMixer&) = delete;
+    AlarmMixer& operator=(const AlarmMixer&) = delete;
+
+    // До запуска, из одного потока. Клип в формате вывода или моно с той же
+    // частотой; pcm живёт дольше микшера. -1 — формат не подходит или мест нет
+    int AddClip(const PcmBuffer* pcm);
+
+    // Управляющий поток (один). false — очередь полна, команда отброшена
+    bool Trigger(int clip, float gain = 1.0f);
+    bool StopAll();
+
+    // Поток микшера: команды и доливка кольца; возвращает смешанных кадров
+    size_t Pump();
+    // Собственный поток микшера: Pump по мере освобождения кольца, а без
+    // звучащих клипов — только по командам
+    void Start();
+    void Stop();
+
+    // Поток устройства
+    void Render(int16_t* out, size_t frames) override;
+
+    const MixerConfig& Config() const { return m_config; }
+    size_t ActiveVoices() const { return m_active.load(std::memory_order_relaxed); }
+    MixerStats Stats() const;
+
+private:
+    struct Voice {
+        const PcmBuffer* clip = nullptr;   // nullptr — свободен
+        size_t  pos = 0;                   // следующий кадр клипа
+        int32_t gain = 0;
+        int64_t triggerNs = 0;
+        uint64_t started = 0;              // номер запуска (для отбора голоса)
+        bool    marked = false;
+    };
+    struct LatencyMark {
+        uint64_t frame;       // кадр потока, с которого звучит клип
+        int64_t  triggerNs;
+    };
+
+    void Apply(const MixerCommand& c);
+    void MixBlock();
+    void Run();
+    void Wake();
+
+    MixerConfig m_config;
+    std::vector<const PcmBuffer*> m_clips;
+    std::vector<Voice>   m_voices;
+    std::vector<int32_t> m_accum;
+    std::vector<int16_t> m_block;
+    uint64_t m_started = 0;
+    uint64_t m_mixedFrames = 0;      // кадров отдано в кольцо
+
+    SpscQueue<MixerCommand> m_commands;
+    SpscQueue<int16_t>      m_ring;
+    SpscQueue<LatencyMark>  m_marks;
+    LatencyMark m_pendingMark{};     // поток устройства
+    bool        m_hasMark = false;
+    uint64_t    m_renderedFrames = 0;
+
+    std::thread       m_thread;
+    std::atomic<bool> m_stop{ false };
+    std::atomic<bool> m_idle{ false };   // поток микшера ждёт команды
+    std::atomic<size_t> m_active{ 0 };
+    std::mutex              m_wakeMutex;
+    std::condition_variable m_wakeCv;
+
+    // Счётчики пишет каждый свой поток; читаются как оценка
+    std::atomic<uint64_t> m_triggers{ 0 }, m_dropped{ 0 }, m_stolen{ 0 }, m_blocks{ 0 };
+    std::atomic<int64_t>  m_mixNs{ 0 };
+    std::atomic<uint64_t> m_underruns{ 0 }, m_latencies{ 0 };
+    std::atomic<int64_t>  m_latencySumNs{ 0 }, m_latencyMaxNs{ 0 };
+};
+
+// -----------------------------------------------------------------------------
+// Связь с планировщиком: звук по сработавшему таймеру
+// -----------------------------------------------------------------------------
+// WheelTimer с fire = FireAlarmCue и ctx = &cue ставится в TimerWheel или
+// TickScheduler::ArmAlarm; в срок клип запускается через Trigger
+struct AlarmCue {
+    AlarmMixer* mixer = nullptr;
+    int         clip = 0;
+    float       gain = 1.0f;
+};
+
+void FireAlarmCue(WheelTimer* timer, int64_t now);
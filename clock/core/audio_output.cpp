@@ -0,0 +1,87 @@
+#include "audio_output.h"
+#include <chrono>
+#include "sound_decoder.h"
+
+int64_t AudioNowNs()
+{
+    using namespace std::chrono;
+    return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+// -----------------------------------------------------------------------------
+// WavAudioSink
+// -----------------------------------------------------------------------------
+bool WavAudioSink::Open(const AudioFormat& format)
+{
+    m_format = format;
+    m_bytes = 0;
+    uint8_t header[PCM_WAVE_HEADER];
+    PutPcmWaveHeader(header, format.channels, format.sampleRate, 0);
+    return m_file.Open(m_path, true) && m_file.Write(header, sizeof(header));
+}
+
+bool WavAudioSink::Write(const int16_t* samples, size_t frames)
+{
+    size_t bytes = frames * m_format.channels * sizeof(int16_t);
+    m_bytes += bytes;
+    return m_file.Write(samples, bytes);
+}
+
+void WavAudioSink::Close()
+{
+    if (!m_file.IsOpen()) return;
+    uint8_t header[PCM_WAVE_HEADER];
+    uint32_t bytes = m_bytes > 0xFFFFFFF0u - PCM_WAVE_HEADER ? 0xFFFFFFF0u - PCM_WAVE_HEADER
+                                                             : static_cast<uint32_t>(m_bytes);
+    PutPcmWaveHeader(header, m_format.channels, m_format.sampleRate, bytes);
+    m_file.WriteAt(0, header, sizeof(header));
+    m_file.Close();
+}
+
+// -----------------------------------------------------------------------------
+// ClockedAudioDevice
+// -----------------------------------------------------------------------------
+bool ClockedAudioDevice::Start(AudioRenderer* renderer, const AudioFormat& format, size_t periodFrames)
+{
+    Stop();
+    if (!renderer || !periodFrames || !format.channels || !m_sink->Open(format)) return false;
+    m_renderer = renderer;
+    m_format = format;
+    m_period = periodFrames;
+    m_buffer.assign(periodFrames * format.channels, 0);
+    m_frames.store(0, std::memory_order_relaxed);
+    m_failed.store(false, std::memory_order_relaxed);
+    m_stop.store(false, std::memory_order_relaxed);
+    m_thread = std::thread(&ClockedAudioDevice::Run, this);
+    return true;
+}
+
+void ClockedAudioDevice::Stop()
+{
+    if (!m_thread.joinable()) return;
+    m_stop.store(true, std::memory_order_relaxed);
+    m_thread.join();
+    m_sink->Close();
+}
+
+void ClockedAudioDevice::Run()
+{
+    using namespace std::chrono;
+    const auto period = nanoseconds(int64_t(m_period) * 1000000000 / m_format.sampleRate);
+    auto next = steady_clock::now();
+    while (!m_stop.load(std::memory_order_relaxed))
+    {
+        m_renderer->Render(m_buffer.data(), m_period);
+        if (!m_sink->Write(m_buffer.data(), m_period))
+        {
+            m_failed.store(true, std::memory_order_relaxed);
+            break;
+        }
+        m_frames.fetch_add(m_period, std::memory_order_relaxed);
+        if (m_realtime)
+        {
+            next += period;
+            std::this_thread::sleep_until(next);
+        }
+    }
+}
@@ -0,0 +1,95 @@
+#pragma once
+// -----------------------------------------------------------------------------
+// Вывод звука: устройство забирает у AudioRenderer буферы фиксированного
+// размера из своего потока (как звуковая карта из callback).
+//
+// ClockedAudioDevice — устройство без звуковой карты: поток, который раз в
+// период (или без пауз, если realtime = false) берёт буфер и отдаёт его в
+// AudioSink — в никуда (NullAudioSink) или в WAV-файл (WavAudioSink). Так
+// задержку и нагрузку микшера можно мерить на машине без звука.
+// -----------------------------------------------------------------------------
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <vector>
+#include "file_io.h"
+
+struct AudioFormat {
+    uint32_t sampleRate = 44100;
+    uint16_t channels = 2;
+};
+
+// Монотонное время в нс — общая шкала для меток задержки
+int64_t AudioNowNs();
+
+class AudioRenderer {
+public:
+    virtual ~AudioRenderer() = default;
+    // Поток устройства: frames кадров в out. Без блокировок и выделений памяти.
+    virtual void Render(int16_t* out, size_t frames) = 0;
+};
+
+class AudioDevice {
+public:
+    virtual ~AudioDevice() = default;
+    virtual bool Start(AudioRenderer* renderer, const AudioFormat& format, size_t periodFrames) = 0;
+    virtual void Stop() = 0;
+};
+
+// Куда ClockedAudioDevice отдаёт готовые буферы
+class AudioSink {
+public:
+    virtual ~AudioSink() = default;
+    virtual bool Open(const AudioFormat& format) = 0;
+    virtual bool Write(const int16_t* samples, size_t frames) = 0;
+    virtual void Close() = 0;
+};
+
+class NullAudioSink : public AudioSink {
+public:
+    bool Open(const AudioFormat&) override { return true; }
+    bool Write(const int16_t*, size_t) override { return true; }
+    void Close() override {}
+};
+
+// WAV PCM 16 бит; размеры в заголовке дописываются при Close
+class WavAudioSink : public AudioSink {
+public:
+    explicit WavAudioSink(const NativePath& path) : m_path(path) {}
+    bool Open(const AudioFormat& format) override;
+    bool Write(const int16_t* samples, size_t frames) override;
+    void Close() override;
+
+private:
+    NativePath  m_path;
+    OutputFile  m_file;
+    AudioFormat m_format;
+    uint64_t    m_bytes = 0;
+};
+
+class ClockedAudioDevice : public AudioDevice {
+public:
+    explicit ClockedAudioDevice(AudioSink* sink, bool realtime = true) : m_sink(sink), m_realtime(realtime) {}
+    ~ClockedAudioDevice() override { Stop(); }
+
+    bool Start(AudioRenderer* renderer, const AudioFormat& format, size_t periodFrames) override;
+    void Stop() override;
+
+    uint64_t Frames() const { return m_frames.load(std::memory_order_relaxed); }
+    bool     Failed() const { return m_failed.load(std::memory_order_relaxed); }
+
+private:
+    void Run();
+
+    AudioSink*           m_sink;
+    bool                 m_realtime;
+    AudioRenderer*       m_renderer = nullptr;
+    AudioFormat          m_format;
+    size_t               m_period = 0;
+    std::vector<int16_t> m_buffer;
+    std::thread          m_thread;
+    std::atomic<bool>    m_stop{ false };
+    std::atomic<bool>    m_failed{ false };
+    std::atomic<uint64_t> m_frames{ 0 };
+};
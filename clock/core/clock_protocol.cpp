@@ -0,0 +1,142 @@
+#include "clock_protocol.h"
+#include <cstring>
+
+// Хосты, под которые собирается демон, little-endian — поля копируются как есть
+template <typename T>
+static inline void Put(uint8_t* p, T v) { std::memcpy(p, &v, sizeof(T)); }
+template <typename T>
+static inline T Get(const uint8_t* p) { T v; std::memcpy(&v, p, sizeof(T)); return v; }
+
+static void PutHeader(uint8_t* p, uint16_t count, uint32_t seq)
+{
+    Put<uint32_t>(p, WIRE_MAGIC);
+    Put<uint16_t>(p + 4, count);
+    Put<uint16_t>(p + 6, 0);
+    Put<uint32_t>(p + 8, seq);
+}
+
+static bool GetHeader(const uint8_t* p, size_t len, size_t itemSize, uint16_t* count, uint32_t* seq)
+{
+    if (len < WIRE_HEADER_SIZE || Get<uint32_t>(p) != WIRE_MAGIC) return false;
+    *count = Get<uint16_t>(p + 4);
+    *seq   = Get<uint32_t>(p + 8);
+    return *count <= WIRE_MAX_BATCH && len == WIRE_HEADER_SIZE + *count * itemSize;
+}
+
+size_t EncodeRequest(uint8_t* out, size_t cap, uint32_t seq, const ClockQuery* q, size_t count)
+{
+    size_t size = WIRE_HEADER_SIZE + count * WIRE_QUERY_SIZE;
+    if (count > WIRE_MAX_BATCH || size > cap) return 0;
+    PutHeader(out, static_cast<uint16_t>(count), seq);
+    uint8_t* p = out + WIRE_HEADER_SIZE;
+    for (size_t i = 0; i < count; ++i, p += WIRE_QUERY_SIZE)
+    {
+        p[0] = q[i].op;
+        Put<int64_t>(p + 1, q[i].arg);
+    }
+    return size;
+}
+
+int DecodeResponse(const uint8_t* in, size_t len, uint32_t* seq, ClockAnswer* out, size_t cap)
+{
+    uint16_t count;
+    if (!GetHeader(in, len, WIRE_ANSWER_SIZE, &count, seq) || count > cap) return -1;
+    const uint8_t* p = in + WIRE_HEADER_SIZE;
+    for (size_t i = 0; i < count; ++i, p += WIRE_ANSWER_SIZE)
+    {
+        out[i].op     = p[0];
+        out[i].status = p[1];
+        out[i].aux    = Get<uint32_t>(p + 2);
+        out[i].value  = Get<int64_t>(p + 6);
+    }
+    return count;
+}
+
+// arg от клиента проверяется до любой арифметики с ним
+static bool ArgInRange(const GameClockState& s, uint8_t op, int64_t arg)
+{
+    switch (op)
+    {
+    case OP_GAME_AT:
+    case OP_NEXT_MIDNIGHT: return arg >= 0 && arg <= WIRE_MAX_TIME;
+    case OP_DEADLINE_OF:   return arg >= -(WIRE_MAX_TIME / s.ticksPerMinute) &&
+                                  arg <= WIRE_MAX_TIME / s.ticksPerMinute;
+    default:               return true;
+    }
+}
+
+// Момент, показания часов в который нужны запросу
+static int64_t QueryTime(const GameClockState& s, uint8_t op, int64_t arg, int64_t now)
+{
+    if (!ArgInRange(s, op, arg)) return now;
+    switch (op)
+    {
+    case OP_GAME_AT:       return arg;
+    case OP_NEXT_MIDNIGHT: return arg ? arg : now;
+    default:               return now;
+    }
+}
+
+static ClockAnswer Answer(const GameClockState& s, const ClockReading& r, int64_t t, uint8_t op, int64_t arg)
+{
+    ClockAnswer a{ op, WIRE_OK, 0, 0 };
+    if (!ArgInRange(s, op, arg))
+    {
+        a.status = WIRE_BAD_ARG;
+        return a;
+    }
+    switch (op)
+    {
+    case OP_GAME_NOW:
+    case OP_GAME_AT:
+        a.value = r.gameMinute;
+        a.aux   = static_cast<uint32_t>(r.minuteOfDay);
+        break;
+    case OP_NEXT_MIDNIGHT:
+        a.value = t + r.ticksToMidnight;
+        a.aux   = static_cast<uint32_t>(r.minutesToMidnight);
+        break;
+    case OP_DEADLINE_OF:
+        a.value = s.start - s.offset + arg * s.ticksPerMinute;
+        break;
+    default:
+        a.status = WIRE_BAD_OP;
+        break;
+    }
+    return a;
+}
+
+size_t HandleRequest(const GameClock& clock, int64_t now,
+                     const uint8_t* in, size_t len, uint8_t* out)
+{
+    return HandleRequest(clock.State(), ReadClockGeneric, now, in, len, out);
+}
+
+size_t HandleRequest(const GameClockState& state, ReadClockFn read, int64_t now,
+                     const uint8_t* in, size_t len, uint8_t* out)
+{
+    uint16_t count;
+    uint32_t seq;
+    if (!GetHeader(in, len, WIRE_QUERY_SIZE, &count, &seq)) return 0;
+
+    // Сначала все моменты, потом одно чтение часов на весь пакет
+    int64_t      at[WIRE_MAX_BATCH];
+    ClockReading readings[WIRE_MAX_BATCH];
+    const uint8_t* q = in + WIRE_HEADER_SIZE;
+    for (size_t i = 0; i < count; ++i, q += WIRE_QUERY_SIZE)
+        at[i] = QueryTime(state, q[0], Get<int64_t>(q + 1), now);
+    if (count) read(state, at, count, readings);
+
+    PutHeader(out, count, seq);
+    q = in + WIRE_HEADER_SIZE;
+    uint8_t* p = out + WIRE_HEADER_SIZE;
+    for (size_t i = 0; i < count; ++i, q += WIRE_QUERY_SIZE, p += WIRE_ANSWER_SIZE)
+    {
+        ClockAnswer a = Answer(state, readings[i], at[i], q[0], Get<int64_t>(q + 1));
+        p[0] = a.op;
+        p[1] = a.status;
+        Put<uint32_t>(p + 2, a.aux);
+        Put<int64_t>(p + 6, a.value);
+    }
+    return WIRE_HEADER_SIZE + count * WIRE_ANSWER_SIZE;
+}
@@ -0,0 +1,72 @@
+#pragma once
+// -----------------------------------------------------------------------------
+// Бинарный протокол запросов игрового времени (для wrclockd).
+//
+// Одно сообщение = заголовок + count запросов (или ответов) фиксированного
+// размера, все числа little-endian. Сокет SOCK_SEQPACKET сохраняет границы
+// сообщений, поэтому длина в заголовке не нужна.
+//
+//   заголовок (12 байт): magic u32 "WRC1", count u16, flags u16, seq u32
+//   запрос    ( 9 байт): op u8, arg i64
+//   ответ     (14 байт): op u8, status u8, aux u32, value i64
+// -----------------------------------------------------------------------------
+#include <cstddef>
+#include <cstdint>
+#include "game_time.h"
+#include "rate_profile.h"
+
+const uint32_t WIRE_MAGIC        = 0x31435257;   // "WRC1"
+const size_t   WIRE_HEADER_SIZE  = 12;
+const size_t   WIRE_QUERY_SIZE   = 9;
+const size_t   WIRE_ANSWER_SIZE  = 14;
+const size_t   WIRE_MAX_BATCH    = 1024;
+const size_t   WIRE_MAX_REQUEST  = WIRE_HEADER_SIZE + WIRE_MAX_BATCH * WIRE_QUERY_SIZE;
+const size_t   WIRE_MAX_RESPONSE = WIRE_HEADER_SIZE + WIRE_MAX_BATCH * WIRE_ANSWER_SIZE;
+
+enum WireOp : uint8_t {
+    OP_GAME_NOW      = 1,   // value = игровая минута сейчас,       aux = минута суток
+    OP_NEXT_MIDNIGHT = 2,   // value = реальный момент след. полуночи после arg (0 — сейчас),
+                            // aux = игровых минут до неё
+    OP_GAME_AT       = 3,   // value = игровая минута в реальный момент arg, aux = минута суток
+    OP_DEADLINE_OF   = 4,   // value = реальный момент начала игровой минуты arg
+};
+
+// Допустимые arg: моменты — в [0, WIRE_MAX_TIME] (около 3650 лет от 1601 г.),
+// номер минуты — такой, что её начало не дальше WIRE_MAX_TIME от начала
+// отсчёта часов. Иначе ответ WIRE_BAD_ARG без расчёта: арифметика часов
+// на таких числах переполняется
+const int64_t  WIRE_MAX_TIME     = int64_t(1) << 60;
+
+enum WireStatus : uint8_t {
+    WIRE_OK         = 0,
+    WIRE_BAD_OP     = 1,
+    WIRE_BAD_ARG    = 2,   // arg вне допустимого диапазона
+};
+
+struct ClockQuery {
+    uint8_t op;
+    int64_t arg;
+};
+
+struct ClockAnswer {
+    uint8_t  op;
+    uint8_t  status;
+    uint32_t aux;
+    int64_t  value;
+};
+
+// Кодирование запроса; возвращает размер сообщения или 0, если не влезло
+size_t EncodeRequest(uint8_t* out, size_t cap, uint32_t seq, const ClockQuery* q, size_t count);
+
+// Разбор ответа; возвращает число ответов или -1 при ошибке формата
+int DecodeResponse(const uint8_t* in, size_t len, uint32_t* seq, ClockAnswer* out, size_t cap);
+
+// Обработка одного сообщения-запроса: ответ пишется в out (не меньше
+// WIRE_MAX_RESPONSE байт). Возвращает размер ответа или 0 для мусора.
+size_t HandleRequest(const GameClock& clock, int64_t now,
+                     const uint8_t* in, size_t len, uint8_t* out);
+// То же через функцию чтения, выбранную заранее под скорость часов
+// (SelectReadClock, RateProfileInfo::read): все моменты запроса читаются
+// одним пакетным вызовом
+size_t HandleRequest(const GameClockState& state, ReadClockFn read, int64_t now,
+                     const uint8_t* in, size_t len, uint8_t* out);
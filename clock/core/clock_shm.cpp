@@ -0,0 +1,163 @@
+#include "clock_shm.h"
+#include <chrono>
+#include <string>
+#include <thread>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+static const uint32_t SHM_MAGIC   = 0x4D485357;   // "WSHM"
+static const uint32_t SHM_VERSION = 1;
+
+static_assert(sizeof(ClockShmPage) <= CLOCK_SHM_SIZE, "page layout too large");
+static_assert(std::atomic<int64_t>::is_always_lock_free, "shared atomics must be lock-free");
+
+bool SharedRegion::Open(const char* name, bool writable, size_t size)
+{
+    Close();
+#ifdef _WIN32
+    std::string full = std::string("Local\\") + name;
+    HANDLE writer = nullptr;
+    if (writable)
+    {
+        // Мьютекс живёт, пока открыт хотя бы один его дескриптор: раз он уже
+        // есть, есть и живой писатель
+        writer = CreateMutexA(nullptr, FALSE, (full + ".writer").c_str());
+        if (!writer) return false;
+        if (GetLastError() == ERROR_ALREADY_EXISTS) { CloseHandle(writer); return false; }
+    }
+    HANDLE h = writable
+        ? CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE,
+                             static_cast<DWORD>(uint64_t(size) >> 32), static_cast<DWORD>(size),
+                             full.c_str())
+        : OpenFileMappingA(FILE_MAP_READ, FALSE, full.c_str());
+    void* p = h ? MapViewOfFile(h, writable ? FILE_MAP_ALL_ACCESS : FILE_MAP_READ, 0, 0, size) : nullptr;
+    if (!p)
+    {
+        if (h) CloseHandle(h);
+        if (writer) CloseHandle(writer);
+        return false;
+    }
+    m_mapping = h;
+    m_writer = writer;
+#else
+    std::string full = std::string("/") + name;
+    int fd = writable ? shm_open(full.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644)
+                      : shm_open(full.c_str(), O_RDONLY | O_CLOEXEC, 0);
+    if (fd < 0) return false;
+    // Блокировка снимается сама, когда писатель закрывает дескриптор или падает
+    if (writable && (flock(fd, LOCK_EX | LOCK_NB) != 0 || ftruncate(fd, static_cast<off_t>(size)) != 0))
+    {
+        close(fd);
+        return false;
+    }
+    void* p = mmap(nullptr, size, writable ? PROT_READ | PROT_WRITE : PROT_READ,
+                   MAP_SHARED, fd, 0);
+    if (p == MAP_FAILED || !writable) close(fd);
+    if (p == MAP_FAILED) return false;
+    if (writable) m_writer = fd;
+#endif
+    m_data = p;
+    m_size = size;
+    return true;
+}
+
+void SharedRegion::Close()
+{
+    if (!m_data) return;
+#ifdef _WIN32
+    UnmapViewOfFile(m_data);
+    CloseHandle(m_mapping);
+    m_mapping = nullptr;
+    if (m_writer) CloseHandle(m_writer);
+    m_writer = nullptr;
+#else
+    munmap(m_data, m_size);
+    if (m_writer >= 0) close(m_writer);
+    m_writer = -1;
+#endif
+    m_data = nullptr;
+    m_size = 0;
+}
+
+uint64_t ClockPublisher::Publish(const GameClockState& s)
+{
+    ClockShmPage* p = m_region.Page();
+    if (!p) return 0;
+
+    uint64_t seq = p->seq.load(std::memory_order_relaxed);
+    if (seq & 1) ++seq;   // прошлый писатель упал посреди записи
+    p->seq.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    uint64_t gen = p->generation.load(std::memory_order_relaxed) + 1;
+    p->start.store(s.start, std::memory_order_relaxed);
+    p->offset.store(s.offset, std::memory_order_relaxed);
+    p->ticksPerMinute.store(s.ticksPerMinute, std::memory_order_relaxed);
+    p->minutesPerDay.store(s.minutesPerDay, std::memory_order_relaxed);
+    p->generation.store(gen, std::memory_order_relaxed);
+
+    p->seq.store(seq + 2, std::memory_order_release);
+    if (p->magic.load(std::memory_order_relaxed) != SHM_MAGIC)
+    {
+        p->version.store(SHM_VERSION, std::memory_order_relaxed);
+        p->magic.store(SHM_MAGIC, std::memory_order_release);
+    }
+    return gen;
+}
+
+bool ClockSubscriber::TryRead(ClockSnapshot* out) const
+{
+    const ClockShmPage* p = m_region.Page();
+    if (!p || p->magic.load(std::memory_order_acquire) != SHM_MAGIC ||
+        p->version.load(std::memory_order_relaxed) != SHM_VERSION)
+        return false;
+
+    uint64_t before = p->seq.load(std::memory_order_acquire);
+    if (before & 1) return false;
+
+    ClockSnapshot snap;
+    snap.state.start          = p->start.load(std::memory_order_relaxed);
+    snap.state.offset         = p->offset.load(std::memory_order_relaxed);
+    snap.state.ticksPerMinute = p->ticksPerMinute.load(std::memory_order_relaxed);
+    snap.state.minutesPerDay  = static_cast<int32_t>(p->minutesPerDay.load(std::memory_order_relaxed));
+    snap.generation           = p->generation.load(std::memory_order_relaxed);
+
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (p->seq.load(std::memory_order_relaxed) != before) return false;
+    *out = snap;
+    return true;
+}
+
+bool ClockSubscriber::Read(ClockSnapshot* out) const
+{
+    const ClockShmPage* p = m_region.Page();
+    if (!p || p->magic.load(std::memory_order_acquire) != SHM_MAGIC ||
+        p->version.load(std::memory_order_relaxed) != SHM_VERSION)
+        return false;
+    // Обычно запись длится доли микросекунды: сначала крутимся, потом уступаем
+    // процессор (писатель мог быть вытеснен), но не дольше предела
+    for (int i = 0; i < 1000; ++i)
+        if (TryRead(out)) return true;
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(CLOCK_SHM_READ_WAIT_MS);
+    do
+    {
+        std::this_thread::yield();
+        if (TryRead(out)) return true;
+    } while (std::chrono::steady_clock::now() < deadline);
+    return false;
+}
+
+uint64_t ClockSubscriber::Generation() const
+{
+    const ClockShmPage* p = m_region.Page();
+    return p ? p->generation.load(std::memory_order_acquire) : 0;
+}
@@ -0,0 +1,99 @@
+#pragma once
+// -----------------------------------------------------------------------------
+// Публикация состояния часов через разделяемую память.
+//
+// Один писатель (окно часов или wrclockd) кладёт (start, offset, rate,
+// generation) на страницу под seqlock; читатели в любых процессах получают
+// согласованный снимок без блокировок и системных вызовов. generation растёт
+// при каждой перенастройке часов.
+//
+// Seqlock держится, только пока писатель один, поэтому писатель владеет
+// областью исключительно: flock на её дескрипторе (Linux) или именованный
+// мьютекс "<имя>.writer" (Windows). Второй писатель на то же имя получает
+// false из Open, а не портит страницу первого.
+// -----------------------------------------------------------------------------
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include "game_time.h"
+
+const char* const CLOCK_SHM_DEFAULT_NAME = "wrclock";
+const size_t      CLOCK_SHM_SIZE         = 4096;
+const int         CLOCK_SHM_READ_WAIT_MS = 20;     // предел ожидания в ClockSubscriber::Read
+
+struct ClockSnapshot {
+    GameClockState state;
+    uint64_t       generation = 0;
+};
+
+// Раскладка страницы; поля данных атомарные, чтобы чтение под seqlock не было гонкой
+struct ClockShmPage {
+    std::atomic<uint32_t> magic;
+    std::atomic<uint32_t> version;
+    std::atomic<uint64_t> seq;          // нечётное — идёт запись
+    std::atomic<int64_t>  start;
+    std::atomic<int64_t>  offset;
+    std::atomic<int64_t>  ticksPerMinute;
+    std::atomic<int64_t>  minutesPerDay;
+    std::atomic<uint64_t> generation;
+};
+
+class SharedRegion {
+public:
+    SharedRegion() = default;
+    ~SharedRegion() { Close(); }
+    SharedRegion(const SharedRegion&) = delete;
+    SharedRegion& operator=(const SharedRegion&) = delete;
+
+    // Писатель создаёт область размером size и становится её единственным
+    // писателем (false, если писатель уже есть); читатель отображает столько же
+    bool Open(const char* name, bool writable, size_t size = CLOCK_SHM_SIZE);
+    void Close();
+    void*  Data() const { return m_data; }
+    size_t Size() const { return m_size; }
+    ClockShmPage* Page() const { return static_cast<ClockShmPage*>(m_data); }
+
+private:
+    void*  m_data = nullptr;
+    size_t m_size = 0;
+#ifdef _WIN32
+    void* m_mapping = nullptr;
+    void* m_writer = nullptr;    // мьютекс писателя
+#else
+    int   m_writer = -1;         // дескриптор с flock писателя
+#endif
+};
+
+class ClockPublisher {
+public:
+    // false, если у области уже есть живой писатель
+    bool Open(const char* name = CLOCK_SHM_DEFAULT_NAME) { return m_region.Open(name, true); }
+    bool IsOpen() const { return m_region.Page() != nullptr; }
+
+    // Новое состояние часов; возвращает его поколение
+    uint64_t Publish(const GameClockState& s);
+
+private:
+    SharedRegion m_region;
+};
+
+class ClockSubscriber {
+public:
+    bool Open(const char* name = CLOCK_SHM_DEFAULT_NAME) { return m_region.Open(name, false); }
+    bool IsOpen() const { return m_region.Page() != nullptr; }
+
+    // Одна попытка чтения (без ожидания): false, если писатель как раз пишет
+    // или ещё ничего не опубликовано
+    bool TryRead(ClockSnapshot* out) const;
+
+    // Повторяет TryRead, пока не получится, но не дольше CLOCK_SHM_READ_WAIT_MS:
+    // писатель, умерший посреди записи, оставляет страницу "занятой" навсегда.
+    // false — публикаций не было или страница так и не освободилась
+    bool Read(ClockSnapshot* out) const;
+
+    // Дешёвая проверка без чтения всего снимка
+    uint64_t Generation() const;
+
+private:
+    SharedRegion m_region;
+};
@@ -0,0 +1,147 @@
+#include "clock_source.h"
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include "game_time.h"
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+int64_t MonotonicTicksNow()
+{
+#ifdef _WIN32
+    static const int64_t freq = [] { LARGE_INTEGER f; QueryPerformanceFrequency(&f); return f.QuadPart; }();
+    LARGE_INTEGER c; QueryPerformanceCounter(&c);
+    // Без переполнения: целые секунды отдельно от остатка
+    return c.QuadPart / freq * TICKS_PER_SECOND + c.QuadPart % freq * TICKS_PER_SECOND / freq;
+#elif defined(CLOCK_BOOTTIME)
+    // CLOCK_MONOTONIC стоит во время сна машины; BOOTTIME идёт и тогда
+    timespec ts; clock_gettime(CLOCK_BOOTTIME, &ts);
+    return ts.tv_sec * TICKS_PER_SECOND + ts.tv_nsec / 100;
+#else
+    timespec ts; clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * TICKS_PER_SECOND + ts.tv_nsec / 100;
+#endif
+}
+
+int64_t CoarseMonotonicTicksNow()
+{
+#if defined(_WIN32)
+    return static_cast<int64_t>(GetTickCount64()) * (TICKS_PER_SECOND / 1000);
+#elif defined(CLOCK_MONOTONIC_COARSE)
+    timespec ts; clock_gettime(CLOCK_MONOTONIC_COARSE, &ts);
+    return ts.tv_sec * TICKS_PER_SECOND + ts.tv_nsec / 100;
+#else
+    return MonotonicTicksNow();
+#endif
+}
+
+int64_t WallClockSource::Now()
+{
+    return WallTicksNow();
+}
+
+MonotonicClockSource::MonotonicClockSource(bool coarse)
+    : m_coarse(coarse)
+    , m_wall0(WallTicksNow())
+    , m_mono0(coarse ? CoarseMonotonicTicksNow() : MonotonicTicksNow())
+{
+}
+
+int64_t MonotonicClockSource::Now()
+{
+    return m_wall0 + (m_coarse ? CoarseMonotonicTicksNow() : MonotonicTicksNow()) - m_mono0;
+}
+
+AnchoredClockSource::AnchoredClockSource(int64_t resync, int64_t maxStep)
+    : m_resync(resync)
+    , m_maxStep(maxStep)
+    , m_wall0(WallTicksNow())
+    , m_mono0(MonotonicTicksNow())
+{
+}
+
+int64_t AnchoredClockSource::Now()
+{
+    int64_t mono = MonotonicTicksNow();
+    int64_t t = m_wall0 + mono - m_mono0;
+    if (mono - m_mono0 >= m_resync)
+    {
+        int64_t wall = WallTicksNow();
+        int64_t diff = wall - t;
+        if (diff > m_maxStep || diff < -m_maxStep)
+        {
+            // Системное время перевели: продолжаем со своего значения
+            ++m_steps;
+            m_wall0 = t;
+        }
+        else
+        {
+            m_wall0 = wall;
+            t = wall;
+        }
+        m_mono0 = mono;
+    }
+    // Поправка назад не должна отматывать уже выданное время
+    if (t < m_last) t = m_last;
+    m_last = t;
+    return t;
+}
+
+VirtualClockSource::VirtualClockSource(int64_t start, double speed)
+    : m_base(start)
+    , m_real0(MonotonicTicksNow())
+    , m_speed(speed)
+{
+}
+
+int64_t VirtualClockSource::Now()
+{
+    if (m_speed == 0.0) return m_base;
+    return m_base + static_cast<int64_t>(static_cast<double>(MonotonicTicksNow() - m_real0) * m_speed);
+}
+
+int64_t VirtualClockSource::RealDelay(int64_t ticks) const
+{
+    if (ticks <= 0) return ticks;
+    if (m_speed == 0.0) return INT64_MAX;
+    // Округляем вверх: таймер не должен сработать раньше срока
+    double real = std::ceil(static_cast<double>(ticks) / m_speed);
+    return real >= 9.2e18 ? INT64_MAX : static_cast<int64_t>(real);
+}
+
+void VirtualClockSource::SetSpeed(double speed)
+{
+    Set(Now());
+    m_speed = speed;
+}
+
+void VirtualClockSource::Set(int64_t now)
+{
+    m_base = now;
+    m_real0 = MonotonicTicksNow();
+}
+
+std::unique_ptr<ClockSource> CreateClockSource(const char* spec)
+{
+    if (!std::strcmp(spec, "wall"))      return std::unique_ptr<ClockSource>(new WallClockSource());
+    if (!std::strcmp(spec, "monotonic")) return std::unique_ptr<ClockSource>(new MonotonicClockSource(false));
+    if (!std::strcmp(spec, "coarse"))    return std::unique_ptr<ClockSource>(new MonotonicClockSource(true));
+    if (!std::strcmp(spec, "anchored"))  return std::unique_ptr<ClockSource>(new AnchoredClockSource());
+    if (!std::strncmp(spec, "virtual", 7) && (spec[7] == 0 || spec[7] == ':'))
+    {
+        double speed = 1.0;
+        if (spec[7] == ':')
+        {
+            char* end;
+            speed = std::strtod(spec + 8, &end);
+            if (end == spec + 8 || *end || speed < 0) return nullptr;
+        }
+        return std::unique_ptr<ClockSource>(new VirtualClockSource(WallTicksNow(), speed));
+    }
+    return nullptr;
+}
@@ -0,0 +1,96 @@
+#pragma once
+// -----------------------------------------------------------------------------
+// Источники текущего времени для часов.
+//
+// Все источники отдают тики по 100 нс в эпохе FILETIME, как WallTicksNow(),
+// поэтому состояние часов и журнал от выбора источника не зависят.
+//   wall      — системное время как есть (переводы часов и NTP видны сразу)
+//   monotonic — системное время на момент запуска + монотонные часы
+//   coarse    — то же на грубых монотонных часах (дешевле чтение, шаг ~1-16 мс)
+//   anchored  — монотонные часы, которые изредка сверяются с системным
+//               временем: мелкий уход подтягивается, скачки не проходят
+//   virtual   — виртуальное время: идёт в N раз быстрее или только по Advance()
+// Монотонные часы идут и во время сна машины (CLOCK_BOOTTIME в Linux,
+// QueryPerformanceCounter в Windows), поэтому после пробуждения monotonic и
+// anchored не отстают на время сна, а anchored не принимает его за перевод
+// часов. Исключение — coarse в Linux: у CLOCK_MONOTONIC_COARSE пары с
+// BOOTTIME нет, и сон он не считает.
+// Источники не потокобезопасны: по экземпляру на поток.
+// -----------------------------------------------------------------------------
+#include <cstdint>
+#include <memory>
+
+// Монотонные часы в тиках по 100 нс от произвольной точки; идут и во сне
+int64_t MonotonicTicksNow();
+int64_t CoarseMonotonicTicksNow();
+
+class ClockSource {
+public:
+    virtual ~ClockSource() = default;
+    virtual int64_t     Now() = 0;
+    virtual const char* Name() const = 0;
+    // Сколько реальных тиков пройдёт, пока источник отсчитает ticks (для
+    // таймеров ОС); INT64_MAX — не дождаться, время стоит
+    virtual int64_t     RealDelay(int64_t ticks) const { return ticks; }
+};
+
+class WallClockSource : public ClockSource {
+public:
+    int64_t     Now() override;
+    const char* Name() const override { return "wall"; }
+};
+
+class MonotonicClockSource : public ClockSource {
+public:
+    explicit MonotonicClockSource(bool coarse = false);
+    int64_t     Now() override;
+    const char* Name() const override { return m_coarse ? "coarse" : "monotonic"; }
+
+private:
+    bool    m_coarse;
+    int64_t m_wall0;
+    int64_t m_mono0;
+};
+
+class AnchoredClockSource : public ClockSource {
+public:
+    // resync — как часто сверяться с системным временем; maxStep — расхождение,
+    // больше которого системное время считается переведённым и игнорируется
+    explicit AnchoredClockSource(int64_t resync = 60 * 10000000LL, int64_t maxStep = 2 * 10000000LL);
+    int64_t     Now() override;
+    const char* Name() const override { return "anchored"; }
+
+    // Сколько раз системное время скачком расходилось с монотонным
+    uint64_t Steps() const { return m_steps; }
+
+private:
+    int64_t  m_resync;
+    int64_t  m_maxStep;
+    int64_t  m_wall0;
+    int64_t  m_mono0;
+    int64_t  m_last = INT64_MIN;
+    uint64_t m_steps = 0;
+};
+
+class VirtualClockSource : public ClockSource {
+public:
+    // speed = 0 — время стоит и двигается только через Advance()/Set()
+    explicit VirtualClockSource(int64_t start, double speed = 0.0);
+    int64_t     Now() override;
+    const char* Name() const override { return "virtual"; }
+    int64_t     RealDelay(int64_t ticks) const override;
+
+    void   SetSpeed(double speed);
+    double Speed() const { return m_speed; }
+    void   Advance(int64_t ticks) { m_base += ticks; }
+    void   Set(int64_t now);
+
+private:
+    int64_t m_base;       // виртуальное время в момент m_real0
+    int64_t m_real0;
+    double  m_speed;
+};
+
+// "wall", "monotonic", "coarse", "anchored", "virtual" или "virtual:N"
+// (N-кратная скорость); nullptr — неизвестное имя
+std::unique_ptr<ClockSource> CreateClockSource(const char* spec);
@@ -0,0 +1,209 @@
+#include "clock_table.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define WRCLOCK_X86 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define WRCLOCK_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define WRCLOCK_TARGET_AVX2
+#endif
+
+// Векторный путь считает в double: все промежуточные целые должны быть
+// меньше 2^51, поэтому now не должен уходить от опорного момента дальше.
+static const int64_t SIMD_WINDOW = int64_t(1) << 50;
+
+bool CpuHasAvx2()
+{
+#if !defined(WRCLOCK_X86)
+    return false;
+#elif defined(_MSC_VER)
+    int regs[4];
+    __cpuidex(regs, 7, 0);
+    bool avx2 = (regs[1] & (1 << 5)) != 0;
+    __cpuid(regs, 1);
+    bool osxsave = (regs[2] & (1 << 27)) != 0;
+    return avx2 && osxsave && (_xgetbv(0) & 6) == 6;
+#else
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+ClockTable::ClockTable(int64_t reference) : m_reference(reference)
+{
+}
+
+void ClockTable::Reserve(size_t n)
+{
+    m_base.reserve(n);
+    m_ticksPerMinute.reserve(n);
+    m_minutesPerDay.reserve(n);
+    m_tpm.reserve(n);
+    m_invTpm.reserve(n);
+    m_mpd.reserve(n);
+    m_invMpd.reserve(n);
+    m_minuteOfDay.reserve(n);
+    m_minutesToMidnight.reserve(n);
+    m_realSeconds.reserve(n);
+}
+
+// Деление на длину минуты и суток: нулевые и отрицательные не пропускаем
+static bool Usable(const GameClockState& s)
+{
+    return s.ticksPerMinute > 0 && s.minutesPerDay > 0;
+}
+
+size_t ClockTable::Add(const GameClockState& s)
+{
+    if (!Usable(s)) return SIZE_MAX;
+    size_t i = Size();
+    m_base.push_back(0);
+    m_ticksPerMinute.push_back(0);
+    m_minutesPerDay.push_back(0);
+    m_tpm.push_back(0);
+    m_invTpm.push_back(0);
+    m_mpd.push_back(0);
+    m_invMpd.push_back(0);
+    m_minuteOfDay.push_back(0);
+    m_minutesToMidnight.push_back(0);
+    m_realSeconds.push_back(0);
+    Set(i, s);
+    return i;
+}
+
+bool ClockTable::Set(size_t i, const GameClockState& s)
+{
+    if (!Usable(s)) return false;
+    m_base[i]           = s.start - s.offset;
+    m_ticksPerMinute[i] = s.ticksPerMinute;
+    m_minutesPerDay[i]  = s.minutesPerDay;
+    m_tpm[i]    = static_cast<double>(s.ticksPerMinute);
+    m_invTpm[i] = 1.0 / m_tpm[i];
+    m_mpd[i]    = static_cast<double>(s.minutesPerDay);
+    m_invMpd[i] = 1.0 / m_mpd[i];
+    Normalize(i);
+    return true;
+}
+
+GameClockState ClockTable::Get(size_t i) const
+{
+    GameClockState s;
+    s.start          = m_base[i];
+    s.offset         = 0;
+    s.ticksPerMinute = m_ticksPerMinute[i];
+    s.minutesPerDay  = m_minutesPerDay[i];
+    return s;
+}
+
+void ClockTable::Normalize(size_t i)
+{
+    int64_t dayTicks = m_ticksPerMinute[i] * m_minutesPerDay[i];
+    m_base[i] += FloorDiv(m_reference - m_base[i], dayTicks) * dayTicks;
+}
+
+void ClockTable::Rebase(int64_t reference)
+{
+    m_reference = reference;
+    for (size_t i = 0; i < Size(); ++i)
+        Normalize(i);
+}
+
+void ClockTable::Evaluate(int64_t now, size_t first, size_t count, SimdPath path)
+{
+    size_t last = first + count;
+    if (last > Size()) last = Size();
+    if (first >= last) return;
+
+    static const bool hasAvx2 = CpuHasAvx2();
+    bool inWindow = now - m_reference < SIMD_WINDOW && m_reference - now < SIMD_WINDOW;
+    bool avx2 = path == SimdPath::Avx2 || (path == SimdPath::Auto && hasAvx2);
+    if (avx2 && hasAvx2 && inWindow)
+        EvaluateAvx2(now, first, last);
+    else
+        EvaluateScalar(now, first, last);
+}
+
+// Та же арифметика, что в GameClock: точные целые без ограничений на диапазон
+void ClockTable::EvaluateScalar(int64_t now, size_t first, size_t last)
+{
+    for (size_t i = first; i < last; ++i)
+    {
+        int64_t tpm = m_ticksPerMinute[i];
+        int64_t mpd = m_minutesPerDay[i];
+        int64_t minute = FloorDiv(now - m_base[i], tpm);
+        int64_t day    = FloorDiv(minute, mpd);
+        int64_t mod    = minute - day * mpd;
+        int64_t left   = m_base[i] + (day + 1) * mpd * tpm - now;
+        m_minuteOfDay[i]       = static_cast<int32_t>(mod);
+        m_minutesToMidnight[i] = static_cast<int32_t>(mpd - mod);
+        m_realSeconds[i]       = static_cast<int32_t>(left / TICKS_PER_SECOND);
+    }
+}
+
+#if defined(WRCLOCK_X86)
+// floor(a / b) для целых в double: частное через обратное значение и
+// поправка на ±1, после которой остаток гарантированно в [0, b)
+WRCLOCK_TARGET_AVX2
+static inline __m256d FloorDivPd(__m256d a, __m256d b, __m256d invB, __m256d* rem)
+{
+    const __m256d one = _mm256_set1_pd(1.0);
+    const __m256d zero = _mm256_setzero_pd();
+    __m256d q = _mm256_floor_pd(_mm256_mul_pd(a, invB));
+    __m256d r = _mm256_sub_pd(a, _mm256_mul_pd(q, b));
+
+    __m256d neg = _mm256_cmp_pd(r, zero, _CMP_LT_OQ);
+    q = _mm256_sub_pd(q, _mm256_and_pd(neg, one));
+    r = _mm256_add_pd(r, _mm256_and_pd(neg, b));
+
+    __m256d over = _mm256_cmp_pd(r, b, _CMP_GE_OQ);
+    q = _mm256_add_pd(q, _mm256_and_pd(over, one));
+    r = _mm256_sub_pd(r, _mm256_and_pd(over, b));
+
+    *rem = r;
+    return q;
+}
+
+WRCLOCK_TARGET_AVX2
+void ClockTable::EvaluateAvx2(int64_t now, size_t first, size_t last)
+{
+    // int64 -> double без AVX-512: x + 1.5*2^52 в битах double и вычитание
+    const __m256i magicI = _mm256_castpd_si256(_mm256_set1_pd(6755399441055744.0));
+    const __m256d magicD = _mm256_set1_pd(6755399441055744.0);
+    const __m256d tps    = _mm256_set1_pd(static_cast<double>(TICKS_PER_SECOND));
+    const __m256d invTps = _mm256_set1_pd(1.0 / static_cast<double>(TICKS_PER_SECOND));
+    const __m256i nowV   = _mm256_set1_epi64x(now);
+
+    size_t i = first;
+    for (; i + 4 <= last; i += 4)
+    {
+        __m256i base = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&m_base[i]));
+        __m256i gtI  = _mm256_sub_epi64(nowV, base);
+        __m256d gt   = _mm256_sub_pd(_mm256_castsi256_pd(_mm256_add_epi64(gtI, magicI)), magicD);
+
+        __m256d tpm = _mm256_loadu_pd(&m_tpm[i]);
+        __m256d mpd = _mm256_loadu_pd(&m_mpd[i]);
+        __m256d r, mod, rs;
+        __m256d minute = FloorDivPd(gt, tpm, _mm256_loadu_pd(&m_invTpm[i]), &r);
+        FloorDivPd(minute, mpd, _mm256_loadu_pd(&m_invMpd[i]), &mod);
+
+        __m256d toMid = _mm256_sub_pd(mpd, mod);
+        __m256d left  = _mm256_sub_pd(_mm256_mul_pd(toMid, tpm), r);
+        __m256d secs  = FloorDivPd(left, tps, invTps, &rs);
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(&m_minuteOfDay[i]), _mm256_cvtpd_epi32(mod));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(&m_minutesToMidnight[i]), _mm256_cvtpd_epi32(toMid));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(&m_realSeconds[i]), _mm256_cvtpd_epi32(secs));
+    }
+    EvaluateScalar(now, i, last);
+}
+#else
+void ClockTable::EvaluateAvx2(int64_t now, size_t first, size_t last)
+{
+    EvaluateScalar(now, first, last);
+}
+#endif
@@ -0,0 +1,70 @@
+#pragma once
+// -----------------------------------------------------------------------------
+// Таблица множества игровых часов (миры/шарды) в виде структуры массивов.
+//
+// Каждые часы задаются так же, как GameClock (start, offset, длина минуты и
+// суток). Evaluate() одним проходом считает для всех часов то же, что
+// UpdateClock: минуту суток, игровые минуты и реальные секунды до полуночи.
+// Есть путь на AVX2 и скалярный запасной.
+// -----------------------------------------------------------------------------
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "game_time.h"
+
+enum class SimdPath { Auto, Scalar, Avx2 };
+
+bool CpuHasAvx2();
+
+class ClockTable {
+public:
+    // reference — момент, относительно которого нормализуются часы (обычно "сейчас")
+    explicit ClockTable(int64_t reference = 0);
+
+    // Часы с ticksPerMinute или minutesPerDay <= 0 не принимаются: Add
+    // возвращает SIZE_MAX, Set — false, и таблица не меняется
+    size_t Add(const GameClockState& s);
+    bool   Set(size_t i, const GameClockState& s);
+    void   Reserve(size_t n);
+    size_t Size() const { return m_base.size(); }
+
+    // Эквивалентные часы: минута суток совпадает, номер игрового дня — нет
+    GameClockState Get(size_t i) const;
+
+    // Пересчёт диапазона [first, first + count) на момент now
+    void Evaluate(int64_t now, size_t first, size_t count, SimdPath path = SimdPath::Auto);
+    void Evaluate(int64_t now, SimdPath path = SimdPath::Auto) { Evaluate(now, 0, Size(), path); }
+
+    // Результаты последнего Evaluate
+    const int32_t* MinuteOfDay() const { return m_minuteOfDay.data(); }
+    const int32_t* MinutesToMidnight() const { return m_minutesToMidnight.data(); }
+    const int32_t* RealSecondsToMidnight() const { return m_realSeconds.data(); }
+
+    // Сдвиг опорного момента. Evaluate сам его не двигает (диапазоны можно
+    // считать из разных потоков): если now ушёл от опорного момента дальше
+    // 2^50 тиков (~3.5 года), результат верен, но считается скалярным путём,
+    // пока владелец таблицы не вызовет Rebase(now)
+    void Rebase(int64_t reference);
+
+private:
+    void Normalize(size_t i);
+    void EvaluateScalar(int64_t now, size_t first, size_t last);
+    void EvaluateAvx2(int64_t now, size_t first, size_t last);
+
+    int64_t m_reference;
+
+    // Входные столбцы: игровые тики = now - base, base выровнен на начало
+    // игровых суток не позже m_reference
+    std::vector<int64_t> m_base;
+    std::vector<int64_t> m_ticksPerMinute;
+    std::vector<int32_t> m_minutesPerDay;
+    std::vector<double>  m_tpm;       // те же значения в double для SIMD
+    std::vector<double>  m_invTpm;
+    std::vector<double>  m_mpd;
+    std::vector<double>  m_invMpd;
+
+    // Выходные столбцы
+    std::vector<int32_t> m_minuteOfDay;
+    std::vector<int32_t> m_minutesToMidnight;
+    std::vector<int32_t> m_realSeconds;
+};
@@ -0,0 +1,46 @@
+#include "clock_view.h"
+#include <algorithm>
+
+ClockView ComputeClockView(const GameClock& clock, int64_t now)
+{
+    ClockView v;
+    v.minuteOfDay       = clock.MinuteOfDay(now);
+    v.minutesToMidnight = clock.MinutesToMidnight(now);
+    v.realSeconds       = clock.TicksToMidnight(now) / TICKS_PER_SECOND;
+    return v;
+}
+
+void ClockViewModel::Attach(ClockViewSink* sink)
+{
+    if (std::find(m_sinks.begin(), m_sinks.end(), sink) != m_sinks.end()) return;
+    m_sinks.push_back(sink);
+    m_dirty = FIELD_ALL;   // новому получателю нужна полная картинка
+}
+
+void ClockViewModel::Detach(ClockViewSink* sink)
+{
+    m_sinks.erase(std::remove(m_sinks.begin(), m_sinks.end(), sink), m_sinks.end());
+}
+
+unsigned ClockViewModel::Update(const GameClock& clock, int64_t now)
+{
+    ClockView v = ComputeClockView(clock, now);
+    unsigned changed = m_dirty;
+    if (v.minuteOfDay != m_view.minuteOfDay)             changed |= FIELD_TIME;
+    if (v.minutesToMidnight != m_view.minutesToMidnight) changed |= FIELD_COUNTDOWN;
+    if (v.realSeconds != m_view.realSeconds)             changed |= FIELD_REAL_COUNTDOWN;
+    m_view = v;
+    m_dirty = 0;
+    if (changed)
+        for (ClockViewSink* s : m_sinks)
+            s->Present(m_view, changed);
+    return changed;
+}
+
+size_t RecordingViewSink::CountOf(unsigned field) const
+{
+    size_t n = 0;
+    for (const Entry& e : entries)
+        n += (e.changed & field) != 0;
+    return n;
+}
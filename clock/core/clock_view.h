@@ -0,0 +1,64 @@
+#pragma once
+// -----------------------------------------------------------------------------
+// Модель отображения часов: из состояния GameClock вычисляются показываемые
+// значения, и подписчикам (окно Win32, терминал, запись для проверки)
+// передаются только изменившиеся поля. Перерисовки одинакового текста
+// при этом не происходит.
+// -----------------------------------------------------------------------------
+#include <cstdint>
+#include <vector>
+#include "game_time.h"
+#include "tick_scheduler.h"
+
+struct ClockView {
+    int     minuteOfDay       = -1;   // FIELD_TIME
+    int     minutesToMidnight = -1;   // FIELD_COUNTDOWN
+    int64_t realSeconds       = -1;   // FIELD_REAL_COUNTDOWN, целые секунды
+};
+
+ClockView ComputeClockView(const GameClock& clock, int64_t now);
+
+// Получатель изменений; changed — маска ClockField
+class ClockViewSink {
+public:
+    virtual ~ClockViewSink() = default;
+    virtual void Present(const ClockView& view, unsigned changed) = 0;
+};
+
+class ClockViewModel {
+public:
+    void Attach(ClockViewSink* sink);
+    void Detach(ClockViewSink* sink);
+
+    // Пересчитывает модель и раздаёт изменения; возвращает маску изменившихся полей
+    unsigned Update(const GameClock& clock, int64_t now);
+
+    // Следующий Update перешлёт поля fields, даже если значения те же
+    void Invalidate(unsigned fields = FIELD_ALL) { m_dirty |= fields; }
+
+    const ClockView& View() const { return m_view; }
+
+private:
+    std::vector<ClockViewSink*> m_sinks;
+    ClockView m_view;
+    unsigned  m_dirty = FIELD_ALL;
+};
+
+// Запоминает всё, что пришло, — для проверок и бенчмарков
+class RecordingViewSink : public ClockViewSink {
+public:
+    struct Entry {
+        ClockView view;
+        unsigned  changed;
+    };
+
+    void Present(const ClockView& view, unsigned changed) override
+    {
+        entries.push_back({ view, changed });
+    }
+
+    // Сколько раз поле field было передано
+    size_t CountOf(unsigned field) const;
+
+    std::vector<Entry> entries;
+};
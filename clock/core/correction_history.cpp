@@ -0,0 +1,369 @@
+#include "correction_history.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include "crc32.h"
+
+template <typename T>
+static inline void Put(uint8_t* p, T v) { std::memcpy(p, &v, sizeof(T)); }
+template <typename T>
+static inline T Get(const uint8_t* p) { T v; std::memcpy(&v, p, sizeof(T)); return v; }
+
+// -----------------------------------------------------------------------------
+// zigzag-varint
+// -----------------------------------------------------------------------------
+static inline void PutVarint(std::vector<uint8_t>* out, int64_t v)
+{
+    uint64_t z = (static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63);
+    while (z >= 0x80)
+    {
+        out->push_back(static_cast<uint8_t>(z | 0x80));
+        z >>= 7;
+    }
+    out->push_back(static_cast<uint8_t>(z));
+}
+
+// false — число не закончилось до end (колонка испорчена)
+static inline bool GetVarint(const uint8_t*& p, const uint8_t* end, int64_t* v)
+{
+    uint64_t z = 0;
+    for (int shift = 0;; shift += 7)
+    {
+        if (p == end) return false;
+        uint8_t b = *p++;
+        z |= static_cast<uint64_t>(b & 0x7F) << shift;
+        if (!(b & 0x80) || shift >= 63) break;
+    }
+    *v = static_cast<int64_t>(z >> 1) ^ -static_cast<int64_t>(z & 1);
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+// Поправки и сводки
+// -----------------------------------------------------------------------------
+// Игровые тики на момент at в масштабе номинальной минуты минус at
+static int64_t NominalPhase(int64_t at, const GameClockState& s, int64_t nominal)
+{
+    int64_t ticks = at - s.start + s.offset;
+    if (s.ticksPerMinute != nominal)
+        ticks = std::llround(double(ticks) * (double(nominal) / double(s.ticksPerMinute)));
+    return ticks - at;
+}
+
+Correction MakeCorrection(int64_t at, const GameClockState& before,
+                          const GameClockState& after, uint16_t source,
+                          int64_t nominalTicksPerMinute)
+{
+    int64_t oldPhase = NominalPhase(at, before, nominalTicksPerMinute);
+    int64_t newPhase = NominalPhase(at, after, nominalTicksPerMinute);
+    int64_t day = nominalTicksPerMinute * after.minutesPerDay;
+    int64_t shift = FloorMod(newPhase - oldPhase + day / 2, day) - day / 2;
+
+    Correction c;
+    c.at = at;
+    c.oldOffset = FloorMod(oldPhase, nominalTicksPerMinute * before.minutesPerDay);
+    c.newOffset = c.oldOffset + shift;
+    c.source = source;
+    return c;
+}
+
+void CorrectionStats::Add(int64_t shift)
+{
+    ++count;
+    sum += shift;
+    sumAbs += shift < 0 ? -shift : shift;
+    min = std::min(min, shift);
+    max = std::max(max, shift);
+}
+
+void CorrectionStats::Merge(const CorrectionStats& s)
+{
+    count += s.count;
+    sum += s.sum;
+    sumAbs += s.sumAbs;
+    min = std::min(min, s.min);
+    max = std::max(max, s.max);
+}
+
+double DriftPerDay(const CorrectionStats& s, int64_t from, int64_t to)
+{
+    if (to <= from) return 0;
+    return double(s.sum) * double(86400 * TICKS_PER_SECOND) / double(to - from);
+}
+
+// -----------------------------------------------------------------------------
+// Блоки
+// -----------------------------------------------------------------------------
+size_t EncodeCorrectionBlock(const Correction* c, size_t n, std::vector<uint8_t>* out)
+{
+    std::vector<uint8_t> cols[4];
+    CorrectionStats stats;
+    int64_t prevAt = c[0].at, prevNew = c[0].oldOffset;
+    for (size_t i = 0; i < n; ++i)
+    {
+        PutVarint(&cols[0], c[i].at - prevAt);
+        PutVarint(&cols[1], c[i].oldOffset - prevNew);
+        PutVarint(&cols[2], c[i].newOffset - c[i].oldOffset);
+        PutVarint(&cols[3], c[i].source);
+        stats.Add(c[i].Shift());
+        prevAt = c[i].at;
+        prevNew = c[i].newOffset;
+    }
+
+    size_t begin = out->size();
+    size_t size = CORRECTION_BLOCK_HEADER;
+    for (const auto& col : cols) size += col.size();
+    out->resize(begin + size);
+    uint8_t* h = out->data() + begin;
+    Put<uint32_t>(h + 4, static_cast<uint32_t>(n));
+    for (int k = 0; k < 4; ++k)
+        Put<uint32_t>(h + 8 + 4 * k, static_cast<uint32_t>(cols[k].size()));
+    Put<int64_t>(h + 24, c[0].at);
+    Put<int64_t>(h + 32, c[n - 1].at);
+    Put<int64_t>(h + 40, c[0].oldOffset);
+    Put<int64_t>(h + 48, stats.sum);
+    Put<int64_t>(h + 56, stats.sumAbs);
+    Put<int64_t>(h + 64, stats.min);
+    Put<int64_t>(h + 72, stats.max);
+    uint8_t* p = h + CORRECTION_BLOCK_HEADER;
+    for (const auto& col : cols)
+    {
+        if (!col.empty()) std::memcpy(p, col.data(), col.size());
+        p += col.size();
+    }
+    Put<uint32_t>(h, Crc32(h + 4, size - 4));
+    return size;
+}
+
+// Распаковка блока: fn(const Correction&) для каждой записи по порядку;
+// fn возвращает false, чтобы остановиться. Каждая колонка читается не
+// дальше своего конца; false — колонка кончилась раньше записей
+template <typename F>
+static bool DecodeBlock(const uint8_t* h, F&& fn)
+{
+    size_t n = Get<uint32_t>(h + 4);
+    const uint8_t* col[4];
+    const uint8_t* end[4];
+    col[0] = h + CORRECTION_BLOCK_HEADER;
+    for (int k = 0; k < 4; ++k)
+    {
+        end[k] = col[k] + Get<uint32_t>(h + 8 + 4 * k);
+        if (k < 3) col[k + 1] = end[k];
+    }
+
+    Correction c;
+    c.at = Get<int64_t>(h + 24);
+    c.newOffset = Get<int64_t>(h + 40);
+    for (size_t i = 0; i < n; ++i)
+    {
+        int64_t dAt, dOld, shift, source;
+        if (!GetVarint(col[0], end[0], &dAt) || !GetVarint(col[1], end[1], &dOld) ||
+            !GetVarint(col[2], end[2], &shift) || !GetVarint(col[3], end[3], &source))
+            return false;
+        c.at += dAt;
+        c.oldOffset = c.newOffset + dOld;
+        c.newOffset = c.oldOffset + shift;
+        c.source = static_cast<uint16_t>(source);
+        if (!fn(c)) return true;
+    }
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+// CorrectionReader
+// -----------------------------------------------------------------------------
+bool CorrectionReader::Open(const NativePath& path)
+{
+    m_blocks.clear();
+    m_records = m_validBytes = 0;
+    if (!m_file.Open(path)) return false;
+    Attach(m_file.Data(), m_file.Size());
+    return true;
+}
+
+void CorrectionReader::Attach(const uint8_t* data, size_t size)
+{
+    m_blocks.clear();
+    m_records = m_validBytes = m_corrupt = 0;
+    if (size < CORRECTION_HEADER_SIZE || Get<uint32_t>(data) != CORRECTION_FILE_MAGIC ||
+        Get<uint32_t>(data + 4) != CORRECTION_FILE_VERSION)
+        return;
+
+    // Блоки идут подряд, по заголовкам; сумма проверяется у каждого: сводки
+    // из заголовка берутся без распаковки, и им надо верить. Испорченный блок
+    // в середине пропускается, последний — оборванная перезапись, файл
+    // обрезается до его начала
+    size_t pos = CORRECTION_HEADER_SIZE;
+    const uint8_t* bad = nullptr;
+    while (size - pos >= CORRECTION_BLOCK_HEADER)
+    {
+        const uint8_t* h = data + pos;
+        size_t n = Get<uint32_t>(h + 4);
+        uint64_t bytes = CORRECTION_BLOCK_HEADER;
+        for (int k = 0; k < 4; ++k) bytes += Get<uint32_t>(h + 8 + 4 * k);
+        if (n == 0 || n > CORRECTION_BLOCK_RECORDS || bytes > size - pos)
+            break;
+        pos += static_cast<size_t>(bytes);
+        bad = Get<uint32_t>(h) != Crc32(h + 4, static_cast<size_t>(bytes) - 4) ? h : nullptr;
+        if (bad)
+        {
+            ++m_corrupt;
+            continue;
+        }
+
+        Block b;
+        b.data = h;
+        b.count = n;
+        b.firstAt = Get<int64_t>(h + 24);
+        b.lastAt = Get<int64_t>(h + 32);
+        b.stats.count = n;
+        b.stats.sum = Get<int64_t>(h + 48);
+        b.stats.sumAbs = Get<int64_t>(h + 56);
+        b.stats.min = Get<int64_t>(h + 64);
+        b.stats.max = Get<int64_t>(h + 72);
+        m_blocks.push_back(b);
+        m_records += n;
+    }
+    if (bad)
+    {
+        --m_corrupt;
+        pos = static_cast<size_t>(bad - data);
+    }
+    m_validBytes = pos;
+}
+
+template <typename F>
+void CorrectionReader::Scan(int64_t from, int64_t to, F&& fn) const
+{
+    // Моменты не убывают, так что первый нужный блок ищется двоичным поиском
+    auto it = std::lower_bound(m_blocks.begin(), m_blocks.end(), from,
+                               [](const Block& b, int64_t t) { return b.lastAt < t; });
+    for (; it != m_blocks.end() && it->firstAt < to; ++it)
+    {
+        if (it->firstAt >= from && it->lastAt < to && fn(*it, nullptr)) continue;
+        DecodeBlock(it->data, [&](const Correction& c) {
+            if (c.at >= to) return false;
+            if (c.at >= from) fn(*it, &c);
+            return true;
+        });
+    }
+}
+
+void CorrectionReader::Range(int64_t from, int64_t to, std::vector<Correction>* out) const
+{
+    out->clear();
+    Scan(from, to, [&](const Block&, const Correction* c) {
+        if (c) out->push_back(*c);
+        return false;
+    });
+}
+
+CorrectionStats CorrectionReader::Aggregate(int64_t from, int64_t to) const
+{
+    // Блок целиком внутри интервала берётся из заголовка без распаковки
+    CorrectionStats s;
+    Scan(from, to, [&](const Block& b, const Correction* c) {
+        if (c) s.Add(c->Shift());
+        else s.Merge(b.stats);
+        return true;
+    });
+    return s;
+}
+
+void CorrectionReader::Buckets(int64_t from, int64_t to, int64_t width,
+                               std::vector<CorrectionStats>* out) const
+{
+    out->clear();
+    if (to <= from || width <= 0) return;
+    out->resize(static_cast<size_t>((to - from + width - 1) / width));
+    Scan(from, to, [&](const Block& b, const Correction* c) {
+        if (c)
+        {
+            (*out)[static_cast<size_t>((c->at - from) / width)].Add(c->Shift());
+            return true;
+        }
+        // Блок в пределах одной корзины — сводка из заголовка
+        size_t i = static_cast<size_t>((b.firstAt - from) / width);
+        if (i != static_cast<size_t>((b.lastAt - from) / width)) return false;
+        (*out)[i].Merge(b.stats);
+        return true;
+    });
+}
+
+// -----------------------------------------------------------------------------
+// CorrectionHistory
+// -----------------------------------------------------------------------------
+bool CorrectionHistory::Open(const NativePath& path)
+{
+    Close();
+    m_records = 0;
+    m_lastAt = INT64_MIN;
+    uint64_t valid = 0, fileSize = 0;
+    {
+        // Отображение закрывается до того, как файл будет обрезан
+        CorrectionReader r;
+        if (r.Open(path))
+        {
+            valid = r.ValidBytes();
+            fileSize = r.m_file.Size();
+            m_records = r.Size();
+            m_tailPos = valid;
+            if (!r.m_blocks.empty())
+            {
+                const CorrectionReader::Block& last = r.m_blocks.back();
+                m_lastAt = last.lastAt;
+                if (last.count < CORRECTION_BLOCK_RECORDS)
+                {
+                    m_tailPos = static_cast<uint64_t>(last.data - r.m_file.Data());
+                    bool ok = DecodeBlock(last.data, [&](const Correction& c) {
+                        m_tail.push_back(c);
+                        return true;
+                    });
+                    if (!ok)
+                    {
+                        // Не дописываем в блок, который не читается: следующий — новый
+                        m_tail.clear();
+                        m_tailPos = valid;
+                    }
+                }
+            }
+        }
+    }
+
+    if (valid < CORRECTION_HEADER_SIZE)
+    {
+        // Нет файла или чужой формат — начинаем заново
+        uint8_t h[CORRECTION_HEADER_SIZE] = {};
+        Put<uint32_t>(h, CORRECTION_FILE_MAGIC);
+        Put<uint32_t>(h + 4, CORRECTION_FILE_VERSION);
+        m_tail.clear();
+        m_tailPos = CORRECTION_HEADER_SIZE;
+        return m_file.Open(path, true) && m_file.Write(h, sizeof(h));
+    }
+    if (!m_file.Open(path, false)) return false;
+    return valid == fileSize || m_file.Truncate(valid);
+}
+
+bool CorrectionHistory::Append(const Correction& c, bool sync)
+{
+    if (!m_file.IsOpen()) return false;
+    m_tail.push_back(c);
+    m_tail.back().at = std::max(c.at, m_lastAt);
+
+    m_image.clear();
+    size_t size = EncodeCorrectionBlock(m_tail.data(), m_tail.size(), &m_image);
+    if (!m_file.Truncate(m_tailPos) || !m_file.Write(m_image.data(), size) ||
+        (sync && !m_file.Sync()))
+    {
+        m_tail.pop_back();
+        return false;
+    }
+    m_lastAt = m_tail.back().at;
+    ++m_records;
+    if (m_tail.size() == CORRECTION_BLOCK_RECORDS)
+    {
+        m_tailPos += size;
+        m_tail.clear();
+    }
+    return true;
+}
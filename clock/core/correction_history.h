@@ -0,0 +1,138 @@
+#pragma once
+// -----------------------------------------------------------------------------
+// История поправок игровых часов.
+//
+// Каждая поправка ("Установить время", подхват чужих часов) — это реальный
+// момент, смещение до и после и источник. Смещение здесь — фаза игрового
+// времени относительно реального: игровые тики в номинальном масштабе минус
+// at, по модулю игровых суток. Пока скорость номинальная, между поправками
+// она постоянна, так что соседние записи почти совпадают.
+//
+// Файл: заголовок 16 байт ("WRCH", версия) и блоки до 1024 записей:
+//   crc32 u32 | count u32 | длины колонок u32 x4 |
+//   firstAt i64 | lastAt i64 | firstOld i64 | sum i64 | sumAbs i64 | min i64 | max i64 |
+//   колонки: at, old, new, source
+// Колонки хранят разности в zigzag-varint: at — от предыдущего момента, old —
+// от предыдущего new, new — от old (сама поправка). Сводка в заголовке блока
+// позволяет считать агрегаты по целым блокам, не распаковывая их. Пишется
+// только последний блок: он переписывается целиком на каждую новую запись.
+// При открытии проверяется сумма каждого блока: испорченный блок в середине
+// пропускается (его записи теряются, соседние читаются), а испорченный
+// последний считается оборванной перезаписью, и файл обрезается до его начала.
+// -----------------------------------------------------------------------------
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "file_io.h"
+#include "game_time.h"
+
+enum CorrectionSource : uint16_t {
+    CORRECTION_DIALOG = 1,   // "Установить время"
+    CORRECTION_FOLLOW = 2,   // состояние пришло от другого процесса
+    CORRECTION_AUTO   = 3,   // автоматическая подстройка
+};
+
+struct Correction {
+    int64_t  at        = 0;   // реальный момент (тики FILETIME)
+    int64_t  oldOffset = 0;   // фаза до поправки (тики)
+    int64_t  newOffset = 0;   // фаза после
+    uint16_t source    = CORRECTION_DIALOG;
+
+    int64_t Shift() const { return newOffset - oldOffset; }
+};
+
+// Поправка при переходе часов из before в after в момент at. Целые игровые
+// сутки отбрасываются: перевод 23:58 -> 00:05 — это +7 минут, а не -23:53.
+// Фазы пересчитываются к номинальной длине минуты, так что из newOffset
+// можно точно восстановить показанную минуту суток, какой бы ни была
+// скорость часов.
+Correction MakeCorrection(int64_t at, const GameClockState& before,
+                          const GameClockState& after, uint16_t source,
+                          int64_t nominalTicksPerMinute = GAME_MINUTE_TICKS);
+
+// Сводка по поправкам (Shift) за интервал
+struct CorrectionStats {
+    size_t  count  = 0;
+    int64_t sum    = 0;          // суммарный сдвиг, тики
+    int64_t sumAbs = 0;
+    int64_t min    = INT64_MAX;
+    int64_t max    = INT64_MIN;
+
+    void Add(int64_t shift);
+    void Merge(const CorrectionStats& s);
+};
+
+// Средний уход часов за реальные сутки на интервале [from, to), тики
+double DriftPerDay(const CorrectionStats& s, int64_t from, int64_t to);
+
+const uint32_t CORRECTION_FILE_MAGIC    = 0x48435257;   // "WRCH"
+const uint32_t CORRECTION_FILE_VERSION  = 1;
+const size_t   CORRECTION_HEADER_SIZE   = 16;
+const size_t   CORRECTION_BLOCK_HEADER  = 80;
+const size_t   CORRECTION_BLOCK_RECORDS = 1024;
+
+// Чтение: файл отображается в память, при открытии читаются только
+// заголовки блоков; колонки распаковываются для блоков, попавших в запрос
+class CorrectionReader {
+public:
+    bool Open(const NativePath& path);
+    // Разбор образа в памяти (данные должны жить, пока жив читатель)
+    void Attach(const uint8_t* data, size_t size);
+
+    size_t  Size() const { return m_records; }
+    size_t  Blocks() const { return m_blocks.size(); }
+    size_t  ValidBytes() const { return m_validBytes; }   // длина целой части
+    size_t  CorruptBlocks() const { return m_corrupt; }   // пропущено из середины
+    int64_t FirstAt() const { return m_blocks.empty() ? 0 : m_blocks.front().firstAt; }
+    int64_t LastAt() const { return m_blocks.empty() ? 0 : m_blocks.back().lastAt; }
+
+    // Поправки с at в [from, to) по возрастанию времени
+    void Range(int64_t from, int64_t to, std::vector<Correction>* out) const;
+    CorrectionStats Aggregate(int64_t from, int64_t to) const;
+    // Сводки по корзинам [from + i*width, from + (i+1)*width), i < out->size() после вызова
+    void Buckets(int64_t from, int64_t to, int64_t width, std::vector<CorrectionStats>* out) const;
+
+private:
+    friend class CorrectionHistory;
+
+    struct Block {
+        const uint8_t*  data;    // начало блока
+        size_t          count;
+        int64_t         firstAt;
+        int64_t         lastAt;
+        CorrectionStats stats;
+    };
+
+    template <typename F>
+    void Scan(int64_t from, int64_t to, F&& fn) const;
+
+    MappedFile         m_file;
+    std::vector<Block> m_blocks;
+    size_t             m_records = 0;
+    size_t             m_validBytes = 0;
+    size_t             m_corrupt = 0;
+};
+
+// Запись: дописывает поправки в последний блок
+class CorrectionHistory {
+public:
+    // Открывает историю на дозапись, отрезая повреждённый хвост
+    bool Open(const NativePath& path);
+    void Close() { m_file.Close(); m_tail.clear(); }
+    bool IsOpen() const { return m_file.IsOpen(); }
+
+    // Моменты должны не убывать; более ранний подтягивается к последнему
+    bool Append(const Correction& c, bool sync = true);
+    size_t Records() const { return m_records; }
+
+private:
+    OutputFile              m_file;
+    std::vector<Correction> m_tail;         // записи последнего неполного блока
+    std::vector<uint8_t>    m_image;
+    uint64_t                m_tailPos = 0;  // где этот блок начинается в файле
+    int64_t                 m_lastAt = INT64_MIN;
+    size_t                  m_records = 0;
+};
+
+// Дописывает в out готовый блок из n записей (бенчмарк, утилиты); возвращает его размер
+size_t EncodeCorrectionBlock(const Correction* c, size_t n, std::vector<uint8_t>* out);
@@ -0,0 +1,26 @@
+#include "crc32.h"
+
+struct Crc32Table {
+    uint32_t t[256];
+    constexpr Crc32Table() : t()
+    {
+        for (uint32_t i = 0; i < 256; ++i)
+        {
+            uint32_t c = i;
+            for (int k = 0; k < 8; ++k)
+                c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            t[i] = c;
+        }
+    }
+};
+
+static constexpr Crc32Table CRC_TABLE;
+
+uint32_t Crc32(const void* data, size_t size, uint32_t crc)
+{
+    const uint8_t* p = static_cast<const uint8_t*>(data);
+    crc = ~crc;
+    for (size_t i = 0; i < size; ++i)
+        crc = CRC_TABLE.t[(crc ^ p[i]) & 0xFF] ^ (crc >> 8);
+    return ~crc;
+}
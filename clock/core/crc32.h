@@ -0,0 +1,6 @@
+#pragma once
+// CRC-32 (IEEE 802.3, как в zlib) для контрольных сумм записей на диске
+#include <cstddef>
+#include <cstdint>
+
+uint32_t Crc32(const void* data, size_t size, uint32_t crc = 0);
@@ -0,0 +1,363 @@
+#include "drift_estimator.h"
+#include <algorithm>
+#include <cmath>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define WRCLOCK_X86 1
+#include <immintrin.h>
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define WRCLOCK_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define WRCLOCK_TARGET_AVX2
+#endif
+
+static const double DAY_SECONDS = 86400.0;
+
+// Векторный путь переводит разность тиков в double через 2^52: она должна
+// быть меньше 2^51 (около семи лет)
+static const int64_t SIMD_WINDOW = int64_t(1) << 50;
+
+int64_t DriftFit::TicksPerMinute() const
+{
+    return static_cast<int64_t>(std::llround(double(TICKS_PER_SECOND) / minutesPerSecond));
+}
+
+DriftFit FitFromSums(const DriftSums& s, const DriftOptions& o)
+{
+    DriftFit f;
+    double nominal = double(TICKS_PER_SECOND) / double(o.nominalTicksPerMinute);
+    f.at = s.refAt;
+    f.minute = s.refMinute;
+    f.minutesPerSecond = nominal;
+    f.weight = s.w;
+    if (s.w <= 0) return f;
+
+    double mx = s.x / s.w, my = s.y / s.w;
+    double cxx = std::max(0.0, s.xx / s.w - mx * mx);
+    double cxy = s.xy / s.w - mx * my;
+    double cyy = std::max(0.0, s.yy / s.w - my * my);
+
+    double span = o.minSpanHours * 3600.0;
+    double b = nominal;
+    if (cxx >= span * span)
+    {
+        double fitted = cxy / cxx;
+        if (std::fabs(fitted / nominal - 1.0) <= o.maxRateError)
+        {
+            b = fitted;
+            f.rateFitted = true;
+        }
+    }
+    f.minutesPerSecond = b;
+    f.minute = s.refMinute + my - b * mx;
+    f.sigma = std::sqrt(std::max(0.0, cyy - 2 * b * cxy + b * b * cxx));
+    return f;
+}
+
+// -----------------------------------------------------------------------------
+// DriftEstimator
+// -----------------------------------------------------------------------------
+DriftEstimator::DriftEstimator(const DriftOptions& o) : m_opt(o)
+{
+    Reset();
+}
+
+void DriftEstimator::Reset()
+{
+    m_sums = DriftSums();
+    m_fit = FitFromSums(m_sums, m_opt);
+    m_streak = 0;
+}
+
+void DriftEstimator::Restore(const DriftSums& s)
+{
+    m_sums = s;
+    m_fit = FitFromSums(m_sums, m_opt);
+    m_streak = 0;
+}
+
+DriftVerdict DriftEstimator::Observe(int64_t at, double minute)
+{
+    DriftVerdict verdict = DriftVerdict::Accepted;
+    if (m_sums.w > 0)
+    {
+        double dt = std::max(0.0, double(at - m_sums.refAt) / double(TICKS_PER_SECOND));
+        double residual = std::fabs(minute - m_fit.Predict(at));
+        // Пока скорость не подобрана, прогноз может уйти на maxRateError
+        double limit = m_fit.rateFitted
+            ? std::max(m_opt.outlierMinutes, 4 * m_fit.sigma)
+            : m_opt.outlierMinutes + m_opt.maxRateError * dt * m_fit.minutesPerSecond;
+        if (residual > limit)
+        {
+            ++m_outliers;
+            if (m_fit.rateFitted && ++m_streak < m_opt.restartAfter)
+                return DriftVerdict::Outlier;
+            // Часы в игре переставили — прежние наблюдения больше не о том
+            m_sums = DriftSums();
+            verdict = DriftVerdict::Restarted;
+        }
+    }
+
+    if (m_sums.w > 0)
+    {
+        // Перенос начала координат в новое наблюдение и старение сумм
+        DriftSums& s = m_sums;
+        double dx = std::max(0.0, double(at - s.refAt) / double(TICKS_PER_SECOND));
+        double dy = minute - s.refMinute;
+        double xx = s.xx - 2 * dx * s.x + dx * dx * s.w;
+        double xy = s.xy - dx * s.y - dy * s.x + dx * dy * s.w;
+        double yy = s.yy - 2 * dy * s.y + dy * dy * s.w;
+        double f = std::exp2(-dx / (m_opt.halfLifeDays * DAY_SECONDS));
+        s.x  = (s.x - dx * s.w) * f;
+        s.y  = (s.y - dy * s.w) * f;
+        s.xx = xx * f;
+        s.xy = xy * f;
+        s.yy = yy * f;
+        s.w *= f;
+    }
+    m_sums.refAt = std::max(at, m_sums.refAt);
+    m_sums.refMinute = minute;
+    m_sums.w += 1;
+    m_fit = FitFromSums(m_sums, m_opt);
+    m_streak = 0;
+    ++m_accepted;
+    return verdict;
+}
+
+// -----------------------------------------------------------------------------
+// Пакетная подгонка
+// -----------------------------------------------------------------------------
+namespace {
+
+struct Accumulator {
+    int64_t ref;          // момент, на который считаются веса
+    double  refMinute;
+    double  decay;        // 1 / период полураспада, 1/с
+    bool    reject;       // второй проход: отбрасывать далёкие от прямой
+    double  a, b, limit;
+    double  sum[6];       // w, x, y, xx, xy, yy
+};
+
+}
+
+static void AccumulateScalar(const int64_t* at, const double* minute, size_t first, size_t last,
+                             Accumulator& acc)
+{
+    double w0 = 0, x0 = 0, y0 = 0, xx = 0, xy = 0, yy = 0;
+    for (size_t i = first; i < last; ++i)
+    {
+        double x = double(at[i] - acc.ref) / double(TICKS_PER_SECOND);
+        double y = minute[i] - acc.refMinute;
+        double w = std::exp2(std::max(x * acc.decay, -1000.0));
+        if (acc.reject && std::fabs(y - acc.a - acc.b * x) > acc.limit) w = 0;
+        w0 += w;
+        x0 += w * x;
+        y0 += w * y;
+        xx += w * x * x;
+        xy += w * x * y;
+        yy += w * y * y;
+    }
+    acc.sum[0] += w0; acc.sum[1] += x0; acc.sum[2] += y0;
+    acc.sum[3] += xx; acc.sum[4] += xy; acc.sum[5] += yy;
+}
+
+#if defined(WRCLOCK_X86)
+// 2^t для t <= 0: целая часть — прямо в показатель double, дробная —
+// многочлен Тейлора для e^(f ln 2) (ошибка около 1e-8)
+WRCLOCK_TARGET_AVX2
+static inline __m256d Exp2Pd(__m256d t)
+{
+    t = _mm256_max_pd(t, _mm256_set1_pd(-1000.0));
+    __m256d k = _mm256_floor_pd(t);
+    __m256d f = _mm256_sub_pd(t, k);
+
+    static const double C[10] = {
+        1.0, 0.6931471805599453, 0.2402265069591007, 0.05550410866482158,
+        0.009618129107628477, 0.0013333558146428443, 0.00015403530393381608,
+        1.525273380405984e-05, 1.3215486790144307e-06, 1.0178086009239699e-07,
+    };
+    __m256d p = _mm256_set1_pd(C[9]);
+    for (int i = 8; i >= 0; --i)
+        p = _mm256_add_pd(_mm256_mul_pd(p, f), _mm256_set1_pd(C[i]));
+
+    __m256i e = _mm256_cvtepi32_epi64(_mm256_cvtpd_epi32(k));
+    e = _mm256_slli_epi64(_mm256_add_epi64(e, _mm256_set1_epi64x(1023)), 52);
+    return _mm256_mul_pd(p, _mm256_castsi256_pd(e));
+}
+
+WRCLOCK_TARGET_AVX2
+static void AccumulateAvx2(const int64_t* at, const double* minute, size_t first, size_t last,
+                           Accumulator& acc)
+{
+    // int64 -> double без AVX-512: x + 1.5*2^52 в битах double и вычитание
+    const __m256i magicI = _mm256_castpd_si256(_mm256_set1_pd(6755399441055744.0));
+    const __m256d magicD = _mm256_set1_pd(6755399441055744.0);
+    const __m256i refV   = _mm256_set1_epi64x(acc.ref);
+    const __m256d invTps = _mm256_set1_pd(1.0 / double(TICKS_PER_SECOND));
+    const __m256d refMin = _mm256_set1_pd(acc.refMinute);
+    const __m256d decay  = _mm256_set1_pd(acc.decay);
+    const __m256d a      = _mm256_set1_pd(acc.a);
+    const __m256d b      = _mm256_set1_pd(acc.b);
+    const __m256d limit  = _mm256_set1_pd(acc.reject ? acc.limit : INFINITY);
+    const __m256d absMask = _mm256_castsi256_pd(_mm256_set1_epi64x(0x7FFFFFFFFFFFFFFFLL));
+
+    __m256d sw = _mm256_setzero_pd(), sx = sw, sy = sw, sxx = sw, sxy = sw, syy = sw;
+    size_t i = first;
+    for (; i + 4 <= last; i += 4)
+    {
+        __m256i d = _mm256_sub_epi64(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(at + i)), refV);
+        __m256d x = _mm256_mul_pd(_mm256_sub_pd(_mm256_castsi256_pd(_mm256_add_epi64(d, magicI)), magicD), invTps);
+        __m256d y = _mm256_sub_pd(_mm256_loadu_pd(minute + i), refMin);
+        __m256d w = Exp2Pd(_mm256_mul_pd(x, decay));
+
+        __m256d r = _mm256_and_pd(_mm256_sub_pd(y, _mm256_add_pd(a, _mm256_mul_pd(b, x))), absMask);
+        w = _mm256_and_pd(w, _mm256_cmp_pd(r, limit, _CMP_LE_OQ));
+
+        __m256d wx = _mm256_mul_pd(w, x);
+        __m256d wy = _mm256_mul_pd(w, y);
+        sw  = _mm256_add_pd(sw, w);
+        sx  = _mm256_add_pd(sx, wx);
+        sy  = _mm256_add_pd(sy, wy);
+        sxx = _mm256_add_pd(sxx, _mm256_mul_pd(wx, x));
+        sxy = _mm256_add_pd(sxy, _mm256_mul_pd(wx, y));
+        syy = _mm256_add_pd(syy, _mm256_mul_pd(wy, y));
+    }
+
+    __m256d v[6] = { sw, sx, sy, sxx, sxy, syy };
+    for (int k = 0; k < 6; ++k)
+    {
+        double lanes[4];
+        _mm256_storeu_pd(lanes, v[k]);
+        acc.sum[k] += (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+    }
+    AccumulateScalar(at, minute, i, last, acc);
+}
+#else
+static void AccumulateAvx2(const int64_t* at, const double* minute, size_t first, size_t last,
+                           Accumulator& acc)
+{
+    AccumulateScalar(at, minute, first, last, acc);
+}
+#endif
+
+DriftFit FitDriftBatch(const int64_t* at, const double* minute, size_t n, int64_t now,
+                       const DriftOptions& o, DriftSums* sums, SimdPath path)
+{
+    DriftSums s;
+    s.refAt = now;
+    if (!n)
+    {
+        if (sums) *sums = s;
+        return FitFromSums(s, o);
+    }
+    s.refMinute = minute[n - 1];
+
+    static const bool hasAvx2 = CpuHasAvx2();
+    bool inWindow = now - at[0] < SIMD_WINDOW && at[n - 1] - now < SIMD_WINDOW;
+    bool avx2 = (path == SimdPath::Avx2 || (path == SimdPath::Auto && hasAvx2)) && hasAvx2 && inWindow;
+
+    Accumulator acc = {};
+    acc.ref = now;
+    acc.refMinute = s.refMinute;
+    acc.decay = 1.0 / (o.halfLifeDays * DAY_SECONDS);
+    DriftFit fit;
+    for (int pass = 0; pass < 2; ++pass)
+    {
+        std::fill(acc.sum, acc.sum + 6, 0.0);
+        if (avx2) AccumulateAvx2(at, minute, 0, n, acc);
+        else AccumulateScalar(at, minute, 0, n, acc);
+        s.w = acc.sum[0]; s.x = acc.sum[1]; s.y = acc.sum[2];
+        s.xx = acc.sum[3]; s.xy = acc.sum[4]; s.yy = acc.sum[5];
+        fit = FitFromSums(s, o);
+
+        // Прямая первого прохода в координатах сумм: y = a + b x
+        acc.reject = true;
+        acc.b = fit.minutesPerSecond;
+        acc.a = fit.minute - s.refMinute;
+        acc.limit = std::max(o.outlierMinutes, 4 * fit.sigma);
+    }
+    if (sums) *sums = s;
+    return fit;
+}
+
+// -----------------------------------------------------------------------------
+// Связь с часами
+// -----------------------------------------------------------------------------
+double UnwrapMinuteOfDay(const GameClock& clock, int64_t at, int minuteOfDay)
+{
+    int64_t mpd = clock.State().minutesPerDay;
+    int64_t current = clock.GameMinute(at);
+    int64_t diff = FloorMod(minuteOfDay - FloorMod(current, mpd) + mpd / 2, mpd) - mpd / 2;
+    return double(current + diff) + 0.5;
+}
+
+void ApplyDriftFit(GameClock* clock, const DriftFit& fit, int64_t now, double observedMinute)
+{
+    double floorMinute = std::floor(observedMinute);
+    double minute = std::min(std::max(fit.Predict(now), floorMinute + 0.05), floorMinute + 0.95);
+    GameClockState s = clock->State();
+    s.ticksPerMinute = fit.TicksPerMinute();
+    s.start = now;
+    s.offset = static_cast<int64_t>(std::llround(minute * double(s.ticksPerMinute)));
+    clock->SetState(s);
+}
+
+void SnapToMinute(GameClock* clock, int64_t now, double observedMinute)
+{
+    GameClockState s = clock->State();
+    s.start = now;
+    s.offset = static_cast<int64_t>(std::floor(observedMinute)) * s.ticksPerMinute;
+    clock->SetState(s);
+}
+
+DriftVerdict ApplyObservation(DriftEstimator* estimator, GameClock* clock, int64_t now,
+                              int minuteOfDay)
+{
+    double observed = UnwrapMinuteOfDay(*clock, now, minuteOfDay);
+    DriftVerdict verdict = estimator->Observe(now, observed);
+    if (verdict == DriftVerdict::Accepted)
+        ApplyDriftFit(clock, estimator->Fit(), now, observed);
+    else
+        SnapToMinute(clock, now, observed);
+    return verdict;
+}
+
+size_t CollectDriftObservations(const CorrectionReader& r, const DriftOptions& o,
+                                int minutesPerDay, const GameClock* clock,
+                                std::vector<int64_t>* at, std::vector<double>* minute)
+{
+    at->clear();
+    minute->clear();
+    std::vector<Correction> cs;
+    r.Range(INT64_MIN, INT64_MAX, &cs);
+
+    // Минута суток после поправки восстанавливается по фазе; ApplyDriftFit
+    // держит её внутри минуты, запас при округлении — на пересчёт масштаба
+    double tpm = double(o.nominalTicksPerMinute);
+    double mpd = double(minutesPerDay);
+    int64_t dayTicks = o.nominalTicksPerMinute * minutesPerDay;
+    for (const Correction& c : cs)
+    {
+        if (c.source != CORRECTION_DIALOG) continue;
+        double v = double(FloorMod(c.at + c.newOffset, dayTicks)) / tpm;
+        double m = std::fmod(std::floor(v + 0.025), mpd) + 0.5;
+        if (!at->empty())
+        {
+            // Номер суток — ближайший к прогнозу по номинальной скорости
+            double predicted = minute->back() + double(c.at - at->back()) / tpm;
+            double d = m - predicted;
+            m = predicted + d - mpd * std::floor(d / mpd + 0.5);
+        }
+        at->push_back(c.at);
+        minute->push_back(m);
+    }
+    if (clock && !at->empty())
+    {
+        double shown = double(clock->GameMinute(at->back())) + 0.5;
+        double shift = mpd * std::floor((shown - minute->back()) / mpd + 0.5);
+        for (double& m : *minute) m += shift;
+    }
+    return at->size();
+}
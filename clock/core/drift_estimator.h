@@ -0,0 +1,111 @@
+#pragma once
+// -----------------------------------------------------------------------------
+// Подстройка скорости и фазы часов по наблюдениям.
+//
+// Каждый ввод времени в диалоге — это наблюдение: в реальный момент at в игре
+// была минута m. Прямая "игровая минута от реального времени" подбирается
+// взвешенным МНК по накопленным суммам: новое наблюдение обновляет их за
+// O(1), старые теряют вес вдвое за halfLifeDays. Наблюдение, далёкое от
+// прогноза, в подгонку не идёт; несколько таких подряд означают, что часы в
+// игре переставили, и подгонка начинается заново.
+//
+// Тот же расчёт есть пакетом (FitDriftBatch) — для пересборки по истории
+// поправок при запуске; векторный путь на AVX2 и скалярный запасной.
+// -----------------------------------------------------------------------------
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "clock_table.h"
+#include "correction_history.h"
+#include "game_time.h"
+
+struct DriftOptions {
+    int64_t nominalTicksPerMinute = GAME_MINUTE_TICKS;
+    double  halfLifeDays   = 14;     // за столько вес наблюдения падает вдвое
+    double  outlierMinutes = 3;      // дальше от прогноза — выброс (но не ближе 4 sigma)
+    double  minSpanHours   = 2;      // при меньшем разбросе моментов скорость номинальная
+    double  maxRateError   = 0.05;   // скорость дальше от номинальной не принимается
+    int     restartAfter   = 3;      // столько выбросов подряд — подгонка заново
+};
+
+// Подогнанная прямая: игровая минута (с дробной частью) от реального момента
+struct DriftFit {
+    int64_t at = 0;                  // опорный момент
+    double  minute = 0;              // игровая минута в этот момент
+    double  minutesPerSecond = double(TICKS_PER_SECOND) / double(GAME_MINUTE_TICKS);
+    double  sigma = 0;               // разброс остатков, минуты
+    double  weight = 0;              // суммарный вес наблюдений
+    bool    rateFitted = false;      // скорость подобрана, а не номинальная
+
+    double  Predict(int64_t t) const
+    {
+        return minute + minutesPerSecond * double(t - at) / double(TICKS_PER_SECOND);
+    }
+    int64_t TicksPerMinute() const;
+};
+
+// Взвешенные суммы относительно (refAt, refMinute); x — секунды, y — минуты
+struct DriftSums {
+    int64_t refAt = 0;
+    double  refMinute = 0;
+    double  w = 0, x = 0, y = 0, xx = 0, xy = 0, yy = 0;
+};
+
+DriftFit FitFromSums(const DriftSums& s, const DriftOptions& o);
+
+enum class DriftVerdict { Accepted, Outlier, Restarted };
+
+class DriftEstimator {
+public:
+    explicit DriftEstimator(const DriftOptions& o = DriftOptions());
+
+    void Reset();
+    // Суммы из пакетной подгонки (продолжение после запуска)
+    void Restore(const DriftSums& s);
+
+    // Моменты должны не убывать
+    DriftVerdict Observe(int64_t at, double minute);
+
+    const DriftFit&     Fit() const { return m_fit; }
+    const DriftSums&    Sums() const { return m_sums; }
+    const DriftOptions& Options() const { return m_opt; }
+    size_t Accepted() const { return m_accepted; }
+    size_t Outliers() const { return m_outliers; }
+
+private:
+    DriftOptions m_opt;
+    DriftSums    m_sums;
+    DriftFit     m_fit;
+    size_t       m_accepted = 0;
+    size_t       m_outliers = 0;
+    int          m_streak = 0;   // выбросов подряд
+};
+
+// Пакетная подгонка наблюдений, отсортированных по времени: тот же вес на
+// момент now, что у DriftEstimator, отбраковка выбросов вторым проходом
+DriftFit FitDriftBatch(const int64_t* at, const double* minute, size_t n, int64_t now,
+                       const DriftOptions& o = DriftOptions(), DriftSums* sums = nullptr,
+                       SimdPath path = SimdPath::Auto);
+
+// Введённая минута суток как непрерывная игровая минута (середина минуты),
+// ближайшая к показаниям часов
+double UnwrapMinuteOfDay(const GameClock& clock, int64_t at, int minuteOfDay);
+
+// Часы по подогнанной прямой: скорость из подгонки, фаза — прогноз на now,
+// но в пределах наблюдённой минуты, чтобы часы показали то, что ввели
+void ApplyDriftFit(GameClock* clock, const DriftFit& fit, int64_t now, double observedMinute);
+
+// Как SetGameTime, но номер игровых суток сохраняется: начало наблюдённой минуты
+void SnapToMinute(GameClock* clock, int64_t now, double observedMinute);
+
+// Ввод времени целиком: наблюдение в подгонку и перестановка часов (по
+// подгонке, а если ввод — выброс, то ровно на введённую минуту)
+DriftVerdict ApplyObservation(DriftEstimator* estimator, GameClock* clock, int64_t now,
+                              int minuteOfDay);
+
+// Наблюдения из поправок, сделанных в диалоге (фазы — в номинальном
+// масштабе o.nominalTicksPerMinute). Если задан clock, номера игровых суток
+// выравниваются по нему; иначе отсчёт с нулевых суток
+size_t CollectDriftObservations(const CorrectionReader& r, const DriftOptions& o,
+                                int minutesPerDay, const GameClock* clock,
+                                std::vector<int64_t>* at, std::vector<double>* minute);
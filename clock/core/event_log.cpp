@@ -0,0 +1,254 @@
+#include "event_log.h"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <vector>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
+template <typename T>
+static inline void Put(uint8_t* p, T v) { std::memcpy(p, &v, sizeof(T)); }
+
+static const char* const EVENT_FORMATS[LOG_EVENT_COUNT] = {
+    "Unknown event %lld %lld %lld %lld",
+    "Loaded game time from journal.",
+    "Loaded game time from INI settings.",
+    "No saved game time, using local time.",
+    "Game time saved.",
+    "Game time updated via dialog: %02lld:%02lld.",
+    "State journal cannot be opened.",
+    "Theme changed (dark=%lld).",
+    "Game time copied to clipboard (minute %lld).",
+    "Window minimized.",
+    "Window restored.",
+    "Clock rate fitted: %lld ticks per minute (verdict %lld).",
+    "Notification sound decoded in %lld us (%lld bytes PCM).",
+    "Notification resource cannot be decoded.",
+};
+
+const char* LogEventFormat(uint16_t event)
+{
+    return event < LOG_EVENT_COUNT ? EVENT_FORMATS[event] : EVENT_FORMATS[0];
+}
+
+int64_t LogNowNs()
+{
+    using namespace std::chrono;
+    return duration_cast<nanoseconds>(system_clock::now().time_since_epoch()).count();
+}
+
+static uint32_t CurrentThreadId()
+{
+#ifdef _WIN32
+    return GetCurrentThreadId();
+#else
+    return static_cast<uint32_t>(reinterpret_cast<uintptr_t>(pthread_self()));
+#endif
+}
+
+size_t FormatLogRecord(const LogRecord& r, char* out, size_t cap)
+{
+    // Разбор даты — самое дорогое; фоновый поток кэширует его на секунду
+    static thread_local int64_t cachedSec = INT64_MIN;
+    static thread_local char    cachedDate[64];
+
+    int64_t sec = r.ns >= 0 ? r.ns / 1000000000 : (r.ns + 1) / 1000000000 - 1;
+    int64_t frac = r.ns - sec * 1000000000;
+    if (sec != cachedSec)
+    {
+        time_t t = static_cast<time_t>(sec);
+        struct tm lt;
+#ifdef _WIN32
+        localtime_s(&lt, &t);
+#else
+        localtime_r(&t, &lt);
+#endif
+        std::snprintf(cachedDate, sizeof(cachedDate), "%04d-%02d-%02d %02d:%02d:%02d",
+                      lt.tm_year + 1900, lt.tm_mon + 1, lt.tm_mday,
+                      lt.tm_hour, lt.tm_min, lt.tm_sec);
+        cachedSec = sec;
+    }
+
+    int n = std::snprintf(out, cap, "%s.%09lld: ", cachedDate, static_cast<long long>(frac));
+    if (n < 0 || static_cast<size_t>(n) >= cap) return 0;
+    int m = std::snprintf(out + n, cap - n, LogEventFormat(r.event),
+                          static_cast<long long>(r.args[0]), static_cast<long long>(r.args[1]),
+                          static_cast<long long>(r.args[2]), static_cast<long long>(r.args[3]));
+    if (m < 0 || static_cast<size_t>(n + m) + 1 >= cap) return 0;
+    n += m;
+    out[n++] = '\n';
+    out[n] = 0;
+    return static_cast<size_t>(n);
+}
+
+// -----------------------------------------------------------------------------
+// EventLog: ограниченная MPSC-очередь (ячейки с номерами последовательности)
+// -----------------------------------------------------------------------------
+bool EventLog::Start(const NativePath& path, LogFormat format, LogPolicy policy, size_t capacity)
+{
+    Stop();
+    size_t cap = 64;
+    while (cap < capacity) cap <<= 1;
+
+    if (!m_file.Open(path, false)) return false;
+    if (format == LogFormat::Binary && m_file.Size() == 0)
+    {
+        uint8_t h[LOG_HEADER_SIZE] = {};
+        Put<uint32_t>(h, LOG_FILE_MAGIC);
+        Put<uint32_t>(h + 4, LOG_FILE_VERSION);
+        Put<uint32_t>(h + 8, sizeof(LogRecord));
+        m_file.Write(h, sizeof(h));
+    }
+
+    m_cells.reset(new Cell[cap]);
+    for (size_t i = 0; i < cap; ++i)
+        m_cells[i].seq.store(i, std::memory_order_relaxed);
+    m_mask = cap - 1;
+    m_head.store(0, std::memory_order_relaxed);
+    m_tail = 0;
+    m_format = format;
+    m_policy = policy;
+    m_stop = false;
+    m_running = true;
+    m_thread = std::thread(&EventLog::Run, this);
+    return true;
+}
+
+void EventLog::Stop()
+{
+    if (!m_thread.joinable()) return;
+    m_running = false;
+    m_stop = true;
+    Wake();
+    m_thread.join();
+    m_file.Close();
+}
+
+bool EventLog::Log(uint16_t event, int64_t a0, int64_t a1, int64_t a2, int64_t a3)
+{
+    if (!m_running.load(std::memory_order_relaxed)) return false;
+
+    uint64_t pos = m_head.load(std::memory_order_relaxed);
+    Cell* cell;
+    for (;;)
+    {
+        cell = &m_cells[pos & m_mask];
+        uint64_t seq = cell->seq.load(std::memory_order_acquire);
+        int64_t diff = static_cast<int64_t>(seq) - static_cast<int64_t>(pos);
+        if (diff == 0)
+        {
+            if (m_head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                break;
+        }
+        else if (diff < 0)
+        {
+            // Кольцо полно
+            if (m_policy == LogPolicy::Drop)
+            {
+                m_dropped.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            std::this_thread::yield();
+            pos = m_head.load(std::memory_order_relaxed);
+        }
+        else
+        {
+            pos = m_head.load(std::memory_order_relaxed);
+        }
+    }
+
+    LogRecord& r = cell->rec;
+    r.ns      = LogNowNs();
+    r.event   = event;
+    r.argc    = 4;
+    r.thread  = CurrentThreadId();
+    r.args[0] = a0;
+    r.args[1] = a1;
+    r.args[2] = a2;
+    r.args[3] = a3;
+    cell->seq.store(pos + 1, std::memory_order_release);
+    // Парная барьеру в Run: либо поток увидит запись, либо мы — что он спит
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (m_sleeping.load(std::memory_order_relaxed)) Wake();
+    return true;
+}
+
+void EventLog::Wake()
+{
+    std::lock_guard<std::mutex> lock(m_wakeMutex);
+    m_wakeup = true;
+    m_wakeCv.notify_one();
+}
+
+bool EventLog::Pending() const
+{
+    return m_cells[m_tail & m_mask].seq.load(std::memory_order_acquire) == m_tail + 1;
+}
+
+bool EventLog::Pop(LogRecord* r)
+{
+    Cell* cell = &m_cells[m_tail & m_mask];
+    if (cell->seq.load(std::memory_order_acquire) != m_tail + 1) return false;
+    *r = cell->rec;
+    cell->seq.store(m_tail + m_mask + 1, std::memory_order_release);
+    ++m_tail;
+    return true;
+}
+
+void EventLog::Run()
+{
+    std::vector<char> batch;
+    batch.reserve(64 * 1024);
+    char line[512];
+    LogRecord r;
+
+    for (;;)
+    {
+        bool stopping = m_stop.load(std::memory_order_acquire);
+        size_t count = 0;
+        while (batch.size() < 60 * 1024 && Pop(&r))
+        {
+            if (m_format == LogFormat::Binary)
+            {
+                const char* p = reinterpret_cast<const char*>(&r);
+                batch.insert(batch.end(), p, p + sizeof(r));
+            }
+            else if (size_t n = FormatLogRecord(r, line, sizeof(line)))
+            {
+                batch.insert(batch.end(), line, line + n);
+            }
+            ++count;
+        }
+        if (!batch.empty())
+        {
+            m_file.Write(batch.data(), batch.size());
+            m_written.fetch_add(count, std::memory_order_relaxed);
+            batch.clear();
+            continue;   // возможно, накопилось ещё
+        }
+        if (stopping) return;
+        // Кольцо пусто — спим до записи или Stop, без периодических пробуждений
+        std::unique_lock<std::mutex> lock(m_wakeMutex);
+        m_sleeping.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        bool woken = false;
+        if (!Pending() && !m_stop.load(std::memory_order_acquire))
+        {
+            m_wakeCv.wait(lock, [this] { return m_wakeup; });
+            woken = true;
+        }
+        m_wakeup = false;
+        m_sleeping.store(false, std::memory_order_relaxed);
+        // Разбудила запись — даём набежать пачке, как раньше при опросе;
+        // пока поток не спит, производители его не будят
+        if (woken && !m_stop.load(std::memory_order_acquire))
+            m_wakeCv.wait_for(lock, std::chrono::milliseconds(2),
+                              [this] { return m_stop.load(std::memory_order_acquire); });
+    }
+}
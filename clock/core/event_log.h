@@ -0,0 +1,109 @@
+#pragma once
+// -----------------------------------------------------------------------------
+// Асинхронный журнал событий.
+//
+// Вызов Log() кладёт запись фиксированного размера (время в нс, номер
+// события, до 4 целых аргументов) в кольцевой буфер без блокировок; текст
+// собирает фоновый поток и пишет пачками. Пока кольцо пусто, поток спит на
+// условной переменной; будит его только запись, заставшая его спящим. В двоичном режиме записи идут в
+// файл как есть и расшифровываются потом утилитой wrclock_logdecode.
+// -----------------------------------------------------------------------------
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include "file_io.h"
+
+// Номера событий хранятся в двоичных журналах — только дописывать в конец
+enum LogEvent : uint16_t {
+    LOG_GAME_TIME_LOADED = 1,   // из журнала состояния
+    LOG_GAME_TIME_INI,          // из старого gameclock.ini
+    LOG_GAME_TIME_LOCAL,        // сохранённого нет — местное время
+    LOG_GAME_TIME_SAVED,
+    LOG_GAME_TIME_SET,          // a0 = часы, a1 = минуты
+    LOG_JOURNAL_FAILED,
+    LOG_THEME_CHANGED,          // a0 = 1 — тёмная
+    LOG_COPIED,                 // a0 = минута суток
+    LOG_WINDOW_HIDDEN,
+    LOG_WINDOW_SHOWN,
+    LOG_DRIFT_FITTED,           // a0 = тиков в минуте, a1 = 1 — выброс, 2 — подгонка заново
+    LOG_SOUND_DECODED,          // a0 = мкс декодирования, a1 = байт PCM
+    LOG_SOUND_FAILED,           // ресурс уведомления не разобрался
+    LOG_EVENT_COUNT
+};
+
+// Формат printf для события: аргументы всегда передаются как long long
+const char* LogEventFormat(uint16_t event);
+
+struct LogRecord {
+    int64_t  ns;        // нс от 1970-01-01 UTC
+    uint16_t event;
+    uint16_t argc;
+    uint32_t thread;
+    int64_t  args[4];
+};
+static_assert(sizeof(LogRecord) == 48, "binary log layout");
+
+const uint32_t LOG_FILE_MAGIC   = 0x474C5257;   // "WRLG"
+const uint32_t LOG_FILE_VERSION = 1;
+const size_t   LOG_HEADER_SIZE  = 16;
+
+// "2025-03-11 18:42:59.123456789: текст\n"; возвращает длину (без нуля)
+size_t FormatLogRecord(const LogRecord& r, char* out, size_t cap);
+
+int64_t LogNowNs();
+
+enum class LogPolicy { Drop, Block };   // что делать, когда буфер полон
+enum class LogFormat { Text, Binary };
+
+class EventLog {
+public:
+    EventLog() = default;
+    ~EventLog() { Stop(); }
+    EventLog(const EventLog&) = delete;
+    EventLog& operator=(const EventLog&) = delete;
+
+    // capacity — число записей в кольце (округляется до степени двойки)
+    bool Start(const NativePath& path, LogFormat format = LogFormat::Text,
+               LogPolicy policy = LogPolicy::Drop, size_t capacity = 4096);
+    // Дописывает всё накопленное и останавливает поток
+    void Stop();
+
+    // Горячий путь; false — журнал не запущен или запись отброшена
+    bool Log(uint16_t event, int64_t a0 = 0, int64_t a1 = 0, int64_t a2 = 0, int64_t a3 = 0);
+
+    uint64_t Dropped() const { return m_dropped.load(std::memory_order_relaxed); }
+    uint64_t Written() const { return m_written.load(std::memory_order_relaxed); }
+
+private:
+    struct alignas(64) Cell {
+        std::atomic<uint64_t> seq;
+        LogRecord             rec;
+    };
+
+    bool Pop(LogRecord* r);
+    bool Pending() const;
+    void Wake();
+    void Run();
+
+    std::unique_ptr<Cell[]> m_cells;
+    size_t                  m_mask = 0;
+    LogPolicy               m_policy = LogPolicy::Drop;
+    LogFormat               m_format = LogFormat::Text;
+    OutputFile              m_file;
+    std::thread             m_thread;
+
+    alignas(64) std::atomic<uint64_t> m_head{ 0 };   // запись (производители)
+    alignas(64) uint64_t              m_tail = 0;    // чтение (фоновый поток)
+    std::atomic<bool>     m_running{ false };
+    std::atomic<bool>     m_stop{ false };
+    std::atomic<bool>     m_sleeping{ false };   // фоновый поток ждёт записей
+    std::mutex            m_wakeMutex;
+    std::condition_variable m_wakeCv;
+    bool                  m_wakeup = false;      // под m_wakeMutex
+    std::atomic<uint64_t> m_dropped{ 0 };
+    std::atomic<uint64_t> m_written{ 0 };
+};
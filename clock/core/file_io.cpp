@@ -0,0 +1,212 @@
+#include "file_io.h"
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <cstdio>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+// -----------------------------------------------------------------------------
+// Windows
+// -----------------------------------------------------------------------------
+bool MappedFile::Open(const NativePath& path)
+{
+    Close();
+    HANDLE f = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                           nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (f == INVALID_HANDLE_VALUE) return false;
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(f, &size)) { CloseHandle(f); return false; }
+    m_file = f;
+    m_size = static_cast<size_t>(size.QuadPart);
+    if (m_size == 0) return true;   // пустой файл отобразить нельзя, но это не ошибка
+    m_mapping = CreateFileMappingW(f, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (m_mapping)
+        m_data = static_cast<const uint8_t*>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+    if (!m_data) { Close(); return false; }
+    return true;
+}
+
+void MappedFile::Close()
+{
+    if (m_data) UnmapViewOfFile(m_data);
+    if (m_mapping) CloseHandle(m_mapping);
+    if (m_file) CloseHandle(m_file);
+    m_data = nullptr;
+    m_mapping = m_file = nullptr;
+    m_size = 0;
+}
+
+bool OutputFile::Open(const NativePath& path, bool truncate)
+{
+    Close();
+    HANDLE f = CreateFileW(path.c_str(), GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr,
+                           truncate ? CREATE_ALWAYS : OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (f == INVALID_HANDLE_VALUE) return false;
+    LARGE_INTEGER zero{};
+    SetFilePointerEx(f, zero, nullptr, FILE_END);
+    m_file = f;
+    return true;
+}
+
+void OutputFile::Close()
+{
+    if (m_file) CloseHandle(m_file);
+    m_file = nullptr;
+}
+
+bool OutputFile::IsOpen() const { return m_file != nullptr; }
+
+bool OutputFile::Write(const void* data, size_t size)
+{
+    const char* p = static_cast<const char*>(data);
+    while (size)
+    {
+        DWORD chunk = size > 0x40000000 ? 0x40000000 : static_cast<DWORD>(size), done = 0;
+        if (!WriteFile(m_file, p, chunk, &done, nullptr) || !done) return false;
+        p += done;
+        size -= done;
+    }
+    return true;
+}
+
+bool OutputFile::Sync() { return FlushFileBuffers(m_file) != 0; }
+
+bool OutputFile::Truncate(uint64_t size)
+{
+    LARGE_INTEGER pos;
+    pos.QuadPart = static_cast<LONGLONG>(size);
+    return SetFilePointerEx(m_file, pos, nullptr, FILE_BEGIN) && SetEndOfFile(m_file);
+}
+
+bool OutputFile::WriteAt(uint64_t offset, const void* data, size_t size)
+{
+    LARGE_INTEGER pos, zero{};
+    pos.QuadPart = static_cast<LONGLONG>(offset);
+    bool ok = SetFilePointerEx(m_file, pos, nullptr, FILE_BEGIN) && Write(data, size);
+    return SetFilePointerEx(m_file, zero, nullptr, FILE_END) && ok;
+}
+
+uint64_t OutputFile::Size() const
+{
+    LARGE_INTEGER size;
+    return GetFileSizeEx(m_file, &size) ? static_cast<uint64_t>(size.QuadPart) : 0;
+}
+
+bool ReplaceFileAtomic(const NativePath& from, const NativePath& to)
+{
+    return MoveFileExW(from.c_str(), to.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+}
+
+bool RemoveFile(const NativePath& path) { return DeleteFileW(path.c_str()) != 0; }
+
+#else
+// -----------------------------------------------------------------------------
+// POSIX
+// -----------------------------------------------------------------------------
+bool MappedFile::Open(const NativePath& path)
+{
+    Close();
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return false;
+    struct stat st;
+    if (fstat(fd, &st) != 0) { close(fd); return false; }
+    m_size = static_cast<size_t>(st.st_size);
+    if (m_size)
+    {
+        void* p = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p == MAP_FAILED) { close(fd); m_size = 0; return false; }
+        madvise(p, m_size, MADV_SEQUENTIAL);
+        m_data = static_cast<const uint8_t*>(p);
+    }
+    close(fd);
+    return true;
+}
+
+void MappedFile::Close()
+{
+    if (m_data) munmap(const_cast<uint8_t*>(m_data), m_size);
+    m_data = nullptr;
+    m_size = 0;
+}
+
+bool OutputFile::Open(const NativePath& path, bool truncate)
+{
+    Close();
+    m_fd = open(path.c_str(), O_WRONLY | O_CREAT | O_CLOEXEC | (truncate ? O_TRUNC : O_APPEND), 0644);
+    return m_fd >= 0;
+}
+
+void OutputFile::Close()
+{
+    if (m_fd >= 0) close(m_fd);
+    m_fd = -1;
+}
+
+bool OutputFile::IsOpen() const { return m_fd >= 0; }
+
+bool OutputFile::Write(const void* data, size_t size)
+{
+    const char* p = static_cast<const char*>(data);
+    while (size)
+    {
+        ssize_t n = write(m_fd, p, size);
+        if (n <= 0) return false;
+        p += n;
+        size -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+bool OutputFile::Sync() { return fdatasync(m_fd) == 0; }
+
+bool OutputFile::Truncate(uint64_t size)
+{
+    // С O_APPEND запись всё равно пойдёт в новый конец файла
+    return ftruncate(m_fd, static_cast<off_t>(size)) == 0 &&
+           lseek(m_fd, static_cast<off_t>(size), SEEK_SET) >= 0;
+}
+
+bool OutputFile::WriteAt(uint64_t offset, const void* data, size_t size)
+{
+    const char* p = static_cast<const char*>(data);
+    while (size)
+    {
+        ssize_t n = pwrite(m_fd, p, size, static_cast<off_t>(offset));
+        if (n <= 0) return false;
+        p += n;
+        offset += static_cast<uint64_t>(n);
+        size -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+uint64_t OutputFile::Size() const
+{
+    struct stat st;
+    return fstat(m_fd, &st) == 0 ? static_cast<uint64_t>(st.st_size) : 0;
+}
+
+bool ReplaceFileAtomic(const NativePath& from, const NativePath& to)
+{
+    if (std::rename(from.c_str(), to.c_str()) != 0) return false;
+    // Новое имя переживёт сбой питания, только когда на диске каталог
+    size_t slash = to.rfind('/');
+    NativePath dir = slash == NativePath::npos ? NativePath(".") : slash ? to.substr(0, slash) : NativePath("/");
+    int fd = open(dir.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (fd >= 0)
+    {
+        fsync(fd);
+        close(fd);
+    }
+    return true;
+}
+
+bool RemoveFile(const NativePath& path) { return unlink(path.c_str()) == 0; }
+#endif
@@ -0,0 +1,71 @@
+#pragma once
+// -----------------------------------------------------------------------------
+// Минимальная обёртка над файлами: отображение только для чтения, запись с
+// дозаписью в конец и атомарная замена файла. Пути — в родной кодировке ОС
+// (UTF-16 в Windows, байты в POSIX).
+// -----------------------------------------------------------------------------
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#ifdef _WIN32
+using NativePath = std::wstring;
+#else
+using NativePath = std::string;
+#endif
+
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile() { Close(); }
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool Open(const NativePath& path);
+    void Close();
+
+    const uint8_t* Data() const { return m_data; }
+    size_t         Size() const { return m_size; }
+
+private:
+    const uint8_t* m_data = nullptr;
+    size_t         m_size = 0;
+#ifdef _WIN32
+    void* m_file = nullptr;
+    void* m_mapping = nullptr;
+#endif
+};
+
+class OutputFile {
+public:
+    OutputFile() = default;
+    ~OutputFile() { Close(); }
+    OutputFile(const OutputFile&) = delete;
+    OutputFile& operator=(const OutputFile&) = delete;
+
+    // truncate = true — начать файл заново, иначе дописывать в конец
+    bool Open(const NativePath& path, bool truncate);
+    void Close();
+    bool IsOpen() const;
+
+    bool     Write(const void* data, size_t size);
+    bool     Sync();                    // сброс на диск (fsync/FlushFileBuffers)
+    bool     Truncate(uint64_t size);   // отрезать хвост и писать дальше с этого места
+    // Запись по смещению (например, размеры в заголовке после данных);
+    // дальнейший Write продолжает с конца файла. Только для файлов, открытых
+    // с truncate = true: в POSIX pwrite при O_APPEND пишет в конец
+    bool     WriteAt(uint64_t offset, const void* data, size_t size);
+    uint64_t Size() const;
+
+private:
+#ifdef _WIN32
+    void* m_file = nullptr;
+#else
+    int m_fd = -1;
+#endif
+};
+
+// Атомарно заменяет to файлом from (rename / MoveFileEx) и сбрасывает замену
+// на диск: fsync каталога / MOVEFILE_WRITE_THROUGH
+bool ReplaceFileAtomic(const NativePath& from, const NativePath& to);
+bool RemoveFile(const NativePath& path);
@@ -0,0 +1,287 @@
+#include "frame_stream.h"
+#include <algorithm>
+#include <cstring>
+#include "time_format.h"
+
+#ifndef _WIN32
+#include <cerrno>
+#include <unistd.h>
+#endif
+
+static const uint32_t RING_MAGIC   = 0x474E5257;   // "WRNG"
+static const uint32_t RING_VERSION = 1;
+
+static_assert(sizeof(FrameRingHeader) <= FRAME_RING_DATA_OFFSET, "ring header too large");
+
+template <typename T>
+static inline void Put(uint8_t* p, T v) { std::memcpy(p, &v, sizeof(T)); }
+
+template <typename T>
+static inline T Get(const uint8_t* p)
+{
+    T v;
+    std::memcpy(&v, p, sizeof(T));
+    return v;
+}
+
+// -----------------------------------------------------------------------------
+// OverlayRenderer
+// -----------------------------------------------------------------------------
+void OverlayRenderer::Setup(GlyphRasterizer* big, GlyphRasterizer* small, const Theme& theme, int width)
+{
+    m_atlas[0].Build(big, theme.text, theme.bg);
+    m_atlas[1].Build(small, theme.text, theme.bg);
+    int top = 0;
+    for (size_t r = 0; r < ROWS; ++r)
+    {
+        const GlyphAtlas* atlas = &m_atlas[r ? 1 : 0];
+        m_rows[r].SetAtlas(atlas);
+        m_rows[r].Resize(width, atlas->Height());
+        m_top[r] = top;
+        top += atlas->Height();
+    }
+    m_frame.Resize(width, top, m_atlas[0].Background());
+}
+
+void OverlayRenderer::Invalidate()
+{
+    for (ClockCompositor& c : m_rows)
+        c.Invalidate();
+}
+
+size_t OverlayRenderer::Render(const ClockView& view, PixelRect* damage, size_t cap)
+{
+    char text[ROWS][MMSS_MAX_LEN + 1];
+    size_t len[ROWS];
+    len[0] = static_cast<size_t>(AppendHHMM(text[0], view.minuteOfDay) - text[0]);
+    len[1] = static_cast<size_t>(AppendHHMM(text[1], view.minutesToMidnight) - text[1]);
+    len[2] = static_cast<size_t>(AppendMMSS(text[2], view.realSeconds) - text[2]);
+
+    size_t k = 0;
+    PixelRect rowDamage[MAX_CLOCK_CELLS];
+    for (size_t r = 0; r < ROWS; ++r)
+    {
+        size_t n = m_rows[r].Compose(text[r], len[r], rowDamage, MAX_CLOCK_CELLS);
+        const PixelBuffer& src = m_rows[r].Frame();
+        for (size_t i = 0; i < n; ++i)
+        {
+            PixelRect d = rowDamage[i];
+            for (int y = d.y; y < d.y + d.height; ++y)
+                std::memcpy(m_frame.Row(m_top[r] + y) + d.x, src.Row(y) + d.x,
+                            size_t(d.width) * sizeof(Pixel));
+            d.y += m_top[r];
+            if (k < cap)
+                damage[k++] = d;
+            else
+            {
+                // Места нет — последний прямоугольник растягивается на всё
+                PixelRect& u = damage[k - 1];
+                int x1 = std::max(u.x + u.width, d.x + d.width), y1 = std::max(u.y + u.height, d.y + d.height);
+                u.x = std::min(u.x, d.x);
+                u.y = std::min(u.y, d.y);
+                u.width = x1 - u.x;
+                u.height = y1 - u.y;
+            }
+        }
+    }
+    return k;
+}
+
+// -----------------------------------------------------------------------------
+// Сообщения
+// -----------------------------------------------------------------------------
+void EncodeFrame(const PixelBuffer& frame, const PixelRect* rects, size_t count, uint64_t number,
+                 int64_t at, bool key, std::vector<uint8_t>* out)
+{
+    PixelRect whole = { 0, 0, frame.width, frame.height };
+    if (key)
+    {
+        rects = &whole;
+        count = 1;
+    }
+    size_t bytes = sizeof(FrameHeader);
+    for (size_t i = 0; i < count; ++i)
+        bytes += FRAME_RECT_HEADER + size_t(rects[i].width) * size_t(rects[i].height) * sizeof(Pixel);
+    out->resize(bytes);
+
+    uint8_t* p = out->data();
+    FrameHeader h;
+    h.magic = FRAME_MAGIC;
+    h.flags = key ? FRAME_KEY : 0;
+    h.rects = static_cast<uint16_t>(count);
+    h.frame = number;
+    h.at = at;
+    h.width = static_cast<uint16_t>(frame.width);
+    h.height = static_cast<uint16_t>(frame.height);
+    h.bytes = static_cast<uint32_t>(bytes);
+    std::memcpy(p, &h, sizeof(h));
+    p += sizeof(h);
+    for (size_t i = 0; i < count; ++i)
+    {
+        const PixelRect& r = rects[i];
+        Put<uint16_t>(p, static_cast<uint16_t>(r.x));
+        Put<uint16_t>(p + 2, static_cast<uint16_t>(r.y));
+        Put<uint16_t>(p + 4, static_cast<uint16_t>(r.width));
+        Put<uint16_t>(p + 6, static_cast<uint16_t>(r.height));
+        p += FRAME_RECT_HEADER;
+        size_t row = size_t(r.width) * sizeof(Pixel);
+        for (int y = r.y; y < r.y + r.height; ++y, p += row)
+            std::memcpy(p, frame.Row(y) + r.x, row);
+    }
+}
+
+bool ApplyFrame(const uint8_t* data, size_t size, PixelBuffer* frame)
+{
+    FrameHeader h;
+    if (size < sizeof(h)) return false;
+    std::memcpy(&h, data, sizeof(h));
+    if (h.magic != FRAME_MAGIC || h.bytes != size) return false;
+    if (h.flags & FRAME_KEY)
+    {
+        if (frame->width != h.width || frame->height != h.height)
+            frame->Resize(h.width, h.height, 0);
+    }
+    else if (frame->width != h.width || frame->height != h.height)
+        return false;
+
+    const uint8_t* p = data + sizeof(h);
+    const uint8_t* end = data + size;
+    for (uint16_t i = 0; i < h.rects; ++i)
+    {
+        if (end - p < static_cast<ptrdiff_t>(FRAME_RECT_HEADER)) return false;
+        int x = Get<uint16_t>(p), y = Get<uint16_t>(p + 2);
+        int w = Get<uint16_t>(p + 4), rh = Get<uint16_t>(p + 6);
+        p += FRAME_RECT_HEADER;
+        size_t row = size_t(w) * sizeof(Pixel);
+        if (x + w > frame->width || y + rh > frame->height ||
+            static_cast<size_t>(end - p) < row * size_t(rh))
+            return false;
+        for (int yy = y; yy < y + rh; ++yy, p += row)
+            std::memcpy(frame->Row(yy) + x, p, row);
+    }
+    return p == end;
+}
+
+#ifndef _WIN32
+bool PipeFrameSink::Send(const uint8_t* data, size_t size)
+{
+    while (size)
+    {
+        ssize_t n = write(m_fd, data, size);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        data += n;
+        size -= static_cast<size_t>(n);
+    }
+    return true;
+}
+#endif
+
+// -----------------------------------------------------------------------------
+// FrameRing
+// -----------------------------------------------------------------------------
+static inline uint64_t Align8(uint64_t v) { return (v + 7) & ~uint64_t(7); }
+
+bool FrameRing::Open(const char* name, size_t capacity)
+{
+    size_t c = 4096;
+    while (c < capacity) c <<= 1;
+    if (!m_region.Open(name, true, FRAME_RING_DATA_OFFSET + c)) return false;
+    m_header = static_cast<FrameRingHeader*>(m_region.Data());
+    m_data = static_cast<uint8_t*>(m_region.Data()) + FRAME_RING_DATA_OFFSET;
+    m_capacity = c;
+    // Новый поток: читатели, увидев другую ёмкость или head, начнут сначала
+    m_header->magic.store(0, std::memory_order_relaxed);
+    m_header->capacity.store(c, std::memory_order_relaxed);
+    m_header->head.store(0, std::memory_order_relaxed);
+    m_header->reserve.store(0, std::memory_order_relaxed);
+    m_header->lastKey.store(UINT64_MAX, std::memory_order_relaxed);
+    m_header->version.store(RING_VERSION, std::memory_order_relaxed);
+    m_header->magic.store(RING_MAGIC, std::memory_order_release);
+    return true;
+}
+
+bool FrameRing::Send(const uint8_t* data, size_t size)
+{
+    uint64_t total = Align8(4 + size);
+    if (!m_header || total > m_capacity / 2) return false;
+    uint64_t head = m_header->head.load(std::memory_order_relaxed);
+
+    // Сначала объявляем, какие байты будут перезаписаны, потом пишем
+    uint64_t end = head + total;
+    m_header->reserve.store(end, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    uint8_t prefix[4];
+    Put<uint32_t>(prefix, static_cast<uint32_t>(size));
+    auto write = [&](uint64_t pos, const uint8_t* src, size_t n) {
+        size_t at = static_cast<size_t>(pos & (m_capacity - 1));
+        size_t first = std::min(n, static_cast<size_t>(m_capacity) - at);
+        std::memcpy(m_data + at, src, first);
+        std::memcpy(m_data, src + first, n - first);
+    };
+    write(head, prefix, 4);
+    write(head + 4, data, size);
+
+    if (size >= sizeof(FrameHeader) && (Get<uint16_t>(data + 4) & FRAME_KEY))
+        m_header->lastKey.store(head, std::memory_order_relaxed);
+    m_header->head.store(end, std::memory_order_release);
+    return true;
+}
+
+bool FrameRingReader::Open(const char* name)
+{
+    m_header = nullptr;
+    // Ёмкость известна только из заголовка
+    if (!m_region.Open(name, false, FRAME_RING_DATA_OFFSET)) return false;
+    const FrameRingHeader* h = static_cast<const FrameRingHeader*>(m_region.Data());
+    uint64_t capacity = h->magic.load(std::memory_order_acquire) == RING_MAGIC &&
+                        h->version.load(std::memory_order_relaxed) == RING_VERSION
+                        ? h->capacity.load(std::memory_order_relaxed) : 0;
+    m_region.Close();
+    if (!capacity || !m_region.Open(name, false, FRAME_RING_DATA_OFFSET + capacity)) return false;
+    m_header = static_cast<const FrameRingHeader*>(m_region.Data());
+    m_data = static_cast<const uint8_t*>(m_region.Data()) + FRAME_RING_DATA_OFFSET;
+    m_capacity = capacity;
+    m_synced = false;
+    return true;
+}
+
+bool FrameRingReader::Copy(uint64_t pos, void* dst, size_t size) const
+{
+    size_t at = static_cast<size_t>(pos & (m_capacity - 1));
+    size_t first = std::min(size, static_cast<size_t>(m_capacity) - at);
+    std::memcpy(dst, m_data + at, first);
+    std::memcpy(static_cast<uint8_t*>(dst) + first, m_data, size - first);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    // Писатель мог успеть перезаписать прочитанное
+    return m_header->reserve.load(std::memory_order_relaxed) - pos <= m_capacity;
+}
+
+bool FrameRingReader::Next(std::vector<uint8_t>* out)
+{
+    if (!m_header) return false;
+    uint64_t head = m_header->head.load(std::memory_order_acquire);
+    if (m_synced && (m_pos > head || head - m_pos > m_capacity))
+    {
+        ++m_overruns;
+        m_synced = false;
+    }
+    if (!m_synced)
+    {
+        uint64_t key = m_header->lastKey.load(std::memory_order_relaxed);
+        if (key == UINT64_MAX || key > head || head - key > m_capacity) return false;
+        m_pos = key;
+        m_synced = true;
+    }
+    if (m_pos == head) return false;
+
+    uint8_t prefix[4];
+    if (!Copy(m_pos, prefix, 4)) { m_synced = false; ++m_overruns; return false; }
+    uint32_t size = Get<uint32_t>(prefix);
+    if (Align8(4 + uint64_t(size)) > head - m_pos) { m_synced = false; return false; }
+    out->resize(size);
+    if (!Copy(m_pos + 4, out->data(), size)) { m_synced = false; ++m_overruns; return false; }
+    m_pos += Align8(4 + uint64_t(size));
+    return true;
+}
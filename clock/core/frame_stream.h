@@ -0,0 +1,145 @@
+#pragma once
+// -----------------------------------------------------------------------------
+// Кадры часов без окна — для оверлеев трансляций.
+//
+// OverlayRenderer рисует в буфер то же, что окно: время, остаток игровых
+// суток и реальное время до полуночи (только значения: подписи — дело сцены
+// оверлея, атлас содержит лишь цифры и ':'). Из кадра уходят только
+// прямоугольники изменений с их пикселями; ключевой кадр (весь буфер)
+// посылается первым и потом раз в заданный интервал, чтобы подключившийся
+// позже получатель мог начать с него.
+//
+// Сообщение кадра:
+//   FrameHeader, затем rects раз { x, y, width, height: u16 } и
+//   width * height пикселей 0xAARRGGBB построчно.
+// Транспорт — FrameSink: канал (pipe, stdout) или кольцо в разделяемой
+// памяти FrameRing, где писатель никогда не ждёт читателей.
+// -----------------------------------------------------------------------------
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "clock_shm.h"
+#include "clock_view.h"
+#include "glyph_atlas.h"
+
+const uint32_t FRAME_MAGIC = 0x4D465257;   // "WRFM"
+const uint16_t FRAME_KEY   = 1;            // кадр целиком, можно начинать с него
+
+struct FrameHeader {
+    uint32_t magic;
+    uint16_t flags;
+    uint16_t rects;
+    uint64_t frame;     // номер кадра
+    int64_t  at;        // момент кадра, тики FILETIME
+    uint16_t width;     // размер всего кадра
+    uint16_t height;
+    uint32_t bytes;     // длина сообщения вместе с заголовком
+};
+static_assert(sizeof(FrameHeader) == 32, "frame header layout");
+
+const size_t FRAME_RECT_HEADER = 8;
+
+// -----------------------------------------------------------------------------
+// Рисование
+// -----------------------------------------------------------------------------
+class OverlayRenderer {
+public:
+    // big — крупные часы, small — обе строки остатков; ширина кадра width
+    void Setup(GlyphRasterizer* big, GlyphRasterizer* small, const Theme& theme, int width);
+
+    // Рисует вид; пишет прямоугольники изменений в координатах кадра
+    size_t Render(const ClockView& view, PixelRect* damage, size_t cap);
+    // Следующий Render перерисует всё
+    void Invalidate();
+
+    const PixelBuffer& Frame() const { return m_frame; }
+
+private:
+    static const size_t ROWS = 3;
+
+    GlyphAtlas      m_atlas[2];
+    ClockCompositor m_rows[ROWS];
+    int             m_top[ROWS] = {};
+    PixelBuffer     m_frame;
+};
+
+// -----------------------------------------------------------------------------
+// Сообщения
+// -----------------------------------------------------------------------------
+// Собирает сообщение в out (буфер переиспользуется, в установившемся режиме
+// памяти не выделяет); key — весь кадр вместо rects
+void EncodeFrame(const PixelBuffer& frame, const PixelRect* rects, size_t count, uint64_t number,
+                 int64_t at, bool key, std::vector<uint8_t>* out);
+
+// Накладывает сообщение на frame (размер берётся из ключевого кадра);
+// false — сообщение повреждено или до первого ключевого кадра
+bool ApplyFrame(const uint8_t* data, size_t size, PixelBuffer* frame);
+
+// Куда уходят сообщения
+class FrameSink {
+public:
+    virtual ~FrameSink() = default;
+    virtual bool Send(const uint8_t* data, size_t size) = 0;
+};
+
+#ifndef _WIN32
+// Дескриптор файла или канала; запись целиком, с повтором после EINTR
+class PipeFrameSink : public FrameSink {
+public:
+    explicit PipeFrameSink(int fd) : m_fd(fd) {}
+    bool Send(const uint8_t* data, size_t size) override;
+
+private:
+    int m_fd;
+};
+#endif
+
+// -----------------------------------------------------------------------------
+// Кольцо в разделяемой памяти
+// -----------------------------------------------------------------------------
+struct FrameRingHeader {
+    std::atomic<uint32_t> magic;
+    std::atomic<uint32_t> version;
+    std::atomic<uint64_t> capacity;   // байт данных, степень двойки
+    std::atomic<uint64_t> head;       // всего записано байт
+    std::atomic<uint64_t> reserve;    // до куда писатель пишет сейчас (>= head)
+    std::atomic<uint64_t> lastKey;    // позиция последнего ключевого кадра
+};
+
+const size_t FRAME_RING_DATA_OFFSET = 64;
+const size_t FRAME_RING_DEFAULT_CAPACITY = size_t(4) << 20;
+
+class FrameRing : public FrameSink {
+public:
+    bool Open(const char* name, size_t capacity = FRAME_RING_DEFAULT_CAPACITY);
+    bool IsOpen() const { return m_region.Data() != nullptr; }
+    // Сообщения: длина u32, данные, выравнивание на 8
+    bool Send(const uint8_t* data, size_t size) override;
+
+private:
+    SharedRegion m_region;
+    FrameRingHeader* m_header = nullptr;
+    uint8_t*         m_data = nullptr;
+    uint64_t         m_capacity = 0;
+};
+
+class FrameRingReader {
+public:
+    bool Open(const char* name);
+    // Следующее сообщение в out; false — новых нет. Если писатель обогнал
+    // читателя на всё кольцо, чтение продолжается с последнего ключевого кадра
+    bool Next(std::vector<uint8_t>* out);
+    uint64_t Overruns() const { return m_overruns; }
+
+private:
+    bool Copy(uint64_t pos, void* dst, size_t size) const;
+
+    SharedRegion m_region;
+    const FrameRingHeader* m_header = nullptr;
+    const uint8_t*         m_data = nullptr;
+    uint64_t               m_capacity = 0;
+    uint64_t               m_pos = 0;
+    bool                   m_synced = false;
+    uint64_t               m_overruns = 0;
+};
@@ -0,0 +1,210 @@
+#include "game_calendar.h"
+#include <algorithm>
+#include <functional>
+
+// Развёрнутая таблица строится, пока в ней не больше стольких событий
+static const int64_t MAX_FLAT_SLOTS = int64_t(1) << 20;
+static const int64_t MAX_PERIOD     = INT32_MAX;
+
+static int64_t Gcd(int64_t a, int64_t b)
+{
+    while (b) { int64_t t = a % b; a = b; b = t; }
+    return a;
+}
+
+CalendarRule CalendarRule::Daily(int minuteOfDay, uint32_t id, int minutesPerDay)
+{
+    return Every(minutesPerDay, minuteOfDay, id);
+}
+
+CalendarRule CalendarRule::Every(int64_t period, int64_t phase, uint32_t id)
+{
+    CalendarRule r;
+    r.period = period;
+    r.phase = period > 0 ? FloorMod(phase, period) : 0;
+    r.id = id;
+    return r;
+}
+
+CalendarRule CalendarRule::EveryNthDay(int days, int dayPhase, int minuteOfDay, uint32_t id,
+                                       int minutesPerDay)
+{
+    return Every(int64_t(days) * minutesPerDay, int64_t(dayPhase) * minutesPerDay + minuteOfDay, id);
+}
+
+bool GameCalendar::Add(const CalendarRule& rule)
+{
+    if (rule.period <= 0 || rule.period > MAX_PERIOD) return false;
+    CalendarRule r = CalendarRule::Every(rule.period, rule.phase, rule.id);
+    m_rules.push_back(r);
+    m_built = false;
+    return true;
+}
+
+void GameCalendar::Clear()
+{
+    m_rules.clear();
+    m_flat.clear();
+    m_groups.clear();
+    m_cycle = 0;
+    m_built = false;
+}
+
+void GameCalendar::Build()
+{
+    m_flat.clear();
+    m_groups.clear();
+    m_cycle = 0;
+    m_built = true;
+    if (m_rules.empty()) return;
+
+    auto less = [](const Slot& a, const Slot& b) {
+        return a.minute != b.minute ? a.minute < b.minute : a.rule < b.rule;
+    };
+
+    // Общий период (НОК) и число событий за него
+    int64_t cycle = 1;
+    bool flat = true;
+    for (const CalendarRule& r : m_rules)
+    {
+        int64_t g = Gcd(cycle, r.period);
+        if (cycle / g > MAX_PERIOD / r.period) { flat = false; break; }
+        cycle = cycle / g * r.period;
+    }
+    if (flat)
+    {
+        int64_t slots = 0;
+        for (const CalendarRule& r : m_rules)
+            if ((slots += cycle / r.period) > MAX_FLAT_SLOTS) { flat = false; break; }
+    }
+
+    if (flat)
+    {
+        m_cycle = cycle;
+        for (uint32_t i = 0; i < m_rules.size(); ++i)
+            for (int64_t m = m_rules[i].phase; m < cycle; m += m_rules[i].period)
+                m_flat.push_back({ static_cast<uint32_t>(m), i });
+        std::sort(m_flat.begin(), m_flat.end(), less);
+        return;
+    }
+
+    // Периоды не сводятся к разумному общему: по таблице на каждый период
+    std::vector<uint32_t> order(m_rules.size());
+    for (uint32_t i = 0; i < order.size(); ++i) order[i] = i;
+    std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+        return m_rules[a].period < m_rules[b].period;
+    });
+    for (uint32_t i : order)
+    {
+        if (m_groups.empty() || m_groups.back().period != m_rules[i].period)
+            m_groups.push_back({ m_rules[i].period, {} });
+        m_groups.back().slots.push_back({ static_cast<uint32_t>(m_rules[i].phase), i });
+    }
+    for (Group& g : m_groups)
+        std::sort(g.slots.begin(), g.slots.end(), less);
+}
+
+// Позиция внутри таблицы одного периода
+struct GameCalendar::Cursor {
+    int64_t  minute;   // абсолютная минута текущего события
+    uint32_t rule;
+    uint32_t group;
+    size_t   index;
+    int64_t  base;     // начало текущего периода
+
+    bool operator>(const Cursor& o) const
+    {
+        return minute != o.minute ? minute > o.minute : rule > o.rule;
+    }
+};
+
+template <typename Emit>
+void GameCalendar::Walk(int64_t first, Emit&& emit)
+{
+    if (!m_built) Build();
+    auto seek = [](const std::vector<Slot>& slots, int64_t period, int64_t first,
+                   size_t* index, int64_t* base) {
+        int64_t r = FloorMod(first, period);
+        *base = first - r;
+        *index = std::lower_bound(slots.begin(), slots.end(), r,
+                                  [](const Slot& s, int64_t v) { return s.minute < v; }) - slots.begin();
+        if (*index == slots.size()) { *index = 0; *base += period; }
+    };
+
+    if (m_cycle)
+    {
+        if (m_flat.empty()) return;
+        size_t i;
+        int64_t base;
+        seek(m_flat, m_cycle, first, &i, &base);
+        for (;;)
+        {
+            const Slot& s = m_flat[i];
+            if (!emit(base + s.minute, s.rule)) return;
+            if (++i == m_flat.size()) { i = 0; base += m_cycle; }
+        }
+    }
+
+    // Слияние групп через кучу: O(G log k) на поиск и O(log G) на событие
+    std::vector<Cursor> heap;
+    heap.reserve(m_groups.size());
+    for (uint32_t g = 0; g < m_groups.size(); ++g)
+    {
+        Cursor c;
+        c.group = g;
+        seek(m_groups[g].slots, m_groups[g].period, first, &c.index, &c.base);
+        c.minute = c.base + m_groups[g].slots[c.index].minute;
+        c.rule = m_groups[g].slots[c.index].rule;
+        heap.push_back(c);
+    }
+    std::make_heap(heap.begin(), heap.end(), std::greater<Cursor>());
+    while (!heap.empty())
+    {
+        std::pop_heap(heap.begin(), heap.end(), std::greater<Cursor>());
+        Cursor& c = heap.back();
+        if (!emit(c.minute, c.rule)) return;
+        const Group& g = m_groups[c.group];
+        if (++c.index == g.slots.size()) { c.index = 0; c.base += g.period; }
+        c.minute = c.base + g.slots[c.index].minute;
+        c.rule = g.slots[c.index].rule;
+        std::push_heap(heap.begin(), heap.end(), std::greater<Cursor>());
+    }
+}
+
+size_t GameCalendar::NextAfterMinute(int64_t minute, size_t n, CalendarOccurrence* out)
+{
+    size_t k = 0;
+    if (!n) return 0;
+    Walk(minute + 1, [&](int64_t m, uint32_t rule) {
+        out[k].gameMinute = m;
+        out[k].at = 0;
+        out[k].id = m_rules[rule].id;
+        return ++k < n;
+    });
+    return k;
+}
+
+size_t GameCalendar::Next(const GameClock& clock, int64_t now, size_t n, CalendarOccurrence* out)
+{
+    size_t k = NextAfterMinute(clock.GameMinute(now), n, out);
+    for (size_t i = 0; i < k; ++i)
+        out[i].at = clock.DeadlineOf(out[i].gameMinute);
+    return k;
+}
+
+size_t GameCalendar::Range(const GameClock& clock, int64_t from, int64_t to,
+                           std::vector<CalendarOccurrence>* out)
+{
+    if (to <= from) return 0;
+    // Минуты, начало которых попадает в [from, to)
+    int64_t lo = clock.GameMinute(from - 1) + 1;
+    int64_t hi = clock.GameMinute(to - 1) + 1;
+    size_t before = out->size();
+    if (lo >= hi) return 0;
+    Walk(lo, [&](int64_t m, uint32_t rule) {
+        if (m >= hi) return false;
+        out->push_back({ m, clock.DeadlineOf(m), m_rules[rule].id });
+        return true;
+    });
+    return out->size() - before;
+}
@@ -0,0 +1,81 @@
+#pragma once
+// -----------------------------------------------------------------------------
+// Календарь повторяющихся событий в игровом времени.
+//
+// Любое правило вида "каждый день в 06:00", "каждые 3 игровых часа",
+// "в 22:00 каждого 7-го дня" сводится к паре (период, фаза) в игровых
+// минутах: событие наступает в минуты m, где m mod period == phase.
+// Build() собирает правила в индекс, по которому ближайшие события после
+// заданного момента ищутся двоичным поиском, а не перебором всех правил.
+// -----------------------------------------------------------------------------
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "game_time.h"
+
+struct CalendarRule {
+    int64_t  period = 0;   // игровых минут, > 0
+    int64_t  phase  = 0;   // 0..period-1
+    uint32_t id     = 0;   // номер события у вызывающего
+
+    // Каждый игровой день в minuteOfDay
+    static CalendarRule Daily(int minuteOfDay, uint32_t id, int minutesPerDay = MINUTES_IN_DAY);
+    // Каждые period игровых минут, начиная с минуты phase от начала отсчёта
+    static CalendarRule Every(int64_t period, int64_t phase, uint32_t id);
+    // В minuteOfDay каждого days-го дня; dayPhase — номер дня в цикле
+    static CalendarRule EveryNthDay(int days, int dayPhase, int minuteOfDay, uint32_t id,
+                                    int minutesPerDay = MINUTES_IN_DAY);
+};
+
+struct CalendarOccurrence {
+    int64_t  gameMinute;   // абсолютная игровая минута (как GameClock::GameMinute)
+    int64_t  at;           // реальный момент наступления (тики FILETIME)
+    uint32_t id;
+};
+
+class GameCalendar {
+public:
+    // Неверные правила (period <= 0) не принимаются
+    bool   Add(const CalendarRule& rule);
+    void   Clear();
+    size_t Size() const { return m_rules.size(); }
+
+    // Собирает индекс; вызывается сам при первом запросе после Add
+    void Build();
+
+    // Не более n ближайших событий строго после игровой минуты minute,
+    // по возрастанию (при равенстве — в порядке добавления правил)
+    size_t NextAfterMinute(int64_t minute, size_t n, CalendarOccurrence* out);
+
+    // Не более n ближайших событий строго после реального момента now
+    size_t Next(const GameClock& clock, int64_t now, size_t n, CalendarOccurrence* out);
+
+    // Все события с from <= at < to (дописываются в out); возвращает их число
+    size_t Range(const GameClock& clock, int64_t from, int64_t to,
+                 std::vector<CalendarOccurrence>* out);
+
+    // true — индекс построен как одна развёрнутая таблица на общий период
+    bool Flat() const { return m_cycle > 0; }
+
+private:
+    struct Slot {
+        uint32_t minute;   // фаза в пределах периода
+        uint32_t rule;
+    };
+    struct Group {
+        int64_t           period;
+        std::vector<Slot> slots;   // по возрастанию (minute, rule)
+    };
+    struct Cursor;
+
+    template <typename Emit>
+    void Walk(int64_t first, Emit&& emit);
+
+    std::vector<CalendarRule> m_rules;
+    bool                      m_built = false;
+    // Развёрнутая таблица: все события за НОК периодов
+    int64_t                   m_cycle = 0;
+    std::vector<Slot>         m_flat;
+    // Иначе — группы правил с одинаковым периодом
+    std::vector<Group>        m_groups;
+};
@@ -0,0 +1,117 @@
+#include "game_ini.h"
+#include <cstdio>
+#include <string>
+
+static bool EqualNoCase(const char* a, size_t n, const char* b)
+{
+    for (size_t i = 0; i < n; ++i, ++b)
+    {
+        char x = a[i], y = *b;
+        if (x >= 'A' && x <= 'Z') x = static_cast<char>(x - 'A' + 'a');
+        if (y >= 'A' && y <= 'Z') y = static_cast<char>(y - 'A' + 'a');
+        if (!y || x != y) return false;
+    }
+    return *b == 0;
+}
+
+static void Trim(const char*& b, const char*& e)
+{
+    while (b < e && (*b == ' ' || *b == '\t')) ++b;
+    while (e > b && (e[-1] == ' ' || e[-1] == '\t' || e[-1] == '\r')) --e;
+}
+
+// Как _wtoi64: необязательный знак, цифры до первого нецифрового символа
+static int64_t ParseInt(const char* b, const char* e)
+{
+    bool neg = false;
+    if (b < e && (*b == '-' || *b == '+')) neg = *b++ == '-';
+    uint64_t v = 0;
+    for (; b < e && *b >= '0' && *b <= '9'; ++b) v = v * 10 + uint64_t(*b - '0');
+    return neg ? -static_cast<int64_t>(v) : static_cast<int64_t>(v);
+}
+
+bool ParseGameIni(const char* text, size_t len, SavedGameTime* out)
+{
+    // UTF-16LE с BOM: значимые символы — ASCII, просто выбрасываем старшие байты
+    std::string narrow;
+    if (len >= 2 && static_cast<unsigned char>(text[0]) == 0xFF &&
+        static_cast<unsigned char>(text[1]) == 0xFE)
+    {
+        narrow.reserve(len / 2);
+        for (size_t i = 2; i + 1 < len; i += 2)
+            narrow.push_back(text[i + 1] ? '?' : text[i]);
+        text = narrow.data();
+        len = narrow.size();
+    }
+    else if (len >= 3 && static_cast<unsigned char>(text[0]) == 0xEF)
+    {
+        text += 3;
+        len -= 3;
+    }
+
+    bool inGame = false, found = false;
+    SavedGameTime r;
+    const char* p = text;
+    const char* end = text + len;
+    while (p < end)
+    {
+        const char* eol = p;
+        while (eol < end && *eol != '\n') ++eol;
+        const char* b = p;
+        const char* e = eol;
+        p = eol < end ? eol + 1 : end;
+        Trim(b, e);
+        if (b == e || *b == ';') continue;
+
+        if (*b == '[')
+        {
+            const char* close = b;
+            while (close < e && *close != ']') ++close;
+            inGame = EqualNoCase(b + 1, static_cast<size_t>(close - b - 1), "game");
+            continue;
+        }
+        if (!inGame) continue;
+
+        const char* eq = b;
+        while (eq < e && *eq != '=') ++eq;
+        if (eq == e) continue;
+        const char* kb = b;
+        const char* ke = eq;
+        const char* vb = eq + 1;
+        Trim(kb, ke);
+        Trim(vb, e);
+        if (EqualNoCase(kb, static_cast<size_t>(ke - kb), "GameTime"))
+        {
+            r.gameMinute = ParseInt(vb, e);
+            found = true;
+        }
+        else if (EqualNoCase(kb, static_cast<size_t>(ke - kb), "CloseTime"))
+        {
+            r.closeTime = ParseInt(vb, e);
+            found = true;
+        }
+    }
+    if (found) *out = r;
+    return found;
+}
+
+bool ReadGameIni(const char* path, SavedGameTime* out)
+{
+    FILE* f = std::fopen(path, "rb");
+    if (!f) return false;
+    std::string text;
+    char buf[4096];
+    size_t n;
+    while ((n = std::fread(buf, 1, sizeof(buf), f)) > 0) text.append(buf, n);
+    std::fclose(f);
+    return ParseGameIni(text.data(), text.size(), out);
+}
+
+void RestoreGameClock(GameClock* clock, const SavedGameTime& saved, int64_t now,
+                      int localMinuteOfDay)
+{
+    if (saved.closeTime > 0 && now > saved.closeTime)
+        clock->Restore(now, saved.gameMinute, saved.closeTime);
+    else
+        clock->SetGameTime(now, localMinuteOfDay);
+}
@@ -0,0 +1,25 @@
+#pragma once
+// -----------------------------------------------------------------------------
+// Разбор gameclock.ini в том виде, как его пишет SaveGameTime:
+//   [Game]
+//   GameTime=<игровая минута>
+//   CloseTime=<FILETIME момента сохранения>
+// Без Win32: используется утилитами под Linux.
+// -----------------------------------------------------------------------------
+#include <cstddef>
+#include <cstdint>
+#include "game_time.h"
+
+struct SavedGameTime {
+    int64_t gameMinute = 0;
+    int64_t closeTime  = 0;   // 0 — не сохранялось
+};
+
+// Понимает ANSI/UTF-8 и UTF-16LE (WritePrivateProfileString пишет оба)
+bool ParseGameIni(const char* text, size_t len, SavedGameTime* out);
+bool ReadGameIni(const char* path, SavedGameTime* out);
+
+// То же, что LoadGameTime: продолжаем с сохранённого момента, а если его нет
+// или часы ушли назад — начинаем с локального времени суток
+void RestoreGameClock(GameClock* clock, const SavedGameTime& saved, int64_t now,
+                      int localMinuteOfDay);
@@ -0,0 +1,56 @@
+#include "game_time.h"
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+// Разница между эпохами FILETIME (1601) и Unix (1970) в тиках по 100 нс
+static const int64_t UNIX_EPOCH_TICKS = 116444736000000000LL;
+
+int64_t WallTicksNow()
+{
+#ifdef _WIN32
+    FILETIME ft; GetSystemTimeAsFileTime(&ft);
+    return static_cast<int64_t>((static_cast<uint64_t>(ft.dwHighDateTime) << 32) | ft.dwLowDateTime);
+#else
+    timespec ts; clock_gettime(CLOCK_REALTIME, &ts);
+    return UNIX_EPOCH_TICKS + ts.tv_sec * TICKS_PER_SECOND + ts.tv_nsec / 100;
+#endif
+}
+
+void GameClock::SetGameTime(int64_t now, int minuteOfDay)
+{
+    m_s.start  = now;
+    m_s.offset = static_cast<int64_t>(minuteOfDay) * m_s.ticksPerMinute;
+}
+
+void GameClock::Restore(int64_t now, int64_t gameMinute, int64_t closeTime)
+{
+    // (storedGame + прошедшее / rate) * rate == storedGame * rate + прошедшее
+    m_s.start  = now;
+    m_s.offset = gameMinute * m_s.ticksPerMinute + (now - closeTime);
+}
+
+void GameClock::GameMinutes(const int64_t* at, int64_t* minutes, size_t n) const
+{
+    // Частное через умножение на обратное в double и отбрасывание дробной
+    // части: для отрицательных тиков оно может уйти вверх на 2, иначе
+    // ошибка не больше единицы — всё исправляется по остатку
+    const int64_t tpm = m_s.ticksPerMinute;
+    const int64_t base = m_s.offset - m_s.start;
+    const double  inv = 1.0 / static_cast<double>(tpm);
+    for (size_t i = 0; i < n; ++i)
+    {
+        int64_t t = at[i] + base;
+        int64_t q = static_cast<int64_t>(static_cast<double>(t) * inv);
+        int64_t r = t - q * tpm;
+        q -= static_cast<int64_t>(r < 0) + static_cast<int64_t>(r < -tpm);
+        q += static_cast<int64_t>(r >= tpm);
+        // За 2^50 минут точности double уже не хватает
+        if (q > (int64_t(1) << 50) || q < -(int64_t(1) << 50)) q = FloorDiv(t, tpm);
+        minutes[i] = q;
+    }
+}
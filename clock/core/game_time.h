@@ -0,0 +1,90 @@
+#pragma once
+// -----------------------------------------------------------------------------
+// Модель игрового времени без привязки к платформе.
+//
+// Всё считается в целых тиках по 100 нс (как FILETIME), поэтому 8.75 сек —
+// это ровно 87 500 000 тиков и никакой плавающей точки не требуется.
+// -----------------------------------------------------------------------------
+#include <cstddef>
+#include <cstdint>
+
+// -----------------------------------------------------------------------------
+// Константы времени игры
+// -----------------------------------------------------------------------------
+const int64_t TICKS_PER_SECOND  = 10000000;      // 1 сек = 10^7 тиков по 100 нс
+const int64_t GAME_MINUTE_TICKS = 87500000;      // 1 игровая минута = 8.75 сек
+const int     MINUTES_IN_DAY    = 1440;
+
+// Деление с округлением вниз (для отрицательных значений тоже)
+inline int64_t FloorDiv(int64_t a, int64_t b)
+{
+    int64_t q = a / b;
+    return (a % b != 0 && ((a < 0) != (b < 0))) ? q - 1 : q;
+}
+inline int64_t FloorMod(int64_t a, int64_t b)
+{
+    int64_t r = a % b;
+    return (r != 0 && ((r < 0) != (b < 0))) ? r + b : r;
+}
+
+// Текущее системное время в тиках по 100 нс от 1601-01-01 (эпоха FILETIME)
+int64_t WallTicksNow();
+
+// -----------------------------------------------------------------------------
+// Состояние часов: игровые тики = (now - start) + offset
+// -----------------------------------------------------------------------------
+struct GameClockState {
+    int64_t start          = 0;                  // момент привязки (реальные тики)
+    int64_t offset         = 0;                  // смещение в реальных тиках
+    int64_t ticksPerMinute = GAME_MINUTE_TICKS;  // длина игровой минуты
+    int32_t minutesPerDay  = MINUTES_IN_DAY;
+};
+
+class GameClock {
+public:
+    GameClock() = default;
+    explicit GameClock(const GameClockState& s) : m_s(s) {}
+
+    const GameClockState& State() const { return m_s; }
+    void SetState(const GameClockState& s) { m_s = s; }
+
+    // Перенастройка часов так, что в момент now идёт минута minuteOfDay
+    // (аналог ввода времени в диалоге "Установить время").
+    void SetGameTime(int64_t now, int minuteOfDay);
+
+    // Восстановление после перезапуска: в момент closeTime было gameMinute
+    // игровых минут, с тех пор время шло с обычной скоростью.
+    void Restore(int64_t now, int64_t gameMinute, int64_t closeTime);
+
+    // Игровые тики (в масштабе реального времени) на момент now
+    int64_t GameTicks(int64_t now) const { return now - m_s.start + m_s.offset; }
+
+    // Общее число игровых минут и разбиение на день/минуту суток
+    int64_t GameMinute(int64_t now) const { return FloorDiv(GameTicks(now), m_s.ticksPerMinute); }
+    int64_t GameDay(int64_t now) const { return FloorDiv(GameMinute(now), m_s.minutesPerDay); }
+    // GameMinute для n моментов сразу (at и minutes могут совпадать): без
+    // целочисленного деления на каждый элемент, цикл векторизуется
+    void    GameMinutes(const int64_t* at, int64_t* minutes, size_t n) const;
+    int     MinuteOfDay(int64_t now) const
+    {
+        return static_cast<int>(FloorMod(GameMinute(now), m_s.minutesPerDay));
+    }
+
+    // Реальный момент начала игровой минуты gameMinute
+    int64_t DeadlineOf(int64_t gameMinute) const
+    {
+        return m_s.start - m_s.offset + gameMinute * m_s.ticksPerMinute;
+    }
+    int64_t NextMinuteDeadline(int64_t now) const { return DeadlineOf(GameMinute(now) + 1); }
+    int64_t NextMidnightDeadline(int64_t now) const
+    {
+        return DeadlineOf((GameDay(now) + 1) * m_s.minutesPerDay);
+    }
+
+    // Игровых минут до полуночи (1..minutesPerDay) и реальных тиков до неё
+    int     MinutesToMidnight(int64_t now) const { return m_s.minutesPerDay - MinuteOfDay(now); }
+    int64_t TicksToMidnight(int64_t now) const { return NextMidnightDeadline(now) - now; }
+
+private:
+    GameClockState m_s;
+};
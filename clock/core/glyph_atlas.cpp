@@ -0,0 +1,215 @@
+#include "glyph_atlas.h"
+#include <algorithm>
+#include <cstring>
+
+// -----------------------------------------------------------------------------
+// SegmentRasterizer
+// -----------------------------------------------------------------------------
+// Сегменты a..g (биты 0..6) для цифр 0-9
+static const uint8_t DIGIT_SEGMENTS[10] = { 0x3F, 0x06, 0x5B, 0x4F, 0x66, 0x6D, 0x7D, 0x07, 0x7F, 0x6F };
+
+struct Box {
+    float x0, y0, x1, y1;
+    bool Contains(float x, float y) const { return x >= x0 && x < x1 && y >= y0 && y < y1; }
+};
+
+int SegmentRasterizer::Advance(char ch)
+{
+    return ch == ':' ? (m_height * 3 + 5) / 10 : (m_height * 56 + 50) / 100;
+}
+
+void SegmentRasterizer::Rasterize(char ch, int width, uint8_t* coverage, int stride)
+{
+    float w = float(width), h = float(m_height);
+    float t = h * 0.1f;
+    float mx = std::max((w - h * 0.56f) * 0.5f, 0.0f) + h * 0.07f;
+    float my = h * 0.08f, mid = h * 0.5f;
+
+    Box boxes[7];
+    int count = 0;
+    int index = GlyphIndex(ch);
+    if (index == 10)
+    {
+        float cx = w * 0.5f - t * 0.5f;
+        boxes[count++] = { cx, h * 0.32f, cx + t, h * 0.32f + t };
+        boxes[count++] = { cx, h * 0.62f, cx + t, h * 0.62f + t };
+    }
+    else if (index >= 0)
+    {
+        const Box segments[7] = {
+            { mx, my, w - mx, my + t },                      // a
+            { w - mx - t, my, w - mx, mid + t * 0.5f },      // b
+            { w - mx - t, mid - t * 0.5f, w - mx, h - my },  // c
+            { mx, h - my - t, w - mx, h - my },              // d
+            { mx, mid - t * 0.5f, mx + t, h - my },          // e
+            { mx, my, mx + t, mid + t * 0.5f },              // f
+            { mx, mid - t * 0.5f, w - mx, mid + t * 0.5f },  // g
+        };
+        for (int s = 0; s < 7; ++s)
+            if (DIGIT_SEGMENTS[index] & (1 << s)) boxes[count++] = segments[s];
+    }
+
+    for (int y = 0; y < m_height; ++y)
+    {
+        uint8_t* row = coverage + size_t(y) * size_t(stride);
+        for (int x = 0; x < width; ++x)
+        {
+            int hits = 0;
+            for (int sy = 0; sy < 4; ++sy)
+                for (int sx = 0; sx < 4; ++sx)
+                {
+                    float px = float(x) + (float(sx) + 0.5f) * 0.25f;
+                    float py = float(y) + (float(sy) + 0.5f) * 0.25f;
+                    for (int b = 0; b < count; ++b)
+                        if (boxes[b].Contains(px, py)) { ++hits; break; }
+                }
+            row[x] = static_cast<uint8_t>(hits * 255 / 16);
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
+// GlyphAtlas
+// -----------------------------------------------------------------------------
+static inline Pixel Blend(Pixel bg, Pixel fg, unsigned a)
+{
+    Pixel out = 0xFF000000u;
+    for (int shift = 0; shift < 24; shift += 8)
+    {
+        unsigned b = (bg >> shift) & 0xFF, f = (fg >> shift) & 0xFF;
+        out |= ((b * (255 - a) + f * a + 127) / 255) << shift;
+    }
+    return out;
+}
+
+void GlyphAtlas::Build(GlyphRasterizer* rasterizer, ThemeColor text, ThemeColor bg)
+{
+    int height = rasterizer->CellHeight();
+    int digit = 0;
+    for (size_t i = 0; i < 10; ++i)
+        digit = std::max(digit, rasterizer->Advance(GLYPH_CHARS[i]));
+    int total = 0;
+    for (size_t i = 0; i < GLYPH_COUNT; ++i)
+    {
+        m_width[i] = i < 10 ? digit : rasterizer->Advance(GLYPH_CHARS[i]);
+        m_x[i] = total;
+        total += m_width[i];
+    }
+
+    m_bg = PixelFromTheme(bg);
+    Pixel fg = PixelFromTheme(text);
+    m_pixels.Resize(total, height, m_bg);
+    std::vector<uint8_t> coverage(size_t(digit > m_width[10] ? digit : m_width[10]) * size_t(height));
+    for (size_t i = 0; i < GLYPH_COUNT; ++i)
+    {
+        int w = m_width[i];
+        std::fill(coverage.begin(), coverage.end(), 0);
+        rasterizer->Rasterize(GLYPH_CHARS[i], w, coverage.data(), w);
+        for (int y = 0; y < height; ++y)
+        {
+            Pixel* dst = m_pixels.Row(y) + m_x[i];
+            const uint8_t* src = coverage.data() + size_t(y) * size_t(w);
+            for (int x = 0; x < w; ++x)
+                dst[x] = src[x] ? Blend(m_bg, fg, src[x]) : m_bg;
+        }
+    }
+}
+
+const GlyphAtlas* GlyphAtlasCache::Get(uint32_t font, GlyphRasterizer* rasterizer, ThemeColor text,
+                                       ThemeColor bg)
+{
+    for (const Entry& e : m_atlases)
+        if (e.font == font && e.text == text && e.bg == bg) return e.atlas.get();
+    std::unique_ptr<GlyphAtlas> atlas(new GlyphAtlas);
+    atlas->Build(rasterizer, text, bg);
+    ++m_builds;
+    m_atlases.push_back({ font, text, bg, std::move(atlas) });
+    return m_atlases.back().atlas.get();
+}
+
+// -----------------------------------------------------------------------------
+// ClockCompositor
+// -----------------------------------------------------------------------------
+void ClockCompositor::Resize(int width, int height)
+{
+    m_frame.Resize(std::max(width, 0), std::max(height, 0), m_atlas ? m_atlas->Background() : 0);
+    m_full = true;
+}
+
+void ClockCompositor::SetAtlas(const GlyphAtlas* atlas)
+{
+    if (atlas != m_atlas) m_full = true;
+    m_atlas = atlas;
+}
+
+void ClockCompositor::DrawCell(size_t i, char ch)
+{
+    int x0 = std::max(m_cellX[i], 0), x1 = std::min(m_cellX[i + 1], m_frame.width);
+    int y0 = std::max(m_top, 0), y1 = std::min(m_top + m_atlas->Height(), m_frame.height);
+    if (x0 >= x1 || y0 >= y1) return;
+    int index = GlyphIndex(ch);
+    size_t w = size_t(x1 - x0);
+    for (int y = y0; y < y1; ++y)
+    {
+        Pixel* dst = m_frame.Row(y) + x0;
+        if (index >= 0)
+            std::memcpy(dst, m_atlas->Row(index, y - m_top) + (x0 - m_cellX[i]), w * sizeof(Pixel));
+        else
+            std::fill(dst, dst + w, m_atlas->Background());
+    }
+    m_drawn += w * size_t(y1 - y0);
+}
+
+size_t ClockCompositor::Compose(const char* text, size_t n, PixelRect* damage, size_t cap)
+{
+    m_drawn = 0;
+    if (!m_atlas || !cap || !m_frame.width || !m_frame.height) return 0;
+    n = std::min(n, MAX_CLOCK_CELLS);
+
+    // Ширина ячейки зависит только от того, двоеточие это или нет
+    bool layout = m_full || n != m_len;
+    for (size_t i = 0; i < n && !layout; ++i)
+        layout = (text[i] == ':') != (m_text[i] == ':');
+
+    if (layout)
+    {
+        int total = 0;
+        for (size_t i = 0; i < n; ++i)
+            total += m_atlas->Width(text[i] == ':' ? 10 : 0);
+        m_cellX[0] = (m_frame.width - total) / 2;
+        for (size_t i = 0; i < n; ++i)
+            m_cellX[i + 1] = m_cellX[i] + m_atlas->Width(text[i] == ':' ? 10 : 0);
+        m_top = (m_frame.height - m_atlas->Height()) / 2;
+
+        std::fill(m_frame.pixels.begin(), m_frame.pixels.end(), m_atlas->Background());
+        for (size_t i = 0; i < n; ++i)
+            DrawCell(i, text[i]);
+        std::memcpy(m_text, text, n);
+        m_len = n;
+        m_full = false;
+        damage[0] = { 0, 0, m_frame.width, m_frame.height };
+        return 1;
+    }
+
+    size_t k = 0;
+    int y0 = std::max(m_top, 0), y1 = std::min(m_top + m_atlas->Height(), m_frame.height);
+    bool open = false;
+    for (size_t i = 0; i < n; ++i)
+    {
+        if (text[i] == m_text[i]) { open = false; continue; }
+        DrawCell(i, text[i]);
+        m_text[i] = text[i];
+        int x0 = std::max(m_cellX[i], 0), x1 = std::min(m_cellX[i + 1], m_frame.width);
+        if (x0 >= x1 || y0 >= y1) { open = false; continue; }
+        if (open || k == cap)
+        {
+            // Продолжение предыдущего прямоугольника (или места больше нет)
+            PixelRect& r = damage[k - 1];
+            r.width = x1 - r.x;
+        }
+        else
+            damage[k++] = { x0, y0, x1 - x0, y1 - y0 };
+        open = true;
+    }
+    return k;
+}
@@ -0,0 +1,155 @@
+#pragma once
+// -----------------------------------------------------------------------------
+// Отрисовка больших часов из заранее растеризованных символов.
+//
+// На экране бывают только цифры 0-9 и ':'. Эти 11 символов растеризуются
+// один раз на шрифт, размер и тему в атлас уже готовых пикселей (текст,
+// смешанный с фоном), а кадр собирается копированием строк атласа в буфер.
+// ClockCompositor помнит, что нарисовано, перерисовывает только изменившиеся
+// ячейки и отдаёт прямоугольники изменений — окну остаётся вывести их.
+//
+// Растеризация идёт через GlyphRasterizer: в окне это GDI со шрифтом окна,
+// на Linux (проверки, бенчмарки) — семисегментные цифры SegmentRasterizer.
+// -----------------------------------------------------------------------------
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "theme_cache.h"
+
+typedef uint32_t Pixel;   // 0xAARRGGBB: в памяти B, G, R, A — как 32-битный DIB
+
+inline Pixel PixelFromTheme(ThemeColor c)
+{
+    return 0xFF000000u | ((c & 0xFF) << 16) | (c & 0xFF00) | ((c >> 16) & 0xFF);
+}
+
+const char   GLYPH_CHARS[] = "0123456789:";
+const size_t GLYPH_COUNT   = sizeof(GLYPH_CHARS) - 1;
+
+inline int GlyphIndex(char ch)
+{
+    return ch >= '0' && ch <= '9' ? ch - '0' : ch == ':' ? 10 : -1;
+}
+
+struct PixelRect {
+    int x, y, width, height;
+};
+
+// Изображение без выравнивания строк: stride == width
+struct PixelBuffer {
+    int width = 0;
+    int height = 0;
+    std::vector<Pixel> pixels;
+
+    void Resize(int w, int h, Pixel fill)
+    {
+        width = w;
+        height = h;
+        pixels.assign(size_t(w) * size_t(h), fill);
+    }
+    Pixel*       Row(int y) { return pixels.data() + size_t(y) * size_t(width); }
+    const Pixel* Row(int y) const { return pixels.data() + size_t(y) * size_t(width); }
+};
+
+// -----------------------------------------------------------------------------
+// Растеризация символов
+// -----------------------------------------------------------------------------
+class GlyphRasterizer {
+public:
+    virtual ~GlyphRasterizer() = default;
+    // Высота строки (одна на все символы)
+    virtual int  CellHeight() = 0;
+    // Ширина ячейки символа
+    virtual int  Advance(char ch) = 0;
+    // Покрытие 0..255 символа ch в ячейке width x CellHeight()
+    virtual void Rasterize(char ch, int width, uint8_t* coverage, int stride) = 0;
+};
+
+// Семисегментные цифры со сглаживанием 4x4 — без шрифтов и ОС
+class SegmentRasterizer : public GlyphRasterizer {
+public:
+    explicit SegmentRasterizer(int height) : m_height(height < 8 ? 8 : height) {}
+    int  CellHeight() override { return m_height; }
+    int  Advance(char ch) override;
+    void Rasterize(char ch, int width, uint8_t* coverage, int stride) override;
+
+private:
+    int m_height;
+};
+
+// -----------------------------------------------------------------------------
+// Атлас
+// -----------------------------------------------------------------------------
+class GlyphAtlas {
+public:
+    // Цифры выравниваются по самой широкой, так что ширина строки
+    // из цифр не зависит от самих цифр
+    void Build(GlyphRasterizer* rasterizer, ThemeColor text, ThemeColor bg);
+
+    int   Height() const { return m_pixels.height; }
+    int   Width(int index) const { return m_width[index]; }
+    Pixel Background() const { return m_bg; }
+    // Строка y символа index; Width(index) пикселей подряд
+    const Pixel* Row(int index, int y) const { return m_pixels.Row(y) + m_x[index]; }
+
+private:
+    PixelBuffer m_pixels;   // символы подряд слева направо
+    int         m_x[GLYPH_COUNT] = {};
+    int         m_width[GLYPH_COUNT] = {};
+    Pixel       m_bg = 0;
+};
+
+// Атласы по (шрифт, тема): переключение темы туда и обратно не растеризует
+// заново. font — идентификатор шрифта и размера у вызывающего.
+class GlyphAtlasCache {
+public:
+    const GlyphAtlas* Get(uint32_t font, GlyphRasterizer* rasterizer, ThemeColor text, ThemeColor bg);
+    void   Clear() { m_atlases.clear(); }
+    size_t Builds() const { return m_builds; }
+
+private:
+    struct Entry {
+        uint32_t   font;
+        ThemeColor text;
+        ThemeColor bg;
+        std::unique_ptr<GlyphAtlas> atlas;
+    };
+    std::vector<Entry> m_atlases;
+    size_t m_builds = 0;
+};
+
+// -----------------------------------------------------------------------------
+// Сборка кадра
+// -----------------------------------------------------------------------------
+const size_t MAX_CLOCK_CELLS = 16;
+
+class ClockCompositor {
+public:
+    // Новый размер кадра; следующий Compose перерисует всё
+    void Resize(int width, int height);
+    // Другой атлас (тема, шрифт); следующий Compose перерисует всё
+    void SetAtlas(const GlyphAtlas* atlas);
+    void Invalidate() { m_full = true; }
+
+    // Рисует text по центру кадра (символы вне атласа — пустые ячейки).
+    // В damage пишет не больше cap прямоугольников изменений (соседние
+    // ячейки объединяются) и возвращает их число; 0 — кадр не изменился.
+    size_t Compose(const char* text, size_t n, PixelRect* damage, size_t cap);
+
+    const PixelBuffer& Frame() const { return m_frame; }
+    // Пикселей, скопированных последним Compose
+    size_t PixelsDrawn() const { return m_drawn; }
+
+private:
+    void DrawCell(size_t i, char ch);
+
+    const GlyphAtlas* m_atlas = nullptr;
+    PixelBuffer m_frame;
+    char   m_text[MAX_CLOCK_CELLS] = {};
+    int    m_cellX[MAX_CLOCK_CELLS + 1] = {};
+    size_t m_len = 0;
+    int    m_top = 0;
+    bool   m_full = true;
+    size_t m_drawn = 0;
+};
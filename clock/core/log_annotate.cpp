@@ -0,0 +1,292 @@
+#include "log_annotate.h"
+#include <algorithm>
+#include <cstring>
+#include <thread>
+#include <vector>
+#include "time_format.h"
+
+#ifndef _WIN32
+#include <cerrno>
+#include <climits>
+#include <sys/uio.h>
+#endif
+
+static const size_t  CHUNK_BYTES = 8u << 20;   // кусок на поток в одном окне
+static const int64_t UNIX_EPOCH_TICKS = 116444736000000000LL;
+
+// -----------------------------------------------------------------------------
+// Метка времени
+// -----------------------------------------------------------------------------
+// Байты цифр слова после xor с '0' — 0..9; проверка как в ParseHHMM5
+static inline bool Digits(uint64_t d, uint64_t mask)
+{
+    const uint64_t LOW = 0x7676767676767676ull, HIGH = 0x8080808080808080ull;
+    return (((d + (LOW & mask)) | d) & (HIGH & mask)) == 0;
+}
+
+static inline unsigned Byte(uint64_t w, int i) { return static_cast<unsigned>((w >> (i * 8)) & 0xFF); }
+
+const char* ParseLogTimestamp(const char* p, const char* end, int64_t utcOffset, int64_t* ticks)
+{
+    bool bracket = p < end && *p == '[';
+    p += bracket;
+    if (end - p < 19) return nullptr;
+
+    // "YYYY-MM-" "DD?HH:MM" ":SS": три слова, цифры и разделители сразу
+    uint64_t w0, w1, w2 = 0;
+    std::memcpy(&w0, p, 8);
+    std::memcpy(&w1, p + 8, 8);
+    std::memcpy(&w2, p + 16, 3);
+    const uint64_t ZEROS = 0x3030303030303030ull;
+    const uint64_t M0 = 0x00FFFF00FFFFFFFFull, M1 = 0xFFFF00FFFF00FFFFull, M2 = 0xFFFF00ull;
+    uint64_t d0 = (w0 ^ ZEROS) & M0;
+    uint64_t d1 = (w1 ^ ZEROS) & M1;
+    uint64_t d2 = (w2 ^ ZEROS) & M2;
+    unsigned sep = Byte(w1, 2);
+    bool ok = Digits(d0, M0) & Digits(d1, M1) & Digits(d2, M2) &
+              ((w0 & ~M0) == 0x2D00002D00000000ull) &             // '-' '-'
+              ((w1 & 0x0000FF0000000000ull) == 0x00003A0000000000ull) &   // ':'
+              ((w2 & 0xFF) == ':') & (sep == 'T' || sep == ' ');
+    if (!ok) return nullptr;
+
+    unsigned year = ((Byte(d0, 0) * 10 + Byte(d0, 1)) * 10 + Byte(d0, 2)) * 10 + Byte(d0, 3);
+    unsigned month = Byte(d0, 5) * 10 + Byte(d0, 6);
+    unsigned day = Byte(d1, 0) * 10 + Byte(d1, 1);
+    unsigned hour = Byte(d1, 3) * 10 + Byte(d1, 4);
+    unsigned minute = Byte(d1, 6) * 10 + Byte(d1, 7);
+    unsigned second = Byte(d2, 1) * 10 + Byte(d2, 2);
+    if (month - 1 > 11 || day - 1 > 30 || hour > 23 || minute > 59 || second > 60) return nullptr;
+    p += 19;
+
+    // Доли секунды: до 7 знаков в тики, остальные пропускаются
+    int64_t frac = 0;
+    if (p < end && (*p == '.' || *p == ',') && p + 1 < end && unsigned(p[1] - '0') <= 9)
+    {
+        ++p;
+        int digits = 0;
+        for (; p < end && unsigned(*p - '0') <= 9; ++p)
+            if (digits < 7) { frac = frac * 10 + (*p - '0'); ++digits; }
+        for (; digits < 7; ++digits) frac *= 10;
+    }
+
+    int64_t offset = utcOffset;
+    if (p < end && *p == 'Z')
+    {
+        offset = 0;
+        ++p;
+    }
+    else if (p < end && (*p == '+' || *p == '-') && end - p >= 5)
+    {
+        // +HH:MM или +HHMM
+        const char* q = p + 1;
+        auto d2v = [](const char* s) { return unsigned(s[0] - '0') <= 9 && unsigned(s[1] - '0') <= 9; };
+        if (d2v(q))
+        {
+            const char* mm = q[2] == ':' ? q + 3 : q + 2;
+            if (mm + 2 <= end && d2v(mm))
+            {
+                int64_t minutes = ((q[0] - '0') * 10 + (q[1] - '0')) * 60 + (mm[0] - '0') * 10 + (mm[1] - '0');
+                offset = (*p == '-' ? -minutes : minutes) * 60 * TICKS_PER_SECOND;
+                p = mm + 2;
+            }
+        }
+    }
+    if (bracket)
+    {
+        if (p == end || *p != ']') return nullptr;
+        ++p;
+    }
+
+    int64_t days = DaysFromCivil(year, month, day);
+    int64_t seconds = days * 86400 + hour * 3600 + minute * 60 + second;
+    *ticks = UNIX_EPOCH_TICKS + seconds * TICKS_PER_SECOND + frac - offset;
+    return p;
+}
+
+// -----------------------------------------------------------------------------
+// Куски
+// -----------------------------------------------------------------------------
+namespace {
+
+struct Chunk {
+    const char* begin = nullptr;
+    const char* end = nullptr;
+    size_t lines = 0;
+    std::vector<const char*> cuts;   // куда вставлять
+    std::vector<int64_t>     at;     // метки, потом игровые минуты
+    std::vector<char>        notes;
+    std::vector<LogSpan>     spans;
+};
+
+}
+
+static inline const char* FindLineEnd(const char* p, const char* end)
+{
+    const void* q = std::memchr(p, '\n', static_cast<size_t>(end - p));
+    return q ? static_cast<const char*>(q) : end;
+}
+
+static char* AppendDecimal(char* out, int64_t v)
+{
+    uint64_t u = v < 0 ? 0 - static_cast<uint64_t>(v) : static_cast<uint64_t>(v);
+    if (v < 0) *out++ = '-';
+    char digits[20];
+    int n = 0;
+    do { digits[n++] = static_cast<char>('0' + u % 10); u /= 10; } while (u);
+    while (n) *out++ = digits[--n];
+    return out;
+}
+
+namespace {
+
+struct AnnotateContext {
+    const GameClock* clock;
+    int64_t          today;   // текущие игровые сутки
+    int64_t          utcOffset;
+};
+
+}
+
+static void AnnotateChunk(const AnnotateContext& ctx, Chunk* c)
+{
+    c->lines = 0;
+    c->cuts.clear();
+    c->at.clear();
+
+    // Разбор: только позиции вставок и метки
+    for (const char* p = c->begin; p < c->end;)
+    {
+        const char* nl = FindLineEnd(p, c->end);
+        ++c->lines;
+        int64_t ticks;
+        if (const char* cut = ParseLogTimestamp(p, nl, ctx.utcOffset, &ticks))
+        {
+            c->cuts.push_back(cut);
+            c->at.push_back(ticks);
+        }
+        p = nl + 1;
+    }
+
+    // Перевод пачкой, затем вставки и отрезки вывода
+    size_t n = c->at.size();
+    ctx.clock->GameMinutes(c->at.data(), c->at.data(), n);
+    const int64_t perDay = ctx.clock->State().minutesPerDay;
+    c->notes.resize(n * LOG_NOTE_MAX_LEN);
+    c->spans.clear();
+    c->spans.reserve(2 * n + 1);
+    char* o = c->notes.data();
+    const char* from = c->begin;
+    for (size_t i = 0; i < n; ++i)
+    {
+        int64_t m = c->at[i];
+        char* note = o;
+        o = AppendLiteral(o, " [day ");
+        o = AppendDecimal(o, FloorDiv(m, perDay) - ctx.today);
+        *o++ = ' ';
+        o = AppendHHMM(o, static_cast<int>(FloorMod(m, perDay)));
+        *o++ = ']';
+        c->spans.push_back(LogSpan{ from, static_cast<size_t>(c->cuts[i] - from) });
+        c->spans.push_back(LogSpan{ note, static_cast<size_t>(o - note) });
+        from = c->cuts[i];
+    }
+    if (from < c->end)
+        c->spans.push_back(LogSpan{ from, static_cast<size_t>(c->end - from) });
+}
+
+// -----------------------------------------------------------------------------
+// AnnotateLog
+// -----------------------------------------------------------------------------
+bool AnnotateLog(const char* data, size_t size, const GameClock& clock, int64_t now,
+                 const LogAnnotateOptions& options, LogSink* sink, LogAnnotateReport* report)
+{
+    *report = LogAnnotateReport();
+    AnnotateContext ctx;
+    ctx.clock = &clock;
+    ctx.today = clock.GameDay(now);
+    ctx.utcOffset = options.utcOffset;
+    const char* end = data + size;
+    unsigned threads = options.threads;
+    if (!threads) threads = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<Chunk> chunks(threads);
+    std::vector<std::thread> pool;
+
+    // Окнами по threads кусков: разбор параллельно, запись по порядку
+    const char* p = data;
+    while (p < end)
+    {
+        size_t used = 0;
+        for (; used < threads && p < end; ++used)
+        {
+            const char* stop = p + std::min(CHUNK_BYTES, static_cast<size_t>(end - p));
+            if (stop < end)
+            {
+                const char* nl = FindLineEnd(stop, end);
+                stop = nl < end ? nl + 1 : end;
+            }
+            chunks[used].begin = p;
+            chunks[used].end = stop;
+            p = stop;
+        }
+        for (size_t i = 1; i < used; ++i)
+            pool.emplace_back(AnnotateChunk, std::cref(ctx), &chunks[i]);
+        AnnotateChunk(ctx, &chunks[0]);
+        for (auto& t : pool) t.join();
+        pool.clear();
+
+        for (size_t i = 0; i < used; ++i)
+        {
+            const Chunk& c = chunks[i];
+            report->lines += c.lines;
+            report->annotated += c.at.size();
+            for (const LogSpan& s : c.spans) report->bytesOut += s.size;
+            if (sink && !c.spans.empty() && !sink->Write(c.spans.data(), c.spans.size()))
+                return false;
+        }
+    }
+    return true;
+}
+
+bool AnnotateLogFile(const NativePath& input, const GameClock& clock, int64_t now,
+                     const LogAnnotateOptions& options, LogSink* sink, LogAnnotateReport* report)
+{
+    MappedFile f;
+    if (!f.Open(input))
+    {
+        *report = LogAnnotateReport();
+        return false;
+    }
+    return AnnotateLog(reinterpret_cast<const char*>(f.Data()), f.Size(), clock, now, options, sink,
+                       report);
+}
+
+#ifndef _WIN32
+bool FdLogSink::Write(const LogSpan* spans, size_t count)
+{
+    iovec iov[IOV_MAX < 1024 ? IOV_MAX : 1024];
+    const size_t cap = sizeof(iov) / sizeof(iov[0]);
+    size_t skip = 0;   // уже записано из spans[0]
+    while (count)
+    {
+        size_t n = 0;
+        for (; n < count && n < cap; ++n)
+        {
+            iov[n].iov_base = const_cast<char*>(spans[n].data) + (n ? 0 : skip);
+            iov[n].iov_len = spans[n].size - (n ? 0 : skip);
+        }
+        ssize_t w = writev(m_fd, iov, static_cast<int>(n));
+        if (w < 0 && errno == EINTR) continue;
+        if (w < 0) return false;
+        // Запись могла быть частичной: сдвигаемся на записанное
+        size_t done = static_cast<size_t>(w) + skip;
+        while (count && done >= spans->size)
+        {
+            done -= spans->size;
+            ++spans;
+            --count;
+        }
+        skip = done;
+        if (w == 0 && count) return false;
+    }
+    return true;
+}
+#endif
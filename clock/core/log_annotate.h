@@ -0,0 +1,74 @@
+#pragma once
+// -----------------------------------------------------------------------------
+// Разметка логов игровым временем.
+//
+// В строке, которая начинается с метки реального времени
+//   2025-03-11 18:42:59[.125][Z|+03:00]   (или 'T' вместо пробела,
+//                                          или вся метка в [квадратных скобках])
+// сразу за меткой вставляется игровое время по тем же часам, что в окне:
+//   2025-03-11 18:42:59 [day -2 07:30] остаток строки
+// Сутки считаются от текущих игровых суток (0 — сегодня, -1 — вчера), как
+// и в расписаниях (schedule_import.h).
+// Остальные строки проходят без изменений.
+//
+// Файл отображается в память и делится на куски по границам строк; куски
+// разбираются параллельно, метки переводятся пачкой (GameClock::GameMinutes),
+// результат пишется по порядку окнами. Вывод — список отрезков: куски
+// исходного файла и вставки между ними, сам текст лога не копируется.
+// -----------------------------------------------------------------------------
+#include <cstddef>
+#include <cstdint>
+#include "file_io.h"
+#include "game_time.h"
+
+// Самая длинная вставка: " [day -9223372036854775808 HH:MM]"
+const size_t LOG_NOTE_MAX_LEN = 40;
+
+struct LogAnnotateOptions {
+    int64_t  utcOffset = 0;   // смещение меток без зоны от UTC, тики
+    unsigned threads = 0;     // 0 — по числу ядер
+};
+
+struct LogAnnotateReport {
+    size_t   lines = 0;
+    size_t   annotated = 0;   // строк с меткой времени
+    uint64_t bytesOut = 0;
+};
+
+// Отрезок вывода
+struct LogSpan {
+    const char* data;
+    size_t      size;
+};
+
+class LogSink {
+public:
+    virtual ~LogSink() = default;
+    // Отрезки по порядку; false — ошибка записи
+    virtual bool Write(const LogSpan* spans, size_t count) = 0;
+};
+
+#ifndef _WIN32
+// Дескриптор файла или канала: writev без промежуточного буфера
+class FdLogSink : public LogSink {
+public:
+    explicit FdLogSink(int fd) : m_fd(fd) {}
+    bool Write(const LogSpan* spans, size_t count) override;
+
+private:
+    int m_fd;
+};
+#endif
+
+// Метка времени в начале [p, end): тики FILETIME в *ticks, возвращает
+// указатель за меткой (за ']', если она в скобках) или nullptr.
+// utcOffset применяется, только если зона в метке не указана.
+const char* ParseLogTimestamp(const char* p, const char* end, int64_t utcOffset, int64_t* ticks);
+
+// Разметка всего образа; сутки — от игровых суток часов в момент now.
+// false — ошибка записи
+bool AnnotateLog(const char* data, size_t size, const GameClock& clock, int64_t now,
+                 const LogAnnotateOptions& options, LogSink* sink, LogAnnotateReport* report);
+
+bool AnnotateLogFile(const NativePath& input, const GameClock& clock, int64_t now,
+                     const LogAnnotateOptions& options, LogSink* sink, LogAnnotateReport* report);
@@ -0,0 +1,68 @@
+#include "rate_profile.h"
+#include <cstring>
+
+typedef RateProfile<std::ratio<60>, MINUTES_IN_DAY>     RealTimeRate;   // 1:1
+typedef RateProfile<std::ratio<2>, MINUTES_IN_DAY>      FastRate;       // 30x
+typedef RateProfile<std::ratio<5>, 600>                 ShortDayRate;   // 10-часовые сутки
+typedef RateProfile<std::ratio<1, 4>, MINUTES_IN_DAY>   TestRate;       // сутки за 6 минут
+
+static const RateProfileInfo PROFILES[] = {
+    { "default",  "8.75 s per game minute, 1440-minute day",
+      DefaultRate::TICKS_PER_MINUTE,  DefaultRate::MINUTES_PER_DAY,  ReadClockFixed<DefaultRate> },
+    { "realtime", "game time runs at wall-clock speed",
+      RealTimeRate::TICKS_PER_MINUTE, RealTimeRate::MINUTES_PER_DAY, ReadClockFixed<RealTimeRate> },
+    { "fast",     "2 s per game minute, 1440-minute day",
+      FastRate::TICKS_PER_MINUTE,     FastRate::MINUTES_PER_DAY,     ReadClockFixed<FastRate> },
+    { "shortday", "5 s per game minute, 600-minute day",
+      ShortDayRate::TICKS_PER_MINUTE, ShortDayRate::MINUTES_PER_DAY, ReadClockFixed<ShortDayRate> },
+    { "test",     "0.25 s per game minute, a game day in 6 minutes",
+      TestRate::TICKS_PER_MINUTE,     TestRate::MINUTES_PER_DAY,     ReadClockFixed<TestRate> },
+};
+
+void ReadClockGeneric(const GameClockState& s, const int64_t* now, size_t n, ClockReading* out)
+{
+    GameClock c(s);
+    for (size_t i = 0; i < n; ++i)
+    {
+        out[i].minuteOfDay       = c.MinuteOfDay(now[i]);
+        out[i].minutesToMidnight = s.minutesPerDay - out[i].minuteOfDay;
+        out[i].ticksToMidnight   = c.TicksToMidnight(now[i]);
+        out[i].gameMinute        = c.GameMinute(now[i]);
+    }
+}
+
+const RateProfileInfo* RateProfiles(size_t* count)
+{
+    *count = sizeof(PROFILES) / sizeof(PROFILES[0]);
+    return PROFILES;
+}
+
+const RateProfileInfo* FindRateProfile(const char* name)
+{
+    for (const RateProfileInfo& p : PROFILES)
+        if (!std::strcmp(p.name, name)) return &p;
+    return nullptr;
+}
+
+const RateProfileInfo* MatchRateProfile(const GameClockState& s)
+{
+    for (const RateProfileInfo& p : PROFILES)
+        if (p.ticksPerMinute == s.ticksPerMinute && p.minutesPerDay == s.minutesPerDay) return &p;
+    return nullptr;
+}
+
+ReadClockFn SelectReadClock(const GameClockState& s)
+{
+    const RateProfileInfo* p = MatchRateProfile(s);
+    return p ? p->read : ReadClockGeneric;
+}
+
+void ApplyRateProfile(GameClock* clock, const RateProfileInfo& profile, int64_t now)
+{
+    int minute = clock->MinuteOfDay(now);
+    GameClockState s = clock->State();
+    s.ticksPerMinute = profile.ticksPerMinute;
+    s.minutesPerDay = profile.minutesPerDay;
+    clock->SetState(s);
+    clock->SetGameTime(now, minute % profile.minutesPerDay);
+}
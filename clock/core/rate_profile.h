@@ -0,0 +1,123 @@
+#pragma once
+// -----------------------------------------------------------------------------
+// Профили скорости игрового времени, известные при компиляции.
+//
+// RateProfile<длина игровой минуты в секундах (std::ratio), минут в сутках>
+// превращает деления и остатки на длину минуты и суток в деления на
+// константы, которые компилятор заменяет умножением. Реестр по имени профиля
+// выдаёт функцию пакетного чтения, собранную именно под него; для скорости,
+// которой нет в реестре, остаётся общий путь с делением на переменную.
+// -----------------------------------------------------------------------------
+#include <cstddef>
+#include <cstdint>
+#include <ratio>
+#include "game_time.h"
+
+template <typename MinuteSeconds, int DayMinutes>
+struct RateProfile {
+    static_assert(MinuteSeconds::num > 0 && DayMinutes > 0, "rate must be positive");
+    static_assert(TICKS_PER_SECOND * MinuteSeconds::num % MinuteSeconds::den == 0,
+                  "game minute must be a whole number of 100 ns ticks");
+
+    static constexpr int64_t TICKS_PER_MINUTE = TICKS_PER_SECOND * MinuteSeconds::num / MinuteSeconds::den;
+    static constexpr int32_t MINUTES_PER_DAY  = DayMinutes;
+    static constexpr int64_t TICKS_PER_DAY    = TICKS_PER_MINUTE * DayMinutes;
+
+    static bool Matches(const GameClockState& s)
+    {
+        return s.ticksPerMinute == TICKS_PER_MINUTE && s.minutesPerDay == MINUTES_PER_DAY;
+    }
+};
+
+// Скорость по умолчанию: игровая минута — 8.75 сек, сутки — 1440 минут
+typedef RateProfile<std::ratio<35, 4>, MINUTES_IN_DAY> DefaultRate;
+static_assert(DefaultRate::TICKS_PER_MINUTE == GAME_MINUTE_TICKS, "default rate drifted");
+
+// То же, что GameClock, но длина минуты и суток — константы профиля
+template <typename Profile>
+class FixedRateClock {
+public:
+    FixedRateClock() = default;
+    FixedRateClock(int64_t start, int64_t offset) : m_start(start), m_offset(offset) {}
+    explicit FixedRateClock(const GameClockState& s) : m_start(s.start), m_offset(s.offset) {}
+
+    GameClockState State() const
+    {
+        GameClockState s;
+        s.start = m_start;
+        s.offset = m_offset;
+        s.ticksPerMinute = Profile::TICKS_PER_MINUTE;
+        s.minutesPerDay = Profile::MINUTES_PER_DAY;
+        return s;
+    }
+
+    int64_t GameTicks(int64_t now) const { return now - m_start + m_offset; }
+    int64_t GameMinute(int64_t now) const { return FloorDiv(GameTicks(now), Profile::TICKS_PER_MINUTE); }
+    int64_t GameDay(int64_t now) const { return FloorDiv(GameTicks(now), Profile::TICKS_PER_DAY); }
+    int     MinuteOfDay(int64_t now) const
+    {
+        return static_cast<int>(FloorMod(GameTicks(now), Profile::TICKS_PER_DAY) / Profile::TICKS_PER_MINUTE);
+    }
+    int64_t DeadlineOf(int64_t gameMinute) const
+    {
+        return m_start - m_offset + gameMinute * Profile::TICKS_PER_MINUTE;
+    }
+    int     MinutesToMidnight(int64_t now) const { return Profile::MINUTES_PER_DAY - MinuteOfDay(now); }
+    int64_t TicksToMidnight(int64_t now) const
+    {
+        return Profile::TICKS_PER_DAY - FloorMod(GameTicks(now), Profile::TICKS_PER_DAY);
+    }
+
+private:
+    int64_t m_start = 0;
+    int64_t m_offset = 0;
+};
+
+// -----------------------------------------------------------------------------
+// Пакетное чтение часов и реестр профилей
+// -----------------------------------------------------------------------------
+struct ClockReading {
+    int32_t minuteOfDay;
+    int32_t minutesToMidnight;
+    int64_t ticksToMidnight;
+    int64_t gameMinute;
+};
+
+// Показания одних часов в моменты now[0..n)
+typedef void (*ReadClockFn)(const GameClockState& s, const int64_t* now, size_t n, ClockReading* out);
+
+template <typename Profile>
+void ReadClockFixed(const GameClockState& s, const int64_t* now, size_t n, ClockReading* out)
+{
+    FixedRateClock<Profile> c(s);
+    for (size_t i = 0; i < n; ++i)
+    {
+        out[i].minuteOfDay       = c.MinuteOfDay(now[i]);
+        out[i].minutesToMidnight = Profile::MINUTES_PER_DAY - out[i].minuteOfDay;
+        out[i].ticksToMidnight   = c.TicksToMidnight(now[i]);
+        out[i].gameMinute        = c.GameMinute(now[i]);
+    }
+}
+
+// Общий путь: длина минуты и суток берутся из состояния
+void ReadClockGeneric(const GameClockState& s, const int64_t* now, size_t n, ClockReading* out);
+
+struct RateProfileInfo {
+    const char* name;
+    const char* description;
+    int64_t     ticksPerMinute;
+    int32_t     minutesPerDay;
+    ReadClockFn read;
+};
+
+const RateProfileInfo* RateProfiles(size_t* count);
+const RateProfileInfo* FindRateProfile(const char* name);
+
+// Профиль с той же скоростью, что у состояния; nullptr — такого нет
+const RateProfileInfo* MatchRateProfile(const GameClockState& s);
+
+// Специализированная функция чтения, если скорость есть в реестре, иначе общая
+ReadClockFn SelectReadClock(const GameClockState& s);
+
+// Переводит часы на скорость профиля, сохраняя текущее игровое время суток
+void ApplyRateProfile(GameClock* clock, const RateProfileInfo& profile, int64_t now);
@@ -0,0 +1,384 @@
+#include "schedule_import.h"
+#include <algorithm>
+#include <cstring>
+#include <thread>
+#include "time_format.h"
+#include "time_parse.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define WRCLOCK_SSE2 1
+#include <emmintrin.h>
+#endif
+
+static const size_t  CHUNK_BYTES = 4u << 20;   // кусок на поток в одном окне
+
+// -----------------------------------------------------------------------------
+// Поиск разделителей
+// -----------------------------------------------------------------------------
+#if defined(__GNUC__) || defined(__clang__)
+static inline int LowestBit(unsigned v) { return __builtin_ctz(v); }
+#else
+#include <intrin.h>
+static inline int LowestBit(unsigned v) { unsigned long i; _BitScanForward(&i, v); return static_cast<int>(i); }
+#endif
+
+// Первый байт a или b в [p, end), иначе end
+static inline const char* FindEither(const char* p, const char* end, char a, char b)
+{
+#if defined(WRCLOCK_SSE2)
+    const __m128i va = _mm_set1_epi8(a);
+    const __m128i vb = _mm_set1_epi8(b);
+    for (; p + 16 <= end; p += 16)
+    {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        unsigned mask = static_cast<unsigned>(
+            _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(v, va), _mm_cmpeq_epi8(v, vb))));
+        if (mask) return p + LowestBit(mask);
+    }
+#endif
+    for (; p < end; ++p)
+        if (*p == a || *p == b) return p;
+    return end;
+}
+
+static inline const char* FindLineEnd(const char* p, const char* end)
+{
+    const void* q = std::memchr(p, '\n', static_cast<size_t>(end - p));
+    return q ? static_cast<const char*>(q) : end;
+}
+
+// -----------------------------------------------------------------------------
+// Поля
+// -----------------------------------------------------------------------------
+static inline void Trim(const char*& p, const char*& end)
+{
+    while (p < end && (*p == ' ' || *p == '\t')) ++p;
+    while (end > p && (end[-1] == ' ' || end[-1] == '\t' || end[-1] == '\r')) --end;
+}
+
+bool ParseDayField(const char* p, size_t n, int64_t* day)
+{
+    const char* end = p + n;
+    Trim(p, end);
+    bool neg = false;
+    if (p < end && (*p == '-' || *p == '+')) neg = *p++ == '-';
+    if (p == end || end - p > 6) return false;
+    int64_t v = 0;
+    for (; p < end; ++p)
+    {
+        unsigned d = static_cast<unsigned>(*p - '0');
+        if (d > 9) return false;
+        v = v * 10 + d;
+    }
+    *day = neg ? -v : v;
+    return true;
+}
+
+bool ParseTimeField(const char* p, size_t n, int* minuteOfDay)
+{
+    if (n == 5 && ParseHHMM5(p, minuteOfDay)) return true;
+    const char* end = p + n;
+    Trim(p, end);
+    const char* q = ParseClockText(p, end, minuteOfDay);
+    return q && q == end;
+}
+
+// -----------------------------------------------------------------------------
+// Разбор строк
+// -----------------------------------------------------------------------------
+namespace {
+
+struct ImportContext {
+    const GameClock* clock;
+    int64_t          baseMinute;   // первая минута "сегодняшних" игровых суток
+    int64_t          minutesPerDay;
+    ScheduleLayout   layout;
+    int              lastColumn;   // последнее нужное поле
+    bool             format;       // формировать вывод (есть sink)
+};
+
+struct Chunk {
+    const char* begin = nullptr;
+    const char* end = nullptr;
+    size_t lines = 0;
+    size_t rows = 0;
+    size_t skipped = 0;
+    std::vector<ScheduleError> errors;   // номера строк от начала куска
+    std::vector<char>          out;
+};
+
+enum RowResult { ROW_OK, ROW_EMPTY, ROW_BAD_FIELDS, ROW_BAD_TIME, ROW_BAD_DAY };
+
+const char* const ROW_ERRORS[] = {
+    "", "", "missing time or day column", "bad time (expected HH:MM)", "bad day number",
+};
+
+}
+
+// Поля нужных колонок строки [p, end) без '\n'
+static RowResult ParseRow(const ImportContext& ctx, const char* p, const char* end, int64_t* at)
+{
+    if (p == end || *p == '#' || (end - p == 1 && *p == '\r')) return ROW_EMPTY;
+
+    const char *timeBegin = nullptr, *timeEnd = nullptr, *dayBegin = nullptr, *dayEnd = nullptr;
+    const char sep = ctx.layout.separator;
+    for (int col = 0; col <= ctx.lastColumn; ++col)
+    {
+        const char* q = FindEither(p, end, sep, sep);
+        if (col == ctx.layout.timeColumn) { timeBegin = p; timeEnd = q; }
+        if (col == ctx.layout.dayColumn) { dayBegin = p; dayEnd = q; }
+        if (q == end && col < ctx.lastColumn) return ROW_BAD_FIELDS;
+        p = q + 1;
+    }
+
+    int minute;
+    if (timeEnd > timeBegin && timeEnd[-1] == '\r') --timeEnd;
+    if (!ParseTimeField(timeBegin, static_cast<size_t>(timeEnd - timeBegin), &minute))
+        return ROW_BAD_TIME;
+    int64_t day = 0;
+    if (dayBegin && !ParseDayField(dayBegin, static_cast<size_t>(dayEnd - dayBegin), &day))
+        return ROW_BAD_DAY;
+    *at = ctx.clock->DeadlineOf(ctx.baseMinute + day * ctx.minutesPerDay + minute);
+    return ROW_OK;
+}
+
+static void ImportChunk(const ImportContext& ctx, Chunk* c)
+{
+    IsoTimeFormatter iso;
+    c->out.clear();
+    if (ctx.format)
+        c->out.reserve(static_cast<size_t>(c->end - c->begin) * 2);
+
+    const char* p = c->begin;
+    while (p < c->end)
+    {
+        const char* nl = FindLineEnd(p, c->end);
+        const char* lineEnd = nl;
+        if (lineEnd > p && lineEnd[-1] == '\r') --lineEnd;
+        ++c->lines;
+
+        int64_t at;
+        RowResult r = ParseRow(ctx, p, lineEnd, &at);
+        if (r == ROW_OK)
+        {
+            ++c->rows;
+            if (ctx.format)
+            {
+                size_t len = static_cast<size_t>(lineEnd - p);
+                size_t old = c->out.size();
+                c->out.resize(old + 24 + 1 + len + 1);
+                char* o = iso.Append(c->out.data() + old, at);
+                *o++ = ctx.layout.separator;
+                std::memcpy(o, p, len);
+                o[len] = '\n';
+            }
+        }
+        else if (r != ROW_EMPTY)
+        {
+            ++c->skipped;
+            if (c->errors.size() < MAX_SCHEDULE_ERRORS)
+                c->errors.push_back(ScheduleError{ c->lines, ROW_ERRORS[r] });
+        }
+        p = nl + 1;
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Разметка по первым строкам
+// -----------------------------------------------------------------------------
+static std::vector<std::pair<const char*, const char*>> SplitFields(const char* p, const char* end, char sep)
+{
+    std::vector<std::pair<const char*, const char*>> fields;
+    for (;;)
+    {
+        const char* q = FindEither(p, end, sep, sep);
+        fields.emplace_back(p, q);
+        if (q == end) return fields;
+        p = q + 1;
+    }
+}
+
+// true — строка подходит как строка данных при такой (или найденной) разметке
+static bool DetectColumns(const char* p, const char* end, ScheduleLayout* l)
+{
+    auto fields = SplitFields(p, end, l->separator);
+    auto isTime = [&](size_t i) {
+        int m;
+        return i < fields.size() &&
+               ParseTimeField(fields[i].first, static_cast<size_t>(fields[i].second - fields[i].first), &m);
+    };
+    auto isDay = [&](size_t i) {
+        int64_t d;
+        return i < fields.size() &&
+               ParseDayField(fields[i].first, static_cast<size_t>(fields[i].second - fields[i].first), &d);
+    };
+
+    int time = l->timeColumn;
+    if (time < 0)
+    {
+        for (size_t i = 0; i < fields.size() && time < 0; ++i)
+            if (isTime(i)) time = static_cast<int>(i);
+        if (time < 0) return false;
+    }
+    else if (!isTime(static_cast<size_t>(time)))
+        return false;
+
+    int day = l->dayColumn;
+    if (day == -2)
+        day = time > 0 && isDay(static_cast<size_t>(time - 1)) ? time - 1 : -1;
+    else if (day >= 0 && !isDay(static_cast<size_t>(day)))
+        return false;
+
+    l->timeColumn = time;
+    l->dayColumn = day;
+    return true;
+}
+
+static char DetectSeparator(const char* p, const char* end)
+{
+    size_t tabs = std::count(p, end, '\t');
+    size_t semis = std::count(p, end, ';');
+    size_t commas = std::count(p, end, ',');
+    if (tabs && tabs >= semis && tabs >= commas) return '\t';
+    if (semis && semis > commas) return ';';
+    return ',';
+}
+
+// -----------------------------------------------------------------------------
+// ImportSchedule
+// -----------------------------------------------------------------------------
+bool ImportSchedule(const char* data, size_t size, const GameClock& clock, int64_t now,
+                    const ScheduleLayout& layout, unsigned threads, ScheduleSink* sink,
+                    ScheduleReport* report)
+{
+    *report = ScheduleReport();
+    const char* end = data + size;
+
+    // Первая значимая строка; если в ней нет времени — это заголовок
+    const char* p = data;
+    size_t line = 0;
+    const char* first = nullptr;
+    const char* firstEnd = nullptr;
+    while (p < end)
+    {
+        const char* nl = FindLineEnd(p, end);
+        const char* le = nl > p && nl[-1] == '\r' ? nl - 1 : nl;
+        ++line;
+        if (le > p && *p != '#') { first = p; firstEnd = le; break; }
+        p = nl + 1;
+    }
+    ScheduleLayout l = layout;
+    if (!first)
+    {
+        report->layout = l;
+        return true;   // пустой файл
+    }
+    if (!l.separator) l.separator = DetectSeparator(first, firstEnd);
+
+    const char* body = first;
+    size_t bodyLine = line - 1;   // строк до начала разбора
+    if (!DetectColumns(first, firstEnd, &l))
+    {
+        report->header = true;
+        const char* nl = FindLineEnd(first, end);
+        body = nl < end ? nl + 1 : end;
+        bodyLine = line;
+        // Разметка — по первой строке данных после заголовка
+        const char* q = body;
+        bool found = false;
+        while (q < end && !found)
+        {
+            const char* qn = FindLineEnd(q, end);
+            const char* qe = qn > q && qn[-1] == '\r' ? qn - 1 : qn;
+            if (qe > q && *q != '#') found = DetectColumns(q, qe, &l);
+            if (qe > q && *q != '#') break;
+            q = qn + 1;
+        }
+        if (!found)
+        {
+            report->layout = l;
+            return false;
+        }
+        if (sink)
+        {
+            std::vector<char> h;
+            const char title[] = "real_time";
+            h.insert(h.end(), title, title + sizeof(title) - 1);
+            h.push_back(l.separator);
+            h.insert(h.end(), first, firstEnd);
+            h.push_back('\n');
+            if (!sink->Write(h.data(), h.size())) return false;
+        }
+    }
+    report->layout = l;
+
+    ImportContext ctx;
+    ctx.clock = &clock;
+    ctx.minutesPerDay = clock.State().minutesPerDay;
+    ctx.baseMinute = clock.GameDay(now) * ctx.minutesPerDay;
+    ctx.layout = l;
+    ctx.lastColumn = std::max(l.timeColumn, l.dayColumn);
+    ctx.format = sink != nullptr;
+
+    if (!threads) threads = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<Chunk> chunks(threads);
+    std::vector<std::thread> pool;
+    size_t linesBefore = bodyLine;
+
+    // Окнами по threads кусков: разбор параллельно, запись по порядку
+    p = body;
+    while (p < end)
+    {
+        size_t used = 0;
+        for (; used < threads && p < end; ++used)
+        {
+            const char* stop = p + std::min(CHUNK_BYTES, static_cast<size_t>(end - p));
+            if (stop < end)
+            {
+                const char* nl = FindLineEnd(stop, end);
+                stop = nl < end ? nl + 1 : end;
+            }
+            Chunk& c = chunks[used];
+            c.begin = p;
+            c.end = stop;
+            c.lines = c.rows = c.skipped = 0;
+            c.errors.clear();
+            p = stop;
+        }
+        for (size_t i = 1; i < used; ++i)
+            pool.emplace_back(ImportChunk, std::cref(ctx), &chunks[i]);
+        ImportChunk(ctx, &chunks[0]);
+        for (auto& t : pool) t.join();
+        pool.clear();
+
+        for (size_t i = 0; i < used; ++i)
+        {
+            Chunk& c = chunks[i];
+            report->rows += c.rows;
+            report->skipped += c.skipped;
+            for (const ScheduleError& e : c.errors)
+            {
+                if (report->errors.size() >= MAX_SCHEDULE_ERRORS) break;
+                report->errors.push_back(ScheduleError{ linesBefore + e.line, e.reason });
+            }
+            linesBefore += c.lines;
+            if (sink && !c.out.empty() && !sink->Write(c.out.data(), c.out.size()))
+                return false;
+        }
+    }
+    return true;
+}
+
+bool ImportScheduleFile(const NativePath& input, const GameClock& clock, int64_t now,
+                        const ScheduleLayout& layout, unsigned threads, ScheduleSink* sink,
+                        ScheduleReport* report)
+{
+    MappedFile f;
+    if (!f.Open(input))
+    {
+        *report = ScheduleReport();
+        return false;
+    }
+    return ImportSchedule(reinterpret_cast<const char*>(f.Data()), f.Size(), clock, now, layout,
+                          threads, sink, report);
+}
@@ -0,0 +1,75 @@
+#pragma once
+// -----------------------------------------------------------------------------
+// Импорт расписаний игровых событий (CSV/TSV) в реальное время.
+//
+// Строка: поля через ',', ';' или табуляцию; в одном поле время "ЧЧ:ММ", в
+// другом (необязательном) — номер игровых суток относительно текущих (0 —
+// сегодня, 1 — завтра). Каждая строка выходит как
+//   2025-03-11T18:42:59.125Z<разделитель><исходная строка>
+// Первая строка, в которой время не разбирается, считается заголовком.
+// Пустые строки и строки с '#' пропускаются; кавычки не разбираются, так что
+// поля дня и времени не должны стоять после поля с разделителем в кавычках.
+//
+// Файл делится на куски по границам строк, куски разбираются параллельно,
+// а результат пишется по порядку окнами, так что память не растёт с файлом.
+// Разделители ищутся по 16 байт за раз (SSE2), "ЧЧ:ММ" разбирается без
+// ветвлений по символам (ParseHHMM5).
+// -----------------------------------------------------------------------------
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "file_io.h"
+#include "game_time.h"
+
+struct ScheduleLayout {
+    char separator  = 0;    // 0 — определить по первой строке
+    int  dayColumn  = -2;   // номер поля с сутками; -1 — нет, -2 — определить
+    int  timeColumn = -1;   // номер поля со временем; -1 — определить
+};
+
+struct ScheduleError {
+    size_t      line;
+    const char* reason;
+};
+
+struct ScheduleReport {
+    ScheduleLayout layout;          // с определёнными значениями
+    size_t rows = 0;                // переведено строк
+    size_t skipped = 0;             // с ошибками
+    bool   header = false;
+    std::vector<ScheduleError> errors;   // первые MAX_SCHEDULE_ERRORS
+};
+
+const size_t MAX_SCHEDULE_ERRORS = 100;
+
+// Куда идёт результат
+class ScheduleSink {
+public:
+    virtual ~ScheduleSink() = default;
+    virtual bool Write(const char* data, size_t size) = 0;
+};
+
+class FileScheduleSink : public ScheduleSink {
+public:
+    explicit FileScheduleSink(OutputFile* file) : m_file(file) {}
+    bool Write(const char* data, size_t size) override { return m_file->Write(data, size); }
+
+private:
+    OutputFile* m_file;
+};
+
+// Поле суток: необязательный знак и до 6 цифр
+bool ParseDayField(const char* p, size_t n, int64_t* day);
+// Поле времени: "HH:MM" быстрым путём, иначе как в диалоге; по краям — пробелы
+bool ParseTimeField(const char* p, size_t n, int* minuteOfDay);
+
+// Перевод всего образа; sink == nullptr — только проверка. threads == 0 —
+// по числу ядер. Сутки считаются от игровых суток часов в момент now.
+// false — не удалось определить разметку или записать результат
+bool ImportSchedule(const char* data, size_t size, const GameClock& clock, int64_t now,
+                    const ScheduleLayout& layout, unsigned threads, ScheduleSink* sink,
+                    ScheduleReport* report);
+
+bool ImportScheduleFile(const NativePath& input, const GameClock& clock, int64_t now,
+                        const ScheduleLayout& layout, unsigned threads, ScheduleSink* sink,
+                        ScheduleReport* report);
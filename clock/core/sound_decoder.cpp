@@ -0,0 +1,320 @@
+#include "sound_decoder.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+template <typename T>
+static inline void Put(uint8_t* p, T v) { std::memcpy(p, &v, sizeof(T)); }
+
+template <typename T>
+static inline T Get(const uint8_t* p)
+{
+    T v;
+    std::memcpy(&v, p, sizeof(T));
+    return v;
+}
+
+static inline uint32_t FourCC(const char (&s)[5])
+{
+    return uint32_t(uint8_t(s[0])) | uint32_t(uint8_t(s[1])) << 8 | uint32_t(uint8_t(s[2])) << 16 |
+           uint32_t(uint8_t(s[3])) << 24;
+}
+
+// -----------------------------------------------------------------------------
+// Разбор WAV
+// -----------------------------------------------------------------------------
+bool ParseWave(const uint8_t* data, size_t size, WaveInfo* info)
+{
+    *info = WaveInfo();
+    if (size < 12 || Get<uint32_t>(data) != FourCC("RIFF") || Get<uint32_t>(data + 8) != FourCC("WAVE"))
+        return false;
+    bool fmt = false;
+    size_t pos = 12;
+    while (pos + 8 <= size)
+    {
+        uint32_t id = Get<uint32_t>(data + pos);
+        size_t len = Get<uint32_t>(data + pos + 4);
+        const uint8_t* body = data + pos + 8;
+        size_t avail = size - pos - 8;
+        if (id == FourCC("fmt "))
+        {
+            if (len < 16 || len > avail) return false;
+            info->format = Get<uint16_t>(body);
+            info->channels = Get<uint16_t>(body + 2);
+            info->sampleRate = Get<uint32_t>(body + 4);
+            info->blockAlign = Get<uint16_t>(body + 12);
+            info->bitsPerSample = Get<uint16_t>(body + 14);
+            if (len >= 20 && Get<uint16_t>(body + 16) >= 2)
+                info->samplesPerBlock = Get<uint16_t>(body + 18);
+            fmt = true;
+        }
+        else if (id == FourCC("fact") && len >= 4 && len <= avail)
+            info->frames = Get<uint32_t>(body);
+        else if (id == FourCC("data"))
+        {
+            // Обрезанный хвост допускаем: берём, сколько есть
+            info->data = body;
+            info->size = std::min(len, avail);
+            return fmt && info->channels > 0;
+        }
+        pos += 8 + len + (len & 1);
+    }
+    return false;
+}
+
+// -----------------------------------------------------------------------------
+// PCM 16 бит
+// -----------------------------------------------------------------------------
+bool PcmWaveDecoder::Accepts(const WaveInfo& info) const
+{
+    return info.format == WAVE_FORMAT_PCM && info.bitsPerSample == 16;
+}
+
+bool PcmWaveDecoder::Decode(const WaveInfo& info, PcmBuffer* out)
+{
+    if (!Accepts(info)) return false;
+    out->channels = info.channels;
+    out->sampleRate = info.sampleRate;
+    size_t frames = info.size / (2 * size_t(info.channels));
+    out->samples.resize(frames * info.channels);
+    std::memcpy(out->samples.data(), info.data, out->Bytes());
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+// IMA ADPCM
+// -----------------------------------------------------------------------------
+static constexpr int16_t IMA_STEPS[89] = {
+    7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28, 31, 34, 37, 41, 45, 50, 55, 60, 66,
+    73, 80, 88, 97, 107, 118, 130, 143, 157, 173, 190, 209, 230, 253, 279, 307, 337, 371, 408,
+    449, 494, 544, 598, 658, 724, 796, 876, 963, 1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066,
+    2272, 2499, 2749, 3024, 3327, 3660, 4026, 4428, 4871, 5358, 5894, 6484, 7132, 7845, 8630,
+    9493, 10442, 11487, 12635, 13899, 15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794,
+    32767,
+};
+static constexpr int8_t IMA_INDEX[16] = { -1, -1, -1, -1, 2, 4, 6, 8, -1, -1, -1, -1, 2, 4, 6, 8 };
+
+// Приращение и следующий индекс шага для каждой пары (индекс, код):
+// декодер обходится без ветвлений по битам кода
+struct ImaTable {
+    int32_t diff[89][16];
+    uint8_t next[89][16];
+};
+
+static constexpr ImaTable MakeImaTable()
+{
+    ImaTable t{};
+    for (int i = 0; i < 89; ++i)
+        for (int n = 0; n < 16; ++n)
+        {
+            int step = IMA_STEPS[i];
+            int diff = step >> 3;
+            if (n & 1) diff += step >> 2;
+            if (n & 2) diff += step >> 1;
+            if (n & 4) diff += step;
+            t.diff[i][n] = (n & 8) ? -diff : diff;
+            int next = i + IMA_INDEX[n];
+            t.next[i][n] = static_cast<uint8_t>(next < 0 ? 0 : next > 88 ? 88 : next);
+        }
+    return t;
+}
+
+static constexpr ImaTable IMA_TABLE = MakeImaTable();
+
+struct ImaState {
+    int predictor = 0;
+    int index = 0;
+
+    int Expand(unsigned nibble)
+    {
+        predictor = std::min(std::max(predictor + IMA_TABLE.diff[index][nibble], -32768), 32767);
+        index = IMA_TABLE.next[index][nibble];
+        return predictor;
+    }
+
+    unsigned Compress(int sample)
+    {
+        int step = IMA_STEPS[index];
+        int diff = sample - predictor;
+        unsigned nibble = 0;
+        if (diff < 0) { nibble = 8; diff = -diff; }
+        for (unsigned mask = 4; mask; mask >>= 1, step >>= 1)
+            if (diff >= step) { nibble |= mask; diff -= step; }
+        Expand(nibble);   // предсказание должно идти так же, как у декодера
+        return nibble;
+    }
+};
+
+bool ImaAdpcmDecoder::Accepts(const WaveInfo& info) const
+{
+    size_t ch = info.channels;
+    return info.format == WAVE_FORMAT_IMA_ADPCM && info.bitsPerSample == 4 && ch <= 8 &&
+           info.blockAlign > 4 * ch && (info.blockAlign - 4 * ch) % (4 * ch) == 0;
+}
+
+bool ImaAdpcmDecoder::Decode(const WaveInfo& info, PcmBuffer* out)
+{
+    if (!Accepts(info)) return false;
+    const size_t ch = info.channels;
+    const size_t block = info.blockAlign;
+    const size_t perBlock = (block - 4 * ch) * 2 / ch + 1;   // отсчётов на канал в блоке
+    if (info.samplesPerBlock && info.samplesPerBlock != perBlock) return false;
+
+    size_t blocks = info.size / block;
+    size_t frames = blocks * perBlock;
+    if (info.frames) frames = std::min<size_t>(frames, info.frames);
+    out->channels = info.channels;
+    out->sampleRate = info.sampleRate;
+    out->samples.resize(frames * ch);
+
+    int16_t* dst = out->samples.data();
+    size_t left = frames;
+    ImaState state[8];
+    for (size_t b = 0; b < blocks && left; ++b)
+    {
+        const uint8_t* p = info.data + b * block;
+        size_t n = std::min(left, perBlock);
+        // Заголовок канала: первый отсчёт и индекс шага
+        for (size_t c = 0; c < ch; ++c, p += 4)
+        {
+            state[c].predictor = Get<int16_t>(p);
+            state[c].index = std::min<int>(p[2], 88);
+            dst[c] = static_cast<int16_t>(state[c].predictor);
+        }
+        // Дальше группами по 8 отсчётов: 4 байта канала 0, 4 байта канала 1...
+        for (size_t g = 0; (g * 8) + 1 < n; ++g)
+            for (size_t c = 0; c < ch; ++c, p += 4)
+            {
+                ImaState& s = state[c];
+                int16_t* o = dst + (1 + g * 8) * ch + c;
+                size_t count = std::min<size_t>(8, n - 1 - g * 8);
+                for (size_t k = 0; k < count; ++k)
+                {
+                    unsigned byte = p[k >> 1];
+                    o[k * ch] = static_cast<int16_t>(s.Expand((k & 1) ? byte >> 4 : byte & 0x0F));
+                }
+            }
+        dst += n * ch;
+        left -= n;
+    }
+    return true;
+}
+
+SoundDecoder* FindSoundDecoder(const WaveInfo& info)
+{
+    static PcmWaveDecoder pcm;
+    static ImaAdpcmDecoder ima;
+    SoundDecoder* const all[] = { &pcm, &ima };
+    for (SoundDecoder* d : all)
+        if (d->Accepts(info)) return d;
+    return nullptr;
+}
+
+bool DecodeSound(const uint8_t* data, size_t size, PcmBuffer* out)
+{
+    WaveInfo info;
+    if (!ParseWave(data, size, &info)) return false;
+    SoundDecoder* decoder = FindSoundDecoder(info);
+    return decoder && decoder->Decode(info, out);
+}
+
+// -----------------------------------------------------------------------------
+// Кодирование
+// -----------------------------------------------------------------------------
+static uint8_t* PutChunk(uint8_t* p, const char (&id)[5], uint32_t len)
+{
+    Put<uint32_t>(p, FourCC(id));
+    Put<uint32_t>(p + 4, len);
+    return p + 8;
+}
+
+bool EncodeImaAdpcmWave(const PcmBuffer& pcm, uint16_t channelBlock, std::vector<uint8_t>* out)
+{
+    const size_t ch = pcm.channels;
+    if (!ch || ch > 8 || channelBlock < 8 || channelBlock % 4 || channelBlock * ch > 0xFFFF)
+        return false;
+    const size_t block = channelBlock * ch;
+    const size_t perBlock = (block - 4 * ch) * 2 / ch + 1;
+    const size_t frames = pcm.Frames();
+    const size_t blocks = (frames + perBlock - 1) / perBlock;
+
+    const size_t header = 12 + 8 + 20 + 8 + 4 + 8;
+    out->assign(header + blocks * block, 0);
+    uint8_t* p = out->data();
+    p = PutChunk(p, "RIFF", static_cast<uint32_t>(out->size() - 8));
+    Put<uint32_t>(p, FourCC("WAVE"));
+    p = PutChunk(p + 4, "fmt ", 20);
+    Put<uint16_t>(p, WAVE_FORMAT_IMA_ADPCM);
+    Put<uint16_t>(p + 2, pcm.channels);
+    Put<uint32_t>(p + 4, pcm.sampleRate);
+    Put<uint32_t>(p + 8, static_cast<uint32_t>(uint64_t(pcm.sampleRate) * block / perBlock));
+    Put<uint16_t>(p + 12, static_cast<uint16_t>(block));
+    Put<uint16_t>(p + 14, 4);
+    Put<uint16_t>(p + 16, 2);
+    Put<uint16_t>(p + 18, static_cast<uint16_t>(perBlock));
+    p = PutChunk(p + 20, "fact", 4);
+    Put<uint32_t>(p, static_cast<uint32_t>(frames));
+    p = PutChunk(p + 4, "data", static_cast<uint32_t>(blocks * block));
+
+    // Последний неполный блок добивается последним отсчётом
+    auto sample = [&](size_t frame, size_t c) {
+        return frames ? pcm.samples[std::min(frame, frames - 1) * ch + c] : 0;
+    };
+    ImaState state[8];
+    for (size_t b = 0; b < blocks; ++b)
+    {
+        size_t first = b * perBlock;
+        for (size_t c = 0; c < ch; ++c, p += 4)
+        {
+            state[c].predictor = sample(first, c);
+            Put<int16_t>(p, static_cast<int16_t>(state[c].predictor));
+            p[2] = static_cast<uint8_t>(state[c].index);
+            p[3] = 0;
+        }
+        for (size_t g = 0; g * 8 + 1 < perBlock; ++g)
+            for (size_t c = 0; c < ch; ++c, p += 4)
+                for (size_t k = 0; k < 8; ++k)
+                {
+                    unsigned nibble = state[c].Compress(sample(first + 1 + g * 8 + k, c));
+                    p[k >> 1] = static_cast<uint8_t>(p[k >> 1] | (nibble << ((k & 1) * 4)));
+                }
+    }
+    return true;
+}
+
+void PutPcmWaveHeader(uint8_t* out, uint16_t channels, uint32_t sampleRate, uint32_t dataBytes)
+{
+    uint8_t* p = PutChunk(out, "RIFF", static_cast<uint32_t>(PCM_WAVE_HEADER - 8 + dataBytes));
+    Put<uint32_t>(p, FourCC("WAVE"));
+    p = PutChunk(p + 4, "fmt ", 16);
+    Put<uint16_t>(p, WAVE_FORMAT_PCM);
+    Put<uint16_t>(p + 2, channels);
+    Put<uint32_t>(p + 4, sampleRate);
+    Put<uint32_t>(p + 8, sampleRate * 2u * channels);
+    Put<uint16_t>(p + 12, static_cast<uint16_t>(2 * channels));
+    Put<uint16_t>(p + 14, 16);
+    PutChunk(p + 16, "data", dataBytes);
+}
+
+void EncodePcmWave(const PcmBuffer& pcm, std::vector<uint8_t>* out)
+{
+    out->assign(PCM_WAVE_HEADER + pcm.Bytes(), 0);
+    PutPcmWaveHeader(out->data(), pcm.channels, pcm.sampleRate, static_cast<uint32_t>(pcm.Bytes()));
+    if (pcm.Bytes()) std::memcpy(out->data() + PCM_WAVE_HEADER, pcm.samples.data(), pcm.Bytes());
+}
+
+// -----------------------------------------------------------------------------
+// SoundCache
+// -----------------------------------------------------------------------------
+const std::vector<uint8_t>* SoundCache::Wave()
+{
+    std::call_once(m_once, [this] {
+        using namespace std::chrono;
+        auto t0 = steady_clock::now();
+        PcmBuffer pcm;
+        m_ok = m_data && DecodeSound(m_data, m_size, &pcm);
+        if (m_ok) EncodePcmWave(pcm, &m_wave);
+        m_decodeNs = duration_cast<nanoseconds>(steady_clock::now() - t0).count();
+    });
+    return m_ok ? &m_wave : nullptr;
+}
@@ -0,0 +1,121 @@
+#pragma once
+// -----------------------------------------------------------------------------
+// Звук уведомления: разбор WAV в памяти и декодирование в PCM.
+//
+// Ресурс IDR_NOTIFICATION хранится сжатым (IMA ADPCM, 4 бита на отсчёт —
+// вчетверо меньше PCM; такой WAV понимает и сама Windows) и декодируется
+// прямо из отображённого ресурса при первом проигрывании, без временных
+// файлов. Декодеры подключаются через SoundDecoder: сейчас это PCM 16 бит
+// и IMA ADPCM. Кодировщик ADPCM нужен для подготовки ресурса
+// (wrclock_sound) и бенчмарков.
+// -----------------------------------------------------------------------------
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+const uint16_t WAVE_FORMAT_PCM       = 0x0001;
+const uint16_t WAVE_FORMAT_IMA_ADPCM = 0x0011;
+
+// Отсчёты int16 с чередованием каналов
+struct PcmBuffer {
+    uint16_t channels = 0;
+    uint32_t sampleRate = 0;
+    std::vector<int16_t> samples;
+
+    size_t Frames() const { return channels ? samples.size() / channels : 0; }
+    size_t Bytes() const { return samples.size() * sizeof(int16_t); }
+};
+
+// Заголовок WAV; data указывает внутрь разобранного образа
+struct WaveInfo {
+    uint16_t format = 0;
+    uint16_t channels = 0;
+    uint32_t sampleRate = 0;
+    uint16_t blockAlign = 0;
+    uint16_t bitsPerSample = 0;
+    uint16_t samplesPerBlock = 0;   // только ADPCM
+    uint32_t frames = 0;            // из блока fact, если он есть
+    const uint8_t* data = nullptr;
+    size_t         size = 0;
+};
+
+// RIFF/WAVE с блоками fmt и data; false — не WAV или образ обрезан
+bool ParseWave(const uint8_t* data, size_t size, WaveInfo* info);
+
+// -----------------------------------------------------------------------------
+// Декодеры
+// -----------------------------------------------------------------------------
+class SoundDecoder {
+public:
+    virtual ~SoundDecoder() = default;
+    virtual const char* Name() const = 0;
+    virtual bool Accepts(const WaveInfo& info) const = 0;
+    virtual bool Decode(const WaveInfo& info, PcmBuffer* out) = 0;
+};
+
+class PcmWaveDecoder : public SoundDecoder {
+public:
+    const char* Name() const override { return "pcm16"; }
+    bool Accepts(const WaveInfo& info) const override;
+    bool Decode(const WaveInfo& info, PcmBuffer* out) override;
+};
+
+class ImaAdpcmDecoder : public SoundDecoder {
+public:
+    const char* Name() const override { return "ima-adpcm"; }
+    bool Accepts(const WaveInfo& info) const override;
+    bool Decode(const WaveInfo& info, PcmBuffer* out) override;
+};
+
+// Подходящий встроенный декодер или nullptr
+SoundDecoder* FindSoundDecoder(const WaveInfo& info);
+
+// Разбор и декодирование образа WAV любым подходящим декодером
+bool DecodeSound(const uint8_t* data, size_t size, PcmBuffer* out);
+
+// -----------------------------------------------------------------------------
+// Кодирование
+// -----------------------------------------------------------------------------
+const uint16_t IMA_ADPCM_CHANNEL_BLOCK = 1024;   // байт блока на канал
+
+// WAV IMA ADPCM: блоки по channelBlock * channels байт (channelBlock кратен
+// 4, не меньше 8), блок fact с точным числом отсчётов
+bool EncodeImaAdpcmWave(const PcmBuffer& pcm, uint16_t channelBlock, std::vector<uint8_t>* out);
+// WAV PCM 16 бит — например, для PlaySound(SND_MEMORY)
+void EncodePcmWave(const PcmBuffer& pcm, std::vector<uint8_t>* out);
+// Только заголовок такого WAV (для записи потоком)
+const size_t PCM_WAVE_HEADER = 44;
+void PutPcmWaveHeader(uint8_t* out, uint16_t channels, uint32_t sampleRate, uint32_t dataBytes);
+
+// -----------------------------------------------------------------------------
+// Ленивый кэш
+// -----------------------------------------------------------------------------
+// Помнит только указатель на сжатый образ (ресурс уже отображён в память
+// процесса), декодирует при первом Wave. Хранит звук одной копией — сразу
+// готовым WAV PCM 16 бит для PlaySound(SND_MEMORY): промежуточный PcmBuffer
+// живёт только во время декодирования. Wave можно звать из любого потока.
+class SoundCache {
+public:
+    // Образ должен жить дольше кэша; вызывать до первого Wave
+    void SetSource(const uint8_t* data, size_t size)
+    {
+        m_data = data;
+        m_size = size;
+    }
+
+    // Декодированный звук как образ WAV или nullptr, если образ не разобрался
+    const std::vector<uint8_t>* Wave();
+
+    bool    Decoded() const { return m_ok; }
+    int64_t DecodeNs() const { return m_decodeNs; }
+    size_t  PcmBytes() const { return m_ok ? m_wave.size() - PCM_WAVE_HEADER : 0; }
+
+private:
+    const uint8_t*       m_data = nullptr;
+    size_t               m_size = 0;
+    std::once_flag       m_once;
+    std::vector<uint8_t> m_wave;
+    bool                 m_ok = false;
+    int64_t              m_decodeNs = 0;
+};
@@ -0,0 +1,96 @@
+#pragma once
+// -----------------------------------------------------------------------------
+// Очередь одного писателя и одного читателя без блокировок.
+//
+// Ёмкость — степень двойки, память выделяется один раз в конструкторе;
+// Push/Pop не выделяют памяти и не ждут. Счётчики head/tail только растут
+// и лежат в разных строках кэша; каждая сторона держит копию чужого
+// счётчика и перечитывает его, только когда копия говорит "полно"/"пусто".
+// Пакетные PushSome/PopSome копируют подряд идущие элементы (сэмплы звука).
+// -----------------------------------------------------------------------------
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+template <typename T>
+class SpscQueue {
+public:
+    explicit SpscQueue(size_t capacity)
+    {
+        size_t c = 2;
+        while (c < capacity) c <<= 1;
+        m_items.reset(new T[c]());
+        m_mask = c - 1;
+    }
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    size_t Capacity() const { return m_mask + 1; }
+
+    // Писатель
+    bool TryPush(const T& item) { return PushSome(&item, 1) == 1; }
+    size_t PushSome(const T* items, size_t n)
+    {
+        uint64_t head = m_head.load(std::memory_order_relaxed);
+        if (head - m_tailCache + n > Capacity())
+            m_tailCache = m_tail.load(std::memory_order_acquire);
+        n = std::min<size_t>(n, static_cast<size_t>(Capacity() - (head - m_tailCache)));
+        CopyIn(head, items, n);
+        m_head.store(head + n, std::memory_order_release);
+        return n;
+    }
+    // Свободных мест (для писателя точно, для остальных — оценка)
+    size_t FreeSpace() const
+    {
+        return Capacity() - static_cast<size_t>(m_head.load(std::memory_order_relaxed) -
+                                                m_tail.load(std::memory_order_acquire));
+    }
+
+    // Читатель
+    bool TryPop(T* item) { return PopSome(item, 1) == 1; }
+    size_t PopSome(T* out, size_t n)
+    {
+        uint64_t tail = m_tail.load(std::memory_order_relaxed);
+        if (m_headCache - tail < n)
+            m_headCache = m_head.load(std::memory_order_acquire);
+        n = std::min<size_t>(n, static_cast<size_t>(m_headCache - tail));
+        CopyOut(tail, out, n);
+        m_tail.store(tail + n, std::memory_order_release);
+        return n;
+    }
+    // Элементов в очереди (для читателя точно, для остальных — оценка)
+    size_t Size() const
+    {
+        return static_cast<size_t>(m_head.load(std::memory_order_acquire) -
+                                   m_tail.load(std::memory_order_relaxed));
+    }
+    // Всего прочитано с начала — позиция читателя в потоке
+    uint64_t Popped() const { return m_tail.load(std::memory_order_acquire); }
+    uint64_t Pushed() const { return m_head.load(std::memory_order_acquire); }
+
+private:
+    void CopyIn(uint64_t pos, const T* src, size_t n)
+    {
+        size_t at = static_cast<size_t>(pos & m_mask);
+        size_t first = std::min(n, Capacity() - at);
+        std::copy(src, src + first, m_items.get() + at);
+        std::copy(src + first, src + n, m_items.get());
+    }
+    void CopyOut(uint64_t pos, T* dst, size_t n) const
+    {
+        size_t at = static_cast<size_t>(pos & m_mask);
+        size_t first = std::min(n, Capacity() - at);
+        std::copy(m_items.get() + at, m_items.get() + at + first, dst);
+        std::copy(m_items.get(), m_items.get() + (n - first), dst + first);
+    }
+
+    std::unique_ptr<T[]> m_items;
+    size_t               m_mask = 0;
+
+    alignas(64) std::atomic<uint64_t> m_head{ 0 };   // писатель
+    uint64_t                          m_tailCache = 0;
+    alignas(64) std::atomic<uint64_t> m_tail{ 0 };   // читатель
+    uint64_t                          m_headCache = 0;
+};
@@ -0,0 +1,252 @@
+#include "state_journal.h"
+#include <chrono>
+#include <cstring>
+#include "clock_source.h"
+#include "crc32.h"
+
+static const uint32_t JOURNAL_MAGIC   = 0x4A435257;   // "WRCJ"
+static const uint32_t JOURNAL_VERSION = 1;
+static const uint16_t PAYLOAD_SIZE    = JOURNAL_RECORD_SIZE - 8;
+
+template <typename T>
+static inline void Put(uint8_t* p, T v) { std::memcpy(p, &v, sizeof(T)); }
+template <typename T>
+static inline T Get(const uint8_t* p) { T v; std::memcpy(&v, p, sizeof(T)); return v; }
+
+static void EncodeRecord(const JournalEntry& e, uint8_t* r)
+{
+    std::memset(r, 0, JOURNAL_RECORD_SIZE);
+    Put<uint16_t>(r + 4, e.kind);
+    Put<uint16_t>(r + 6, PAYLOAD_SIZE);
+    Put<int64_t>(r + 8, e.at);
+    Put<int64_t>(r + 16, e.state.start);
+    Put<int64_t>(r + 24, e.state.offset);
+    Put<int64_t>(r + 32, e.state.ticksPerMinute);
+    Put<int32_t>(r + 40, e.state.minutesPerDay);
+    Put<uint32_t>(r, Crc32(r + 4, JOURNAL_RECORD_SIZE - 4));
+}
+
+static bool DecodeRecord(const uint8_t* r, JournalEntry* e)
+{
+    if (Get<uint16_t>(r + 6) != PAYLOAD_SIZE) return false;
+    if (Get<uint32_t>(r) != Crc32(r + 4, JOURNAL_RECORD_SIZE - 4)) return false;
+    e->kind                 = Get<uint16_t>(r + 4);
+    e->at                   = Get<int64_t>(r + 8);
+    e->state.start          = Get<int64_t>(r + 16);
+    e->state.offset         = Get<int64_t>(r + 24);
+    e->state.ticksPerMinute = Get<int64_t>(r + 32);
+    e->state.minutesPerDay  = Get<int32_t>(r + 40);
+    return e->state.ticksPerMinute > 0 && e->state.minutesPerDay > 0;
+}
+
+void ParseJournal(const uint8_t* data, size_t size, JournalLoad* out)
+{
+    *out = JournalLoad();
+    out->fileBytes = size;
+    if (size < JOURNAL_HEADER_SIZE || Get<uint32_t>(data) != JOURNAL_MAGIC ||
+        Get<uint32_t>(data + 4) != JOURNAL_VERSION)
+        return;
+    out->validBytes = JOURNAL_HEADER_SIZE;
+
+    // Запись только дописывается, так что повреждён может быть лишь хвост:
+    // ищем с конца последнюю запись с верной суммой, не проверяя все подряд
+    size_t n = (size - JOURNAL_HEADER_SIZE) / JOURNAL_RECORD_SIZE;
+    const uint8_t* records = data + JOURNAL_HEADER_SIZE;
+    while (n && !DecodeRecord(records + (n - 1) * JOURNAL_RECORD_SIZE, &out->last))
+        --n;
+    if (!n) return;
+
+    out->found = true;
+    out->records = n;
+    out->validBytes = JOURNAL_HEADER_SIZE + n * JOURNAL_RECORD_SIZE;
+    for (size_t i = 0; i < n; ++i)
+        out->checkpoints += Get<uint16_t>(records + i * JOURNAL_RECORD_SIZE + 4) == JOURNAL_CHECKPOINT;
+}
+
+bool LoadJournal(const NativePath& path, JournalLoad* out)
+{
+    MappedFile f;
+    if (!f.Open(path)) { *out = JournalLoad(); return false; }
+    ParseJournal(f.Data(), f.Size(), out);
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+// StateJournal
+// -----------------------------------------------------------------------------
+bool StateJournal::WriteHeader(OutputFile& f)
+{
+    uint8_t h[JOURNAL_HEADER_SIZE] = {};
+    Put<uint32_t>(h, JOURNAL_MAGIC);
+    Put<uint32_t>(h + 4, JOURNAL_VERSION);
+    return f.Write(h, sizeof(h));
+}
+
+bool StateJournal::Open(const NativePath& path, JournalLoad* loaded)
+{
+    m_path = path;
+    JournalLoad load;
+    LoadJournal(path, &load);
+    if (loaded) *loaded = load;
+
+    if (load.validBytes < JOURNAL_HEADER_SIZE)
+    {
+        // Нет файла или чужой формат — начинаем заново
+        if (!m_file.Open(path, true) || !WriteHeader(m_file)) return false;
+        m_records = m_checkpoints = 0;
+        return true;
+    }
+    if (!m_file.Open(path, false)) return false;
+    if (load.validBytes != load.fileBytes && !m_file.Truncate(load.validBytes)) return false;
+    m_records = load.records;
+    m_checkpoints = load.checkpoints;
+    return true;
+}
+
+bool StateJournal::Append(const JournalEntry& e, bool sync)
+{
+    uint8_t r[JOURNAL_RECORD_SIZE];
+    EncodeRecord(e, r);
+    if (!m_file.Write(r, sizeof(r))) return false;
+    ++m_records;
+    if (e.kind == JOURNAL_CHECKPOINT) ++m_checkpoints;
+    return !sync || m_file.Sync();
+}
+
+bool StateJournal::Compact(const JournalEntry& latest)
+{
+    NativePath tmp = m_path;
+    tmp.push_back('.');
+    tmp.push_back('t');
+    tmp.push_back('m');
+    tmp.push_back('p');
+
+    // Контрольные точки выбрасываются, история установок времени остаётся
+    std::vector<uint8_t> image;
+    size_t kept = 0;
+    {
+        MappedFile old;
+        JournalLoad load;
+        if (old.Open(m_path))
+        {
+            ParseJournal(old.Data(), old.Size(), &load);
+            for (size_t i = 0; i < load.records; ++i)
+            {
+                const uint8_t* r = old.Data() + JOURNAL_HEADER_SIZE + i * JOURNAL_RECORD_SIZE;
+                if (Get<uint16_t>(r + 4) == JOURNAL_CHECKPOINT) continue;
+                image.insert(image.end(), r, r + JOURNAL_RECORD_SIZE);
+                ++kept;
+            }
+        }
+    }
+    uint8_t r[JOURNAL_RECORD_SIZE];
+    EncodeRecord(latest, r);
+    image.insert(image.end(), r, r + JOURNAL_RECORD_SIZE);
+
+    OutputFile out;
+    if (!out.Open(tmp, true) || !WriteHeader(out) || !out.Write(image.data(), image.size()) ||
+        !out.Sync())
+    {
+        out.Close();
+        RemoveFile(tmp);
+        return false;
+    }
+    out.Close();
+
+    m_file.Close();
+    bool replaced = ReplaceFileAtomic(tmp, m_path);
+    if (!replaced) RemoveFile(tmp);
+    if (!m_file.Open(m_path, false)) return false;
+    if (replaced)
+    {
+        m_records = kept + 1;
+        m_checkpoints = latest.kind == JOURNAL_CHECKPOINT ? 1 : 0;
+    }
+    return replaced;
+}
+
+// -----------------------------------------------------------------------------
+// JournalWriter
+// -----------------------------------------------------------------------------
+bool JournalWriter::Start(const NativePath& path, const GameClockState& state, int64_t now,
+                          int64_t interval, size_t compactAfter)
+{
+    Stop();
+    if (!m_journal.Open(path)) return false;
+    m_state = state;
+    m_at = now;
+    m_mono = MonotonicTicksNow();
+    m_interval = interval;
+    m_compactAfter = compactAfter;
+    m_stop = false;
+
+    // Стартовая контрольная точка пишется уже фоновым потоком
+    JournalEntry e;
+    e.kind = JOURNAL_CHECKPOINT;
+    e.at = now;
+    e.state = state;
+    m_queue.assign(1, e);
+
+    m_thread = std::thread(&JournalWriter::Run, this);
+    return true;
+}
+
+void JournalWriter::Record(uint16_t kind, const GameClockState& state, int64_t at)
+{
+    {
+        std::lock_guard<std::mutex> g(m_lock);
+        JournalEntry e;
+        e.kind = kind;
+        e.at = at;
+        e.state = state;
+        m_queue.push_back(e);
+        m_state = state;
+        m_at = at;
+        m_mono = MonotonicTicksNow();
+    }
+    m_wake.notify_one();
+}
+
+void JournalWriter::Stop()
+{
+    if (!m_thread.joinable()) return;
+    {
+        std::lock_guard<std::mutex> g(m_lock);
+        m_stop = true;
+    }
+    m_wake.notify_one();
+    m_thread.join();
+    m_journal.Close();
+}
+
+void JournalWriter::Run()
+{
+    std::vector<JournalEntry> batch;
+    std::unique_lock<std::mutex> lock(m_lock);
+    for (;;)
+    {
+        auto period = std::chrono::microseconds(m_interval / 10);
+        bool woke = m_wake.wait_for(lock, period, [&] { return m_stop || !m_queue.empty(); });
+        batch.swap(m_queue);
+        GameClockState state = m_state;
+        int64_t at = m_at + MonotonicTicksNow() - m_mono;
+        bool stop = m_stop;
+        lock.unlock();
+
+        // Установка времени сразу уходит на диск, контрольные точки — как получится
+        for (const JournalEntry& e : batch)
+            m_journal.Append(e, e.kind != JOURNAL_CHECKPOINT);
+        batch.clear();
+
+        JournalEntry e;
+        e.kind = JOURNAL_CHECKPOINT;
+        e.at = at;
+        e.state = state;
+        if (!woke || stop)
+            m_journal.Append(e, stop);
+        if (m_journal.Checkpoints() >= m_compactAfter)
+            m_journal.Compact(e);
+        if (stop) return;
+        lock.lock();
+    }
+}
@@ -0,0 +1,106 @@
+#pragma once
+// -----------------------------------------------------------------------------
+// Журнал состояния часов вместо gameclock.ini.
+//
+// Файл: заголовок 16 байт ("WRCJ", версия) и записи по 48 байт:
+//   crc32 u32 | kind u16 | size u16 | at i64 | start i64 | offset i64 |
+//   ticksPerMinute i64 | minutesPerDay i32 | reserved u32
+// Записи только дописываются; при загрузке с конца ищется последняя запись
+// с верной суммой, оборванный хвост после падения отбрасывается. Когда записей становится
+// много, контрольные точки выбрасываются (установки времени остаются) и
+// журнал переписывается во временный файл, который атомарно подменяет старый.
+// -----------------------------------------------------------------------------
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "file_io.h"
+#include "game_time.h"
+
+enum JournalKind : uint16_t {
+    JOURNAL_CHECKPOINT = 1,   // периодическая отметка "часы живы"
+    JOURNAL_SET        = 2,   // время установлено пользователем
+    JOURNAL_CORRECTION = 3,   // автоматическая поправка
+};
+
+struct JournalEntry {
+    uint16_t       kind = JOURNAL_CHECKPOINT;
+    int64_t        at   = 0;      // реальный момент записи (тики FILETIME)
+    GameClockState state;
+};
+
+struct JournalLoad {
+    bool         found = false;   // есть хотя бы одна целая запись
+    JournalEntry last;
+    size_t       records    = 0;
+    size_t       checkpoints = 0;
+    uint64_t     validBytes = 0;  // длина целой части файла
+    uint64_t     fileBytes  = 0;
+};
+
+const size_t JOURNAL_HEADER_SIZE = 16;
+const size_t JOURNAL_RECORD_SIZE = 48;
+
+// Разбор образа журнала в памяти (для отображённого файла)
+void ParseJournal(const uint8_t* data, size_t size, JournalLoad* out);
+
+// Загрузка через отображение файла; false — файла нет
+bool LoadJournal(const NativePath& path, JournalLoad* out);
+
+// Синхронная запись; из UI-потока используется через JournalWriter
+class StateJournal {
+public:
+    // Открывает журнал на дозапись, отрезая повреждённый хвост
+    bool Open(const NativePath& path, JournalLoad* loaded = nullptr);
+    void Close() { m_file.Close(); }
+
+    bool   Append(const JournalEntry& e, bool sync = false);
+    // Переписывает журнал без контрольных точек, добавляя latest в конец
+    bool   Compact(const JournalEntry& latest);
+    size_t Records() const { return m_records; }
+    size_t Checkpoints() const { return m_checkpoints; }
+
+private:
+    bool WriteHeader(OutputFile& f);
+
+    NativePath m_path;
+    OutputFile m_file;
+    size_t     m_records = 0;
+    size_t     m_checkpoints = 0;
+};
+
+// Фоновый писатель: UI только кладёт записи в очередь
+class JournalWriter {
+public:
+    ~JournalWriter() { Stop(); }
+
+    // now — текущее время по источнику владельца часов: от него и от моментов
+    // Record контрольные точки отсчитывают своё at по монотонным часам, так что
+    // в журнале то же время, что у приложения. interval — период контрольных
+    // точек (тики); после compactAfter контрольных точек журнал сжимается
+    bool Start(const NativePath& path, const GameClockState& state, int64_t now,
+               int64_t interval = 60 * TICKS_PER_SECOND, size_t compactAfter = 1024);
+
+    // Новое состояние часов (kind = JOURNAL_SET или JOURNAL_CORRECTION)
+    void Record(uint16_t kind, const GameClockState& state, int64_t at);
+
+    // Последняя контрольная точка, сброс на диск и остановка потока
+    void Stop();
+
+private:
+    void Run();
+
+    StateJournal              m_journal;
+    std::thread               m_thread;
+    std::mutex                m_lock;
+    std::condition_variable   m_wake;
+    std::vector<JournalEntry> m_queue;
+    GameClockState            m_state;
+    int64_t                   m_at = 0;      // последнее время владельца
+    int64_t                   m_mono = 0;    // и монотонные часы в тот момент
+    int64_t                   m_interval = 0;
+    size_t                    m_compactAfter = 0;
+    bool                      m_stop = false;
+};
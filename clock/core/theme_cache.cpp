@@ -0,0 +1,38 @@
+#include "theme_cache.h"
+
+DrawHandle ThemeCache::Get(Kind kind, ThemeColor color, int width)
+{
+    ++m_lookups;
+    for (const Entry& e : m_objects)
+        if (e.kind == kind && e.color == color && e.width == width)
+            return e.handle;
+
+    ++m_misses;
+    DrawHandle h = kind == KIND_BRUSH ? m_backend->CreateBrush(color)
+                                      : m_backend->CreatePen(color, width);
+    if (h) m_objects.push_back({ kind, width, color, h });
+    return h;
+}
+
+ThemeResources ThemeCache::Resources(const Theme& theme)
+{
+    for (const auto& t : m_themes)
+        if (t.first == theme) return t.second;
+
+    // Цвета у тем частично общие (accent) — такие объекты не дублируются
+    ThemeResources r;
+    r.background = Brush(theme.bg);
+    r.button     = Brush(theme.buttonBg);
+    r.pressed    = Brush(theme.accent);
+    r.border     = Pen(theme.accent);
+    m_themes.emplace_back(theme, r);
+    return m_themes.back().second;
+}
+
+void ThemeCache::Clear()
+{
+    for (const Entry& e : m_objects)
+        m_backend->DeleteObject(e.handle);
+    m_objects.clear();
+    m_themes.clear();
+}
@@ -0,0 +1,113 @@
+#pragma once
+// -----------------------------------------------------------------------------
+// Темы оформления и кэш графических объектов для них.
+//
+// Кисти и перья создаются один раз на цвет и живут до Clear(): перерисовка
+// кнопок и переключение тем их больше не пересоздают. Создание объектов идёт
+// через DrawBackend — в окне это GDI, в проверках на Linux — подсчёт вызовов.
+// -----------------------------------------------------------------------------
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+typedef uint32_t ThemeColor;   // раскладка COLORREF: 0x00BBGGRR
+typedef void*    DrawHandle;   // HBRUSH / HPEN
+
+constexpr ThemeColor ThemeRgb(uint8_t r, uint8_t g, uint8_t b)
+{
+    return ThemeColor(r) | (ThemeColor(g) << 8) | (ThemeColor(b) << 16);
+}
+
+// -----------------------------------------------------------------------------
+// Структура темы и две предустановки (светлая/тёмная)
+// -----------------------------------------------------------------------------
+struct Theme {
+    ThemeColor bg;
+    ThemeColor text;
+    ThemeColor buttonBg;
+    ThemeColor buttonText;
+    ThemeColor accent;
+
+    bool operator==(const Theme& o) const
+    {
+        return bg == o.bg && text == o.text && buttonBg == o.buttonBg &&
+               buttonText == o.buttonText && accent == o.accent;
+    }
+};
+constexpr Theme LIGHT_THEME{ ThemeRgb(250,250,250), ThemeRgb(0,0,0),       ThemeRgb(230,230,230), ThemeRgb(0,0,0),       ThemeRgb(0,120,215) };
+constexpr Theme DARK_THEME { ThemeRgb(32,32,32),    ThemeRgb(255,255,255), ThemeRgb(60,60,60),    ThemeRgb(255,255,255), ThemeRgb(0,120,215) };
+
+// Создание и удаление графических объектов
+class DrawBackend {
+public:
+    virtual ~DrawBackend() = default;
+    virtual DrawHandle CreateBrush(ThemeColor color) = 0;
+    virtual DrawHandle CreatePen(ThemeColor color, int width) = 0;
+    virtual void       DeleteObject(DrawHandle h) = 0;
+};
+
+// Всё, что нужно для отрисовки окна и кнопок в одной теме
+struct ThemeResources {
+    DrawHandle background = nullptr;   // кисть bg: фон окна, диалогов, статиков
+    DrawHandle button     = nullptr;   // кисть buttonBg
+    DrawHandle pressed    = nullptr;   // кисть accent: нажатая кнопка
+    DrawHandle border     = nullptr;   // перо accent: рамка кнопки
+};
+
+class ThemeCache {
+public:
+    explicit ThemeCache(DrawBackend* backend) : m_backend(backend) {}
+    ~ThemeCache() { Clear(); }
+    ThemeCache(const ThemeCache&) = delete;
+    ThemeCache& operator=(const ThemeCache&) = delete;
+
+    // Набор объектов для темы; строится при первом обращении
+    ThemeResources Resources(const Theme& theme);
+
+    DrawHandle Brush(ThemeColor color) { return Get(KIND_BRUSH, color, 0); }
+    DrawHandle Pen(ThemeColor color, int width = 1) { return Get(KIND_PEN, color, width); }
+
+    // Удаляет все объекты (при выходе или смене backend)
+    void Clear();
+
+    size_t   Objects() const { return m_objects.size(); }
+    uint64_t Lookups() const { return m_lookups; }
+    uint64_t Misses() const { return m_misses; }
+
+private:
+    enum Kind : uint8_t { KIND_BRUSH, KIND_PEN };
+    struct Entry {
+        Kind       kind;
+        int        width;
+        ThemeColor color;
+        DrawHandle handle;
+    };
+
+    DrawHandle Get(Kind kind, ThemeColor color, int width);
+
+    DrawBackend* m_backend;
+    // Объектов единицы, линейный поиск быстрее любого хэша
+    std::vector<Entry> m_objects;
+    std::vector<std::pair<Theme, ThemeResources>> m_themes;
+    uint64_t m_lookups = 0;
+    uint64_t m_misses = 0;
+};
+
+// Ненастоящие объекты с подсчётом вызовов — для проверок и бенчмарков
+class CountingDrawBackend : public DrawBackend {
+public:
+    DrawHandle CreateBrush(ThemeColor) override { ++brushes; return Next(); }
+    DrawHandle CreatePen(ThemeColor, int) override { ++pens; return Next(); }
+    void DeleteObject(DrawHandle h) override { if (h) ++deleted; }
+
+    uint64_t Created() const { return brushes + pens; }
+    uint64_t Live() const { return Created() - deleted; }
+
+    uint64_t brushes = 0;
+    uint64_t pens = 0;
+    uint64_t deleted = 0;
+
+private:
+    DrawHandle Next() { return reinterpret_cast<DrawHandle>(static_cast<uintptr_t>(Created())); }
+};
@@ -0,0 +1,43 @@
+#include "tick_scheduler.h"
+#include <climits>
+
+int64_t NextDisplayChange(const GameClock& clock, int64_t now, unsigned fields)
+{
+    if (fields & FIELD_REAL_COUNTDOWN)
+    {
+        // Показываются целые секунды floor(остаток / 1 сек): значение меняется,
+        // когда остаток опускается ниже очередной целой секунды. Смена игровой
+        // минуты отдельного пробуждения не получает — она видна на ближайшей
+        // секундной границе (не позже чем через секунду), и пробуждений не
+        // больше одного в секунду. Полночь — граница и минуты, и секунд.
+        int64_t left = clock.TicksToMidnight(now);
+        int64_t step = FloorMod(left, TICKS_PER_SECOND) + 1;
+        return step <= left ? now + step : now + left;
+    }
+    if (fields & (FIELD_TIME | FIELD_COUNTDOWN))
+        return clock.NextMinuteDeadline(now);
+    return INT64_MAX;
+}
+
+TickScheduler::TickScheduler(int64_t now, unsigned fields)
+    : m_wheel(TICKS_PER_SECOND / 1000, now), m_fields(fields)
+{
+}
+
+void TickScheduler::SetVisible(bool visible)
+{
+    if (visible && !m_visible) Invalidate();
+    m_visible = visible;
+}
+
+void TickScheduler::OnDisplayed(const GameClock& clock, int64_t now)
+{
+    m_displayDeadline = NextDisplayChange(clock, now, m_fields);
+}
+
+int64_t TickScheduler::NextWakeup() const
+{
+    int64_t next = m_wheel.NextExpiry();
+    if (m_visible && m_displayDeadline < next) next = m_displayDeadline;
+    return next;
+}
@@ -0,0 +1,59 @@
+#pragma once
+// -----------------------------------------------------------------------------
+// Планировщик пробуждений: вместо опроса раз в секунду спим ровно до момента,
+// когда изменится хотя бы одно из отображаемых значений, а пока окно скрыто —
+// не просыпаемся вовсе. Прочие будильники живут в колесе таймеров.
+// -----------------------------------------------------------------------------
+#include <cstdint>
+#include "game_time.h"
+#include "timer_wheel.h"
+
+// Отображаемые поля часов
+enum ClockField : unsigned {
+    FIELD_TIME           = 1,   // "HH:MM"
+    FIELD_COUNTDOWN      = 2,   // игровые минуты до полуночи
+    FIELD_REAL_COUNTDOWN = 4,   // реальные секунды до полуночи (будит раз в секунду)
+    FIELD_ALL            = 7
+};
+
+// Ближайший момент после now, когда изменится хотя бы одно из полей fields.
+// С FIELD_REAL_COUNTDOWN — только секундные границы: смена минуты
+// показывается на ближайшей из них, до секунды позже
+int64_t NextDisplayChange(const GameClock& clock, int64_t now, unsigned fields);
+
+class TickScheduler {
+public:
+    explicit TickScheduler(int64_t now = 0, unsigned fields = FIELD_ALL);
+
+    void     SetFields(unsigned fields) { m_fields = fields; Invalidate(); }
+    unsigned Fields() const { return m_fields; }
+
+    // При сворачивании экран не обновляется; при восстановлении — сразу догоняем
+    void SetVisible(bool visible);
+    bool Visible() const { return m_visible; }
+
+    // Часы перенастроены — текущая картинка устарела
+    void Invalidate() { m_displayDeadline = INT64_MIN; }
+
+    // Экран показывает состояние на момент now
+    void OnDisplayed(const GameClock& clock, int64_t now);
+    bool DisplayDue(int64_t now) const { return m_visible && now >= m_displayDeadline; }
+
+    // Будильники (напоминания, события календаря и т.п.)
+    void   ArmAlarm(WheelTimer* t, int64_t deadline) { m_wheel.Arm(t, deadline); }
+    void   CancelAlarm(WheelTimer* t) { m_wheel.Cancel(t); }
+    size_t RunAlarms(int64_t now) { return m_wheel.Advance(now); }
+
+    // Начало отсчёта колеса будильников, если при конструировании "сейчас"
+    // ещё не было известно; только пока будильников нет
+    bool Rebase(int64_t now) { return m_wheel.Rebase(now); }
+
+    // Момент следующего пробуждения; INT64_MAX — спать до внешнего события
+    int64_t NextWakeup() const;
+
+private:
+    TimerWheel m_wheel;
+    unsigned   m_fields;
+    bool       m_visible = true;
+    int64_t    m_displayDeadline = INT64_MIN;
+};
@@ -0,0 +1,213 @@
+#include "time_events.h"
+#include <algorithm>
+
+// Игровой час считается от начала суток; в сутках, не кратных 60 минутам,
+// последний час короче
+static int64_t HoursPerDay(int32_t minutesPerDay) { return (minutesPerDay + 59) / 60; }
+
+static int64_t HourIndex(int64_t minute, int32_t minutesPerDay)
+{
+    int64_t day = FloorDiv(minute, minutesPerDay);
+    return day * HoursPerDay(minutesPerDay) + (minute - day * minutesPerDay) / 60;
+}
+
+// Первая минута часа hour
+static int64_t HourStart(int64_t hour, int32_t minutesPerDay)
+{
+    int64_t hours = HoursPerDay(minutesPerDay);
+    int64_t day = FloorDiv(hour, hours);
+    return day * minutesPerDay + (hour - day * hours) * 60;
+}
+
+static bool SameState(const GameClockState& a, const GameClockState& b)
+{
+    return a.start == b.start && a.offset == b.offset && a.ticksPerMinute == b.ticksPerMinute &&
+           a.minutesPerDay == b.minutesPerDay;
+}
+
+TimeEventBus::TimeEventBus(size_t capacity)
+    : m_slots(capacity)
+{
+    m_free.reserve(capacity);
+    for (size_t i = capacity; i-- > 0;) m_free.push_back(static_cast<int>(i));
+    for (std::vector<int>& list : m_lists) list.reserve(capacity);
+}
+
+// -----------------------------------------------------------------------------
+// Подписки
+// -----------------------------------------------------------------------------
+int TimeEventBus::Subscribe(TimeEventKind kind, TimeEventCallback fn, void* ctx, int64_t lead)
+{
+    return fn ? Add(kind, fn, ctx, nullptr, lead) : -1;
+}
+
+int TimeEventBus::Subscribe(TimeEventKind kind, TimeEventQueue* queue, int64_t lead)
+{
+    return queue ? Add(kind, nullptr, nullptr, queue, lead) : -1;
+}
+
+int TimeEventBus::Add(TimeEventKind kind, TimeEventCallback fn, void* ctx, TimeEventQueue* queue, int64_t lead)
+{
+    if (kind >= TIME_EVENT_KINDS || m_free.empty() || lead < 0) return -1;
+    int id = m_free.back();
+    m_free.pop_back();
+    Slot& s = m_slots[id];
+    s.fn = fn;
+    s.ctx = ctx;
+    s.queue = queue;
+    s.lead = kind == TIME_EVENT_BEFORE_MIDNIGHT ? lead : 0;
+    s.dropped = 0;
+    s.kind = kind;
+    s.used = true;
+
+    std::vector<int>& list = m_lists[kind];
+    if (kind != TIME_EVENT_BEFORE_MIDNIGHT)
+    {
+        list.push_back(id);
+        return id;
+    }
+    // Место по сроку; срок, который уже прошёл, в эти сутки не рассылается
+    size_t pos = std::upper_bound(list.begin(), list.end(), lead,
+                                  [this](int64_t l, int other) { return l > m_slots[other].lead; }) -
+                 list.begin();
+    list.insert(list.begin() + pos, id);
+    if (m_primed && (pos < m_cursor || (pos == m_cursor && m_leadMidnight - lead <= m_now))) ++m_cursor;
+    return id;
+}
+
+bool TimeEventBus::Unsubscribe(int id)
+{
+    if (id < 0 || static_cast<size_t>(id) >= m_slots.size() || !m_slots[id].used) return false;
+    Slot& s = m_slots[id];
+    std::vector<int>& list = m_lists[s.kind];
+    size_t pos = std::find(list.begin(), list.end(), id) - list.begin();
+    if (s.kind == TIME_EVENT_BEFORE_MIDNIGHT)
+    {
+        list.erase(list.begin() + pos);
+        if (pos < m_cursor) --m_cursor;
+    }
+    else
+    {
+        list[pos] = list.back();
+        list.pop_back();
+    }
+    s.used = false;
+    m_free.push_back(id);
+    return true;
+}
+
+uint64_t TimeEventBus::Dropped(int id) const
+{
+    return id >= 0 && static_cast<size_t>(id) < m_slots.size() ? m_slots[id].dropped : 0;
+}
+
+// -----------------------------------------------------------------------------
+// Рассылка
+// -----------------------------------------------------------------------------
+void TimeEventBus::Reset(const GameClock& clock, int64_t now)
+{
+    const int32_t mpd = clock.State().minutesPerDay;
+    m_clock = clock;
+    m_primed = true;
+    m_now = now;
+    int64_t minute = clock.GameMinute(now);
+    m_hour = HourIndex(minute, mpd);
+    m_day = FloorDiv(minute, mpd);
+    m_leadDay = m_day + 1;
+    m_leadMidnight = clock.DeadlineOf(m_leadDay * mpd);
+    const std::vector<int>& list = m_lists[TIME_EVENT_BEFORE_MIDNIGHT];
+    m_cursor = 0;
+    while (m_cursor < list.size() && m_leadMidnight - m_slots[list[m_cursor]].lead <= now) ++m_cursor;
+}
+
+void TimeEventBus::Deliver(int id, const TimeEvent& e)
+{
+    Slot& s = m_slots[id];
+    if (s.fn)
+        s.fn(e, s.ctx);
+    else if (!s.queue->TryPush(e))
+    {
+        ++s.dropped;
+        ++m_stats.dropped;
+        return;
+    }
+    ++m_stats.delivered;
+}
+
+void TimeEventBus::DeliverAll(TimeEventKind kind, int64_t gameMinute, int64_t deadline, int64_t skipped,
+                              int64_t now)
+{
+    TimeEvent e{ kind, static_cast<uint16_t>(std::min<int64_t>(skipped, 0xFFFF)), -1, gameMinute, deadline, now };
+    for (int id : m_lists[kind])
+    {
+        e.subscription = id;
+        Deliver(id, e);
+    }
+}
+
+size_t TimeEventBus::Advance(const GameClock& clock, int64_t now)
+{
+    if (!m_primed || now < m_now || !SameState(clock.State(), m_clock.State()))
+    {
+        Reset(clock, now);
+        return 0;
+    }
+    const uint64_t before = m_stats.delivered + m_stats.dropped;
+    const int32_t mpd = clock.State().minutesPerDay;
+    m_now = now;
+    int64_t minute = clock.GameMinute(now);
+
+    int64_t hour = HourIndex(minute, mpd);
+    if (hour != m_hour)
+    {
+        int64_t start = HourStart(hour, mpd);
+        DeliverAll(TIME_EVENT_HOUR, start, clock.DeadlineOf(start), hour - m_hour - 1, now);
+        m_hour = hour;
+    }
+    int64_t day = FloorDiv(minute, mpd);
+    if (day != m_day)
+    {
+        DeliverAll(TIME_EVENT_MIDNIGHT, day * mpd, clock.DeadlineOf(day * mpd), day - m_day - 1, now);
+        m_day = day;
+    }
+
+    const std::vector<int>& list = m_lists[TIME_EVENT_BEFORE_MIDNIGHT];
+    if (m_leadDay <= day)
+    {
+        // Полночь прошла раньше, чем наступили сроки оставшихся подписок
+        m_stats.missed += (list.size() - m_cursor) + (day - m_leadDay) * list.size();
+        m_leadDay = day + 1;
+        m_leadMidnight = clock.DeadlineOf(m_leadDay * mpd);
+        m_cursor = 0;
+    }
+    TimeEvent e{ TIME_EVENT_BEFORE_MIDNIGHT, 0, -1, m_leadDay * mpd, 0, now };
+    while (m_cursor < list.size())
+    {
+        int id = list[m_cursor];
+        e.deadline = m_leadMidnight - m_slots[id].lead;
+        if (e.deadline > now) break;
+        e.subscription = id;
+        Deliver(id, e);
+        ++m_cursor;
+    }
+    return static_cast<size_t>(m_stats.delivered + m_stats.dropped - before);
+}
+
+int64_t TimeEventBus::NextDeadline() const
+{
+    if (!m_primed) return INT64_MIN;
+    const int32_t mpd = m_clock.State().minutesPerDay;
+    int64_t next = INT64_MAX;
+    if (!m_lists[TIME_EVENT_HOUR].empty())
+        next = std::min(next, m_clock.DeadlineOf(HourStart(m_hour + 1, mpd)));
+    if (!m_lists[TIME_EVENT_MIDNIGHT].empty())
+        next = std::min(next, m_clock.DeadlineOf((m_day + 1) * mpd));
+    const std::vector<int>& list = m_lists[TIME_EVENT_BEFORE_MIDNIGHT];
+    if (m_cursor < list.size())
+        next = std::min(next, m_leadMidnight - m_slots[list[m_cursor]].lead);
+    else if (!list.empty())
+        // Сутки разосланы; следующие сроки считаются только после полуночи
+        next = std::min(next, std::max(m_leadMidnight,
+                                       m_clock.DeadlineOf((m_leadDay + 1) * mpd) - m_slots[list[0]].lead));
+    return next;
+}
@@ -0,0 +1,110 @@
+#pragma once
+// -----------------------------------------------------------------------------
+// Подписка на границы игрового времени: начало игрового часа, игровая
+// полночь, "за N реальных секунд до полуночи".
+//
+// Рассылку ведёт владелец часов: Advance(clock, now) из одного потока (окно,
+// сервер) раздаёт все события, срок которых наступил с прошлого вызова, а
+// NextDeadline говорит, когда звать снова — его удобно ставить в
+// TickScheduler::ArmAlarm. Подписчик получает событие либо вызовом функции
+// прямо из Advance, либо через TimeEventQueue (SpscQueue) — так события
+// доходят до других потоков без блокировок. Одна очередь может принадлежать
+// нескольким подпискам: писатель у неё всё равно один — Advance.
+//
+// Слоты подписок выделяются в конструкторе; ни подписка, ни рассылка память
+// не выделяют.
+//
+// После сна или перевода часов вперёд граница каждого вида приходит один
+// раз, в skipped — сколько таких же границ пропущено. "До полуночи" для уже
+// прошедшей полуночи не рассылается, а считается в missed. Если состояние
+// часов сменилось (ввод времени, подгонка скорости), Advance молча
+// начинает отсчёт заново с текущего момента.
+// -----------------------------------------------------------------------------
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "game_time.h"
+#include "spsc_queue.h"
+
+enum TimeEventKind : uint16_t {
+    TIME_EVENT_HOUR            = 0,   // начало игрового часа (в том числе полночь)
+    TIME_EVENT_MIDNIGHT        = 1,   // начало игровых суток
+    TIME_EVENT_BEFORE_MIDNIGHT = 2,   // за lead реальных тиков до полуночи
+    TIME_EVENT_KINDS
+};
+
+struct TimeEvent {
+    uint16_t kind;
+    uint16_t skipped;        // пропущено таких же границ (не больше 65535)
+    int32_t  subscription;
+    int64_t  gameMinute;     // граница: номер игровой минуты (для "до полуночи" — полночи)
+    int64_t  deadline;       // реальный момент события
+    int64_t  now;            // момент рассылки (now в Advance)
+};
+
+using TimeEventQueue    = SpscQueue<TimeEvent>;
+using TimeEventCallback = void (*)(const TimeEvent& e, void* ctx);
+
+struct TimeBusStats {
+    uint64_t delivered = 0;
+    uint64_t dropped   = 0;   // очередь подписчика была полна
+    uint64_t missed    = 0;   // "до полуночи" после самой полуночи
+};
+
+class TimeEventBus {
+public:
+    explicit TimeEventBus(size_t capacity = 64);
+    TimeEventBus(const TimeEventBus&) = delete;
+    TimeEventBus& operator=(const TimeEventBus&) = delete;
+
+    // Номер подписки или -1, если слоты кончились. lead — только для
+    // TIME_EVENT_BEFORE_MIDNIGHT, в реальных тиках, меньше длины игровых
+    // суток. Всё — из потока рассылки, но не из обработчика события.
+    int  Subscribe(TimeEventKind kind, TimeEventCallback fn, void* ctx, int64_t lead = 0);
+    int  Subscribe(TimeEventKind kind, TimeEventQueue* queue, int64_t lead = 0);
+    bool Unsubscribe(int id);
+
+    size_t   Count() const { return m_slots.size() - m_free.size(); }
+    size_t   Capacity() const { return m_slots.size(); }
+    uint64_t Dropped(int id) const;
+
+    // Начать отсчёт с момента now, ничего не рассылая
+    void   Reset(const GameClock& clock, int64_t now);
+    // Разослать события со сроком <= now; возвращает их число
+    size_t Advance(const GameClock& clock, int64_t now);
+    // Ближайший срок после последнего Advance; INT64_MAX — подписок нет,
+    // INT64_MIN — Advance ещё не вызывался
+    int64_t NextDeadline() const;
+
+    TimeBusStats Stats() const { return m_stats; }
+
+private:
+    struct Slot {
+        TimeEventCallback fn    = nullptr;
+        void*             ctx   = nullptr;
+        TimeEventQueue*   queue = nullptr;
+        int64_t           lead  = 0;
+        uint64_t          dropped = 0;
+        uint16_t          kind  = 0;
+        bool              used  = false;
+    };
+
+    int  Add(TimeEventKind kind, TimeEventCallback fn, void* ctx, TimeEventQueue* queue, int64_t lead);
+    void Deliver(int id, const TimeEvent& e);
+    void DeliverAll(TimeEventKind kind, int64_t gameMinute, int64_t deadline, int64_t skipped, int64_t now);
+
+    std::vector<Slot> m_slots;
+    std::vector<int>  m_free;
+    // Подписки по видам; "до полуночи" — по убыванию lead, т.е. по сроку
+    std::vector<int>  m_lists[TIME_EVENT_KINDS];
+
+    GameClock m_clock;               // состояние часов на момент Reset
+    bool      m_primed = false;
+    int64_t   m_now = 0;             // последний Advance
+    int64_t   m_hour = 0;            // номер текущего игрового часа
+    int64_t   m_day = 0;             // номер текущих игровых суток
+    int64_t   m_leadDay = 0;         // чья полночь ждёт "до полуночи"
+    int64_t   m_leadMidnight = 0;    // её реальный момент
+    size_t    m_cursor = 0;          // столько "до полуночи" уже разослано
+    TimeBusStats m_stats;
+};
@@ -0,0 +1,191 @@
+#pragma once
+// -----------------------------------------------------------------------------
+// Форматирование времени без выделения памяти.
+//
+// Все 1440 строк "HH:MM" и пары цифр 00..99 строятся на этапе компиляции;
+// функции пишут в буфер вызывающего и возвращают указатель на завершающий
+// ноль, чтобы вызовы можно было склеивать: p = Append(p, ...).
+// -----------------------------------------------------------------------------
+#include <cstddef>
+#include <cstdint>
+#include "game_time.h"
+
+const size_t HHMM_LEN     = 5;   // "HH:MM"
+const size_t MMSS_MAX_LEN = 24;  // "MMMM...:SS" для любого int64 секунд
+
+template <typename Ch>
+struct ClockStrings {
+    Ch hhmm[MINUTES_IN_DAY][HHMM_LEN];
+    Ch pairs[100][2];
+};
+
+template <typename Ch>
+constexpr ClockStrings<Ch> MakeClockStrings()
+{
+    ClockStrings<Ch> t{};
+    for (int i = 0; i < 100; ++i)
+    {
+        t.pairs[i][0] = static_cast<Ch>('0' + i / 10);
+        t.pairs[i][1] = static_cast<Ch>('0' + i % 10);
+    }
+    for (int m = 0; m < MINUTES_IN_DAY; ++m)
+    {
+        int h = m / 60, mm = m % 60;
+        t.hhmm[m][0] = t.pairs[h][0];
+        t.hhmm[m][1] = t.pairs[h][1];
+        t.hhmm[m][2] = static_cast<Ch>(':');
+        t.hhmm[m][3] = t.pairs[mm][0];
+        t.hhmm[m][4] = t.pairs[mm][1];
+    }
+    return t;
+}
+
+template <typename Ch>
+inline constexpr ClockStrings<Ch> CLOCK_STRINGS = MakeClockStrings<Ch>();
+
+// "HH:MM" для минут суток; как и прежний FormatTime, часы берутся по модулю 24
+// (1440 минут до полуночи выводятся как "00:00").
+template <typename Ch>
+inline Ch* AppendHHMM(Ch* out, int minutes)
+{
+    const Ch* src = CLOCK_STRINGS<Ch>.hhmm[FloorMod(minutes, MINUTES_IN_DAY)];
+    for (size_t i = 0; i < HHMM_LEN; ++i) out[i] = src[i];
+    out[HHMM_LEN] = Ch(0);
+    return out + HHMM_LEN;
+}
+
+// "MM:SS" с минутами не короче двух знаков (12600 сек -> "210:00")
+template <typename Ch>
+inline Ch* AppendMMSS(Ch* out, int64_t seconds)
+{
+    if (seconds < 0) seconds = 0;
+    uint64_t min = static_cast<uint64_t>(seconds) / 60;
+    int      sec = static_cast<int>(seconds % 60);
+
+    Ch digits[20];
+    int n = 0;
+    do { digits[n++] = static_cast<Ch>('0' + min % 10); min /= 10; } while (min);
+    if (n < 2) digits[n++] = static_cast<Ch>('0');
+    while (n) *out++ = digits[--n];
+
+    *out++ = static_cast<Ch>(':');
+    *out++ = CLOCK_STRINGS<Ch>.pairs[sec][0];
+    *out++ = CLOCK_STRINGS<Ch>.pairs[sec][1];
+    *out = Ch(0);
+    return out;
+}
+
+// Десятичное число без ведущих нулей
+template <typename Ch>
+inline Ch* AppendUInt(Ch* out, uint64_t v)
+{
+    Ch digits[20];
+    int n = 0;
+    do { digits[n++] = static_cast<Ch>('0' + v % 10); v /= 10; } while (v);
+    while (n) *out++ = digits[--n];
+    *out = Ch(0);
+    return out;
+}
+
+// Копирование строкового литерала без завершающего нуля
+template <typename Ch, size_t N>
+inline Ch* AppendLiteral(Ch* out, const Ch (&lit)[N])
+{
+    for (size_t i = 0; i + 1 < N; ++i) out[i] = lit[i];
+    out[N - 1] = Ch(0);
+    return out + N - 1;
+}
+
+// -----------------------------------------------------------------------------
+// Дата и время UTC для тиков FILETIME
+// -----------------------------------------------------------------------------
+const size_t ISO_UTC_LEN       = 24;   // "2025-03-11T18:42:59.125Z"
+const size_t ISO_UTC_BASIC_LEN = 16;   // "20250311T184259Z" (iCalendar)
+
+// Дни от 1970-01-01 -> год, месяц, день (алгоритм Х. Хиннанта)
+inline void CivilFromDays(int64_t z, int64_t* y, unsigned* m, unsigned* d)
+{
+    z += 719468;
+    int64_t era = (z >= 0 ? z : z - 146096) / 146097;
+    unsigned doe = static_cast<unsigned>(z - era * 146097);
+    unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    unsigned mp = (5 * doy + 2) / 153;
+    *d = doy - (153 * mp + 2) / 5 + 1;
+    *m = mp < 10 ? mp + 3 : mp - 9;
+    *y = static_cast<int64_t>(yoe) + era * 400 + (*m <= 2);
+}
+
+// Обратное: год, месяц, день -> дни от 1970-01-01
+inline int64_t DaysFromCivil(int64_t y, unsigned m, unsigned d)
+{
+    y -= m <= 2;
+    int64_t era = (y >= 0 ? y : y - 399) / 400;
+    unsigned yoe = static_cast<unsigned>(y - era * 400);
+    unsigned doy = (153 * (m > 2 ? m - 3 : m + 9) + 2) / 5 + d - 1;
+    unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + static_cast<int64_t>(doe) - 719468;
+}
+
+// Дата меняется редко, поэтому год, месяц и день кэшируются между вызовами.
+// Как и остальные Append*, пишет завершающий ноль и возвращает указатель на него.
+class IsoTimeFormatter {
+public:
+    char* Append(char* out, int64_t ticks) { return Format(out, ticks, false); }
+    char* AppendBasic(char* out, int64_t ticks) { return Format(out, ticks, true); }
+
+private:
+    static char* Put2(char* out, unsigned v)
+    {
+        out[0] = CLOCK_STRINGS<char>.pairs[v][0];
+        out[1] = CLOCK_STRINGS<char>.pairs[v][1];
+        return out + 2;
+    }
+
+    char* Format(char* p, int64_t ticks, bool basic)
+    {
+        const int64_t UNIX_EPOCH_TICKS = 116444736000000000LL;
+        int64_t ms = FloorDiv(ticks - UNIX_EPOCH_TICKS, 10000);
+        int64_t day = FloorDiv(ms, 86400000);
+        unsigned rest = static_cast<unsigned>(ms - day * 86400000);
+        if (day != m_day)
+        {
+            int64_t y;
+            CivilFromDays(day, &y, &m_month, &m_mday);
+            y = y < 0 ? 0 : y > 9999 ? 9999 : y;
+            m_century = static_cast<unsigned>(y / 100);
+            m_year = static_cast<unsigned>(y % 100);
+            m_day = day;
+        }
+        p = Put2(Put2(p, m_century), m_year);
+        if (!basic) *p++ = '-';
+        p = Put2(p, m_month);
+        if (!basic) *p++ = '-';
+        p = Put2(p, m_mday);
+        *p++ = 'T';
+        p = Put2(p, rest / 3600000);
+        if (!basic) *p++ = ':';
+        p = Put2(p, rest / 60000 % 60);
+        if (!basic) *p++ = ':';
+        p = Put2(p, rest / 1000 % 60);
+        if (!basic)
+        {
+            unsigned frac = rest % 1000;
+            *p++ = '.';
+            *p++ = static_cast<char>('0' + frac / 100);
+            p = Put2(p, frac % 100);
+        }
+        *p++ = 'Z';
+        *p = 0;
+        return p;
+    }
+
+    int64_t  m_day = INT64_MIN;
+    unsigned m_century = 0, m_year = 0, m_month = 0, m_mday = 0;
+};
+
+inline char* AppendIsoUtc(char* out, int64_t ticks)
+{
+    IsoTimeFormatter f;
+    return f.Append(out, ticks);
+}
@@ -0,0 +1,58 @@
+#pragma once
+// -----------------------------------------------------------------------------
+// Разбор "ЧЧ:ММ" без sscanf.
+//
+// ParseClockText принимает то же, что прежний swscanf(L"%d%*[^0-9]%d") в
+// диалоге: часы, любые не-цифры между ними и минуты ("7:05", "07.05",
+// "7 h 5"). ParseHHMM5 — быстрый путь для ровно пяти байт "HH:MM": все
+// проверки делаются над одним 64-битным словом, без ветвлений по символам.
+// -----------------------------------------------------------------------------
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+// Возвращает указатель за последней цифрой минут или nullptr
+template <typename Ch>
+inline const Ch* ParseClockText(const Ch* p, const Ch* end, int* minuteOfDay)
+{
+    auto digit = [](Ch c) { return c >= Ch('0') && c <= Ch('9'); };
+    auto number = [&](const Ch*& q, int* v) {
+        // Как у %d: пробелы и знак "+" перед числом
+        while (q < end && (*q == Ch(' ') || *q == Ch('\t'))) ++q;
+        if (q < end && *q == Ch('+')) ++q;
+        int n = 0, len = 0;
+        for (; q < end && digit(*q); ++q, ++len)
+        {
+            if (len >= 4) return false;
+            n = n * 10 + static_cast<int>(*q - Ch('0'));
+        }
+        *v = n;
+        return len > 0;
+    };
+
+    int h, m;
+    if (!number(p, &h)) return nullptr;
+    const Ch* sep = p;
+    while (p < end && !digit(*p)) ++p;
+    if (p == sep || !number(p, &m)) return nullptr;
+    if (h >= 24 || m >= 60) return nullptr;
+    *minuteOfDay = h * 60 + m;
+    return p;
+}
+
+// Ровно "HH:MM" (любой не-цифровой разделитель в середине)
+inline bool ParseHHMM5(const char* p, int* minuteOfDay)
+{
+    uint64_t w = 0;
+    std::memcpy(&w, p, 5);
+    // У цифр после xor с '0' остаётся 0..9; байт >= 10 даёт старший бит
+    // после прибавления 0x76 (перенос возможен только из уже плохого байта)
+    uint64_t d = (w ^ 0x3030003030ull) & 0xFFFF00FFFFull;
+    uint64_t bad = ((d + 0x7676007676ull) | d) & 0x8080008080ull;
+    int sep = static_cast<int>((w >> 16) & 0xFF);
+    int h = static_cast<int>((d & 0xFF) * 10 + ((d >> 8) & 0xFF));
+    int m = static_cast<int>(((d >> 24) & 0xFF) * 10 + ((d >> 32) & 0xFF));
+    bool ok = (bad == 0) & !(sep >= '0' && sep <= '9') & (h < 24) & (m < 60);
+    *minuteOfDay = h * 60 + m;
+    return ok;
+}
@@ -0,0 +1,189 @@
+#include "timer_wheel.h"
+#include "game_time.h"
+#include <climits>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+static inline int LowestBit(uint64_t v)
+{
+#ifdef _MSC_VER
+    unsigned long i; _BitScanForward64(&i, v);
+    return static_cast<int>(i);
+#else
+    return __builtin_ctzll(v);
+#endif
+}
+
+static inline uint64_t RotateRight(uint64_t v, int n)
+{
+    n &= 63;
+    return n ? (v >> n) | (v << (64 - n)) : v;
+}
+
+static inline int64_t CeilDiv(int64_t a, int64_t b)
+{
+    return -FloorDiv(-a, b);
+}
+
+TimerWheel::TimerWheel(int64_t granularity, int64_t now)
+    : m_granularity(granularity > 0 ? granularity : 1)
+{
+    m_now = CeilDiv(now, m_granularity);
+    for (auto& level : m_heads)
+        for (auto& head : level)
+            head.prev = head.next = &head;
+    m_expired.prev = m_expired.next = &m_expired;
+}
+
+void TimerWheel::Arm(WheelTimer* t, int64_t deadline)
+{
+    if (t->Armed()) Unlink(t);
+    else ++m_count;
+    t->deadline = deadline;
+    t->expires  = CeilDiv(deadline, m_granularity);
+    Insert(t);
+}
+
+void TimerWheel::Cancel(WheelTimer* t)
+{
+    if (!t->Armed()) return;
+    Unlink(t);
+    --m_count;
+}
+
+void TimerWheel::Insert(WheelTimer* t)
+{
+    int64_t e = t->expires < m_now ? m_now : t->expires;
+    int64_t delta = e - m_now;
+
+    int level = 0;
+    while (level < LEVELS - 1 && delta >= (int64_t(1) << (SLOT_BITS * (level + 1))))
+        ++level;
+    if (delta >= (int64_t(1) << (SLOT_BITS * LEVELS)))
+        e = m_now + (int64_t(1) << (SLOT_BITS * LEVELS)) - 1;   // переложится при каскаде
+
+    int slot = static_cast<int>((e >> (SLOT_BITS * level)) & (SLOTS - 1));
+    WheelTimer* head = &m_heads[level][slot];
+    t->level = level;
+    t->slot  = slot;
+    t->prev  = head->prev;
+    t->next  = head;
+    head->prev->next = t;
+    head->prev = t;
+    m_occupied[level] |= uint64_t(1) << slot;
+}
+
+void TimerWheel::Unlink(WheelTimer* t)
+{
+    t->prev->next = t->next;
+    t->next->prev = t->prev;
+    t->prev = t->next = nullptr;
+    if (t->level < 0) return;   // уже в очереди на срабатывание
+    WheelTimer* head = &m_heads[t->level][t->slot];
+    if (head->next == head)
+        m_occupied[t->level] &= ~(uint64_t(1) << t->slot);
+}
+
+void TimerWheel::CascadeSlot(int level, int slot)
+{
+    WheelTimer* head = &m_heads[level][slot];
+    WheelTimer* t = head->next;
+    head->prev = head->next = head;
+    m_occupied[level] &= ~(uint64_t(1) << slot);
+    while (t != head)
+    {
+        WheelTimer* next = t->next;
+        Insert(t);
+        t = next;
+    }
+}
+
+void TimerWheel::SetNow(int64_t unit)
+{
+    m_now = unit;
+    // Перекладываем текущие блоки верхних уровней, начиная с самого старшего
+    for (int level = LEVELS - 1; level >= 1; --level)
+    {
+        int shift = SLOT_BITS * level;
+        if ((unit & ((int64_t(1) << shift) - 1)) != 0) continue;
+        int slot = static_cast<int>((unit >> shift) & (SLOTS - 1));
+        if (m_occupied[level] & (uint64_t(1) << slot))
+            CascadeSlot(level, slot);
+    }
+}
+
+int64_t TimerWheel::NextEventUnit() const
+{
+    int64_t best = INT64_MAX;
+
+    int p0 = static_cast<int>(m_now & (SLOTS - 1));
+    if (uint64_t r = RotateRight(m_occupied[0], p0))
+        best = m_now + LowestBit(r);
+
+    for (int level = 1; level < LEVELS; ++level)
+    {
+        if (!m_occupied[level]) continue;
+        int shift = SLOT_BITS * level;
+        int64_t block = m_now >> shift;
+        // Бит 0 после сдвига — текущий блок, он уже разложен: ближайший раз через 64
+        uint64_t r = RotateRight(m_occupied[level], static_cast<int>(block & (SLOTS - 1)) + 1);
+        int64_t at = (block + LowestBit(r) + 1) << shift;
+        if (at < best) best = at;
+    }
+    return best;
+}
+
+size_t TimerWheel::Advance(int64_t now)
+{
+    int64_t target = FloorDiv(now, m_granularity);
+    size_t fired = 0;
+
+    while (m_count)
+    {
+        int64_t unit = NextEventUnit();
+        if (unit > target) break;
+        if (unit != m_now) SetNow(unit);
+
+        int slot = static_cast<int>(m_now & (SLOTS - 1));
+        if (!(m_occupied[0] & (uint64_t(1) << slot))) continue;
+
+        // Переносим слот в очередь срабатывания: обработчики могут ставить
+        // и снимать любые таймеры, в том числе ещё не вызванные из этой очереди
+        WheelTimer* head = &m_heads[0][slot];
+        for (WheelTimer* t = head->next; t != head; t = t->next)
+            t->level = -1;
+        m_expired.next = head->next;
+        m_expired.prev = head->prev;
+        m_expired.next->prev = &m_expired;
+        m_expired.prev->next = &m_expired;
+        head->prev = head->next = head;
+        m_occupied[0] &= ~(uint64_t(1) << slot);
+        SetNow(m_now + 1);
+
+        while (m_expired.next != &m_expired)
+        {
+            WheelTimer* t = m_expired.next;
+            Unlink(t);
+            --m_count;
+            ++fired;
+            if (t->fire) t->fire(t, now);
+        }
+    }
+    if (m_now <= target) SetNow(target + 1);
+    return fired;
+}
+
+bool TimerWheel::Rebase(int64_t now)
+{
+    if (m_count) return false;
+    m_now = CeilDiv(now, m_granularity);
+    return true;
+}
+
+int64_t TimerWheel::NextExpiry() const
+{
+    if (!m_count) return INT64_MAX;
+    int64_t unit = NextEventUnit();
+    return unit * m_granularity;
+}
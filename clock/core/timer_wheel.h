@@ -0,0 +1,72 @@
+#pragma once
+// -----------------------------------------------------------------------------
+// Иерархическое колесо таймеров.
+//
+// 4 уровня по 64 слота: при шаге 1 мс нижний уровень покрывает 64 мс, верхний —
+// около 4.6 часа (более дальние таймеры перекладываются при каскаде).
+// Таймеры интрузивные: память принадлежит вызывающему, постановка и снятие
+// стоят O(1) без выделений.
+// -----------------------------------------------------------------------------
+#include <cstddef>
+#include <cstdint>
+
+struct WheelTimer;
+using WheelCallback = void (*)(WheelTimer* timer, int64_t now);
+
+struct WheelTimer {
+    int64_t       deadline = 0;        // реальный момент срабатывания (тики)
+    WheelCallback fire     = nullptr;
+    void*         ctx      = nullptr;  // данные вызывающего
+
+    bool Armed() const { return next != nullptr; }
+
+private:
+    friend class TimerWheel;
+    WheelTimer* prev    = nullptr;
+    WheelTimer* next    = nullptr;
+    int64_t     expires = 0;           // в единицах колеса
+    int         level   = 0;           // -1 — в очереди срабатывания
+    int         slot    = 0;
+};
+
+class TimerWheel {
+public:
+    static const int LEVELS    = 4;
+    static const int SLOT_BITS = 6;
+    static const int SLOTS     = 1 << SLOT_BITS;
+
+    // granularity — шаг колеса в тиках по 100 нс; now — начальный момент
+    explicit TimerWheel(int64_t granularity = 10000, int64_t now = 0);
+    TimerWheel(const TimerWheel&) = delete;
+    TimerWheel& operator=(const TimerWheel&) = delete;
+
+    void   Arm(WheelTimer* t, int64_t deadline);
+    void   Cancel(WheelTimer* t);
+    size_t Count() const { return m_count; }
+
+    // Вызывает fire() у всех таймеров с deadline <= now; возвращает их число.
+    // Из обработчика можно снова ставить или снимать таймеры.
+    size_t Advance(int64_t now);
+
+    // Нижняя оценка момента, когда колесу снова нужно внимание (срабатывание
+    // или каскад); INT64_MAX, если таймеров нет.
+    int64_t NextExpiry() const;
+
+    // Перенести пустое колесо на момент now (например, когда "сейчас" стало
+    // известно уже после конструктора); false — в колесе есть таймеры
+    bool Rebase(int64_t now);
+
+private:
+    void    Insert(WheelTimer* t);
+    void    Unlink(WheelTimer* t);
+    void    SetNow(int64_t unit);
+    void    CascadeSlot(int level, int slot);
+    int64_t NextEventUnit() const;
+
+    int64_t    m_granularity;
+    int64_t    m_now;                   // следующая необработанная единица
+    size_t     m_count = 0;
+    uint64_t   m_occupied[LEVELS] = {};
+    WheelTimer m_heads[LEVELS][SLOTS];  // кольцевые списки с заголовком
+    WheelTimer m_expired;               // очередь срабатывания внутри Advance
+};
@@ -0,0 +1,171 @@
+#include "timetable_export.h"
+#include <cstring>
+
+// Событий за один запрос к календарю
+static const size_t EXPORT_BATCH = 512;
+
+bool ParseTimetableFormat(const char* name, TimetableFormat* format)
+{
+    if (!std::strcmp(name, "csv")) *format = TimetableFormat::Csv;
+    else if (!std::strcmp(name, "json")) *format = TimetableFormat::Json;
+    else if (!std::strcmp(name, "ics") || !std::strcmp(name, "ical")) *format = TimetableFormat::ICal;
+    else return false;
+    return true;
+}
+
+static char* AppendInt(char* out, int64_t v)
+{
+    uint64_t u = v < 0 ? 0 - static_cast<uint64_t>(v) : static_cast<uint64_t>(v);
+    if (v < 0) *out++ = '-';
+    char digits[20];
+    int n = 0;
+    do { digits[n++] = static_cast<char>('0' + u % 10); u /= 10; } while (u);
+    while (n) *out++ = digits[--n];
+    return out;
+}
+
+// -----------------------------------------------------------------------------
+// TimetableWriter
+// -----------------------------------------------------------------------------
+bool TimetableWriter::Flush()
+{
+    if (m_used && m_ok)
+        m_ok = m_sink->Write(m_buf, m_used);
+    m_used = 0;
+    return m_ok;
+}
+
+bool TimetableWriter::Reserve(size_t n)
+{
+    return BUFFER_SIZE - m_used >= n || Flush();
+}
+
+bool TimetableWriter::Begin(int64_t stamp)
+{
+    m_rows = 0;
+    m_used = 0;
+    m_ok = true;
+    m_iso.AppendBasic(m_stamp, stamp);
+    char* p = m_buf;
+    switch (m_format)
+    {
+    case TimetableFormat::Csv:
+        p = AppendLiteral(p, "real_time,game_day,game_time,event\n");
+        break;
+    case TimetableFormat::Json:
+        p = AppendLiteral(p, "[");
+        break;
+    case TimetableFormat::ICal:
+        p = AppendLiteral(p, "BEGIN:VCALENDAR\r\nVERSION:2.0\r\nPRODID:-//WRClock//Timetable//EN\r\n"
+                             "CALSCALE:GREGORIAN\r\n");
+        break;
+    }
+    m_used = static_cast<size_t>(p - m_buf);
+    return true;
+}
+
+bool TimetableWriter::Row(const CalendarOccurrence& e, int minutesPerDay)
+{
+    if (!Reserve(MAX_ROW)) return false;
+    int64_t day = FloorDiv(e.gameMinute, minutesPerDay);
+    int minute = static_cast<int>(e.gameMinute - day * minutesPerDay);
+    char* p = m_buf + m_used;
+    switch (m_format)
+    {
+    case TimetableFormat::Csv:
+        p = m_iso.Append(p, e.at);
+        *p++ = ',';
+        p = AppendInt(p, day);
+        *p++ = ',';
+        p = AppendHHMM(p, minute);
+        *p++ = ',';
+        p = AppendInt(p, e.id);
+        *p++ = '\n';
+        break;
+    case TimetableFormat::Json:
+        if (m_rows) *p++ = ',';
+        p = AppendLiteral(p, "\n{\"real_time\":\"");
+        p = m_iso.Append(p, e.at);
+        p = AppendLiteral(p, "\",\"game_day\":");
+        p = AppendInt(p, day);
+        p = AppendLiteral(p, ",\"game_time\":\"");
+        p = AppendHHMM(p, minute);
+        p = AppendLiteral(p, "\",\"event\":");
+        p = AppendInt(p, e.id);
+        *p++ = '}';
+        break;
+    case TimetableFormat::ICal:
+        p = AppendLiteral(p, "BEGIN:VEVENT\r\nUID:");
+        p = AppendInt(p, e.gameMinute);
+        *p++ = '-';
+        p = AppendInt(p, e.id);
+        p = AppendLiteral(p, "@wrclock\r\nDTSTAMP:");
+        std::memcpy(p, m_stamp, ISO_UTC_BASIC_LEN);
+        p = AppendLiteral(p + ISO_UTC_BASIC_LEN, "\r\nDTSTART:");
+        p = m_iso.AppendBasic(p, e.at);
+        p = AppendLiteral(p, "\r\nSUMMARY:Game day ");
+        p = AppendInt(p, day);
+        *p++ = ' ';
+        p = AppendHHMM(p, minute);
+        p = AppendLiteral(p, "\r\nEND:VEVENT\r\n");
+        break;
+    }
+    m_used = static_cast<size_t>(p - m_buf);
+    ++m_rows;
+    return true;
+}
+
+bool TimetableWriter::End()
+{
+    if (!Reserve(MAX_ROW)) return false;
+    char* p = m_buf + m_used;
+    if (m_format == TimetableFormat::Json)
+    {
+        if (m_rows) *p++ = '\n';
+        p = AppendLiteral(p, "]\n");
+    }
+    else if (m_format == TimetableFormat::ICal)
+        p = AppendLiteral(p, "END:VCALENDAR\r\n");
+    m_used = static_cast<size_t>(p - m_buf);
+    return Flush();
+}
+
+// -----------------------------------------------------------------------------
+// ExportTimetable
+// -----------------------------------------------------------------------------
+int64_t ExportTimetable(GameCalendar* calendar, const GameClock& clock, int64_t from, int64_t to,
+                        int64_t stamp, TimetableFormat format, ScheduleSink* sink)
+{
+    TimetableWriter w(sink, format);
+    w.Begin(stamp);
+    if (to > from)
+    {
+        // Минуты, начало которых попадает в [from, to), — как в GameCalendar::Range
+        int64_t lo = clock.GameMinute(from - 1) + 1;
+        int64_t hi = clock.GameMinute(to - 1) + 1;
+        int mpd = clock.State().minutesPerDay;
+        CalendarOccurrence batch[EXPORT_BATCH];
+        // Следующий запрос начинается с минуты last; done событий этой минуты уже выведены
+        int64_t last = lo;
+        size_t done = 0;
+        while (last < hi)
+        {
+            size_t n = calendar->NextAfterMinute(last - 1, EXPORT_BATCH, batch);
+            if (n <= done) break;
+            size_t i = done;
+            for (; i < n && batch[i].gameMinute < hi; ++i)
+            {
+                batch[i].at = clock.DeadlineOf(batch[i].gameMinute);
+                if (!w.Row(batch[i], mpd)) return -1;
+            }
+            if (i < n) break;
+            int64_t tail = batch[n - 1].gameMinute;
+            size_t same = 0;
+            while (same < n && batch[n - 1 - same].gameMinute == tail) ++same;
+            done = tail == last ? n : same;
+            last = tail;
+        }
+    }
+    if (!w.End()) return -1;
+    return static_cast<int64_t>(w.Rows());
+}
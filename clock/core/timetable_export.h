@@ -0,0 +1,57 @@
+#pragma once
+// -----------------------------------------------------------------------------
+// Выгрузка расписания игровых событий с реальным временем (CSV, JSON,
+// iCalendar).
+//
+// События берутся из GameCalendar (например, "каждый игровой час") в
+// промежутке реального времени и пишутся потоком: строки собираются в один
+// буфер фиксированного размера, который уходит в ScheduleSink по заполнении.
+// Ни одна строка не выделяет память, так что выгрузка миллионов строк
+// упирается в запись, а не в форматирование.
+// -----------------------------------------------------------------------------
+#include <cstddef>
+#include <cstdint>
+#include "game_calendar.h"
+#include "schedule_import.h"
+#include "time_format.h"
+
+enum class TimetableFormat { Csv, Json, ICal };
+
+// "csv", "json", "ics"/"ical"; false — неизвестное имя
+bool ParseTimetableFormat(const char* name, TimetableFormat* format);
+
+class TimetableWriter {
+public:
+    TimetableWriter(ScheduleSink* sink, TimetableFormat format) : m_sink(sink), m_format(format) {}
+    TimetableWriter(const TimetableWriter&) = delete;
+    TimetableWriter& operator=(const TimetableWriter&) = delete;
+
+    // Заголовок и начало документа; stamp — момент выгрузки (DTSTAMP в iCalendar)
+    bool Begin(int64_t stamp);
+    bool Row(const CalendarOccurrence& e, int minutesPerDay);
+    // Конец документа и сброс буфера
+    bool End();
+
+    size_t Rows() const { return m_rows; }
+
+private:
+    static const size_t BUFFER_SIZE = 64 * 1024;
+    static const size_t MAX_ROW = 256;
+
+    bool Reserve(size_t n);
+    bool Flush();
+
+    ScheduleSink*    m_sink;
+    TimetableFormat  m_format;
+    IsoTimeFormatter m_iso;
+    char             m_stamp[ISO_UTC_BASIC_LEN + 1] = {};
+    size_t           m_used = 0;
+    size_t           m_rows = 0;
+    bool             m_ok = true;
+    char             m_buf[BUFFER_SIZE];
+};
+
+// Все события календаря, начало которых попадает в [from, to); возвращает
+// число строк или -1 при ошибке записи
+int64_t ExportTimetable(GameCalendar* calendar, const GameClock& clock, int64_t from, int64_t to,
+                        int64_t stamp, TimetableFormat format, ScheduleSink* sink);
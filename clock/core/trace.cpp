@@ -0,0 +1,263 @@
+#include "trace.h"
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <vector>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#include <intrin.h>
+#else
+#include <pthread.h>
+#endif
+
+std::atomic<bool> g_traceEnabled{ false };
+
+struct SpanRecord {
+    const char* name;
+    int64_t     start;
+    int64_t     duration;
+    uint32_t    thread;
+};
+
+static std::mutex              s_spanLock;
+static std::vector<SpanRecord> s_spans;       // кольцо последних интервалов
+static size_t                  s_spanNext = 0;
+static uint64_t                s_spanTotal = 0;
+
+static TraceCounter*& CounterHead()
+{
+    static TraceCounter* head = nullptr;
+    return head;
+}
+
+static TraceHistogram*& HistogramHead()
+{
+    static TraceHistogram* head = nullptr;
+    return head;
+}
+
+static uint32_t CurrentThreadId()
+{
+#ifdef _WIN32
+    return GetCurrentThreadId();
+#else
+    return static_cast<uint32_t>(reinterpret_cast<uintptr_t>(pthread_self()));
+#endif
+}
+
+int64_t TraceNowNs()
+{
+    using namespace std::chrono;
+    return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+void TraceEnable(bool on, size_t capacity)
+{
+    std::lock_guard<std::mutex> g(s_spanLock);
+    if (on && s_spans.size() != capacity)
+    {
+        s_spans.assign(capacity ? capacity : 1, SpanRecord());
+        s_spanNext = 0;
+        s_spanTotal = 0;
+    }
+    g_traceEnabled.store(on, std::memory_order_relaxed);
+}
+
+void TraceReset()
+{
+    {
+        std::lock_guard<std::mutex> g(s_spanLock);
+        s_spanNext = 0;
+        s_spanTotal = 0;
+    }
+    for (TraceCounter* c = CounterHead(); c; c = c->m_next)
+        c->m_value.store(0, std::memory_order_relaxed);
+    for (TraceHistogram* h = HistogramHead(); h; h = h->m_next)
+        h->Reset();
+}
+
+void TraceComplete(const char* name, int64_t startNs, int64_t durationNs)
+{
+    std::lock_guard<std::mutex> g(s_spanLock);
+    if (s_spans.empty()) return;
+    s_spans[s_spanNext] = { name, startNs, durationNs, CurrentThreadId() };
+    if (++s_spanNext == s_spans.size()) s_spanNext = 0;
+    ++s_spanTotal;
+}
+
+size_t TraceSpanCount()
+{
+    std::lock_guard<std::mutex> g(s_spanLock);
+    return s_spanTotal < s_spans.size() ? static_cast<size_t>(s_spanTotal) : s_spans.size();
+}
+
+// -----------------------------------------------------------------------------
+// Счётчики и гистограммы
+// -----------------------------------------------------------------------------
+TraceCounter::TraceCounter(const char* name)
+    : m_name(name), m_next(CounterHead())
+{
+    CounterHead() = this;
+}
+
+static int HighBit(uint64_t v)
+{
+#ifdef _MSC_VER
+    unsigned long i;
+    _BitScanReverse64(&i, v);
+    return static_cast<int>(i);
+#else
+    return 63 - __builtin_clzll(v);
+#endif
+}
+
+static int BucketOf(int64_t v)
+{
+    if (v < 16) return v < 0 ? 0 : static_cast<int>(v);
+    int msb = HighBit(static_cast<uint64_t>(v));
+    int sub = static_cast<int>((v >> (msb - 3)) & 7);
+    return 16 + (msb - 4) * 8 + sub;
+}
+
+// Наибольшее значение, попадающее в корзину
+static int64_t BucketTop(int b)
+{
+    if (b < 16) return b;
+    int msb = (b - 16) / 8 + 4;
+    int64_t sub = (b - 16) % 8;
+    int64_t low = (int64_t(8) + sub) << (msb - 3);
+    return low + (int64_t(1) << (msb - 3)) - 1;
+}
+
+TraceHistogram::TraceHistogram(const char* name)
+    : m_name(name), m_next(HistogramHead())
+{
+    for (auto& b : m_buckets) b.store(0, std::memory_order_relaxed);
+    HistogramHead() = this;
+}
+
+void TraceHistogram::RecordAlways(int64_t v)
+{
+    if (v < 0) v = 0;
+    m_buckets[BucketOf(v)].fetch_add(1, std::memory_order_relaxed);
+    m_count.fetch_add(1, std::memory_order_relaxed);
+    m_sum.fetch_add(v, std::memory_order_relaxed);
+    int64_t m = m_max.load(std::memory_order_relaxed);
+    while (v > m && !m_max.compare_exchange_weak(m, v, std::memory_order_relaxed)) {}
+}
+
+double TraceHistogram::Mean() const
+{
+    uint64_t n = Count();
+    return n ? double(m_sum.load(std::memory_order_relaxed)) / double(n) : 0.0;
+}
+
+int64_t TraceHistogram::Percentile(double p) const
+{
+    uint64_t n = Count();
+    if (!n) return 0;
+    uint64_t want = static_cast<uint64_t>(p / 100.0 * double(n) + 0.5);
+    if (want < 1) want = 1;
+    uint64_t seen = 0;
+    for (int b = 0; b < BUCKETS; ++b)
+    {
+        seen += m_buckets[b].load(std::memory_order_relaxed);
+        if (seen >= want)
+        {
+            int64_t top = BucketTop(b);
+            return top < Max() ? top : Max();
+        }
+    }
+    return Max();
+}
+
+void TraceHistogram::Reset()
+{
+    for (auto& b : m_buckets) b.store(0, std::memory_order_relaxed);
+    m_count.store(0, std::memory_order_relaxed);
+    m_sum.store(0, std::memory_order_relaxed);
+    m_max.store(0, std::memory_order_relaxed);
+}
+
+// -----------------------------------------------------------------------------
+// Выгрузка
+// -----------------------------------------------------------------------------
+std::string TraceReport()
+{
+    std::string out;
+    char line[256];
+    for (TraceCounter* c = CounterHead(); c; c = c->m_next)
+    {
+        std::snprintf(line, sizeof(line), "%-28s %llu\n", c->m_name,
+                      static_cast<unsigned long long>(c->Value()));
+        out += line;
+    }
+    for (TraceHistogram* h = HistogramHead(); h; h = h->m_next)
+    {
+        std::snprintf(line, sizeof(line),
+                      "%-28s n=%llu mean=%.1f p50=%lld p90=%lld p99=%lld max=%lld\n", h->m_name,
+                      static_cast<unsigned long long>(h->Count()), h->Mean(),
+                      static_cast<long long>(h->Percentile(50)), static_cast<long long>(h->Percentile(90)),
+                      static_cast<long long>(h->Percentile(99)), static_cast<long long>(h->Max()));
+        out += line;
+    }
+    std::snprintf(line, sizeof(line), "%-28s %zu\n", "spans buffered", TraceSpanCount());
+    out += line;
+    return out;
+}
+
+static void AppendName(std::string* out, const char* s)
+{
+    for (; *s; ++s)
+    {
+        if (*s == '"' || *s == '\\') out->push_back('\\');
+        out->push_back(*s);
+    }
+}
+
+bool TraceWriteChrome(const NativePath& path)
+{
+    std::vector<SpanRecord> spans;
+    {
+        std::lock_guard<std::mutex> g(s_spanLock);
+        size_t n = s_spanTotal < s_spans.size() ? static_cast<size_t>(s_spanTotal) : s_spans.size();
+        size_t first = s_spanTotal < s_spans.size() ? 0 : s_spanNext;
+        spans.reserve(n);
+        for (size_t i = 0; i < n; ++i)
+            spans.push_back(s_spans[(first + i) % s_spans.size()]);
+    }
+
+    std::string json = "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n";
+    char buf[160];
+    int64_t last = 0;
+    bool first = true;
+    for (const SpanRecord& s : spans)
+    {
+        if (!first) json += ",\n";
+        first = false;
+        json += "{\"name\":\"";
+        AppendName(&json, s.name);
+        std::snprintf(buf, sizeof(buf),
+                      "\",\"cat\":\"wrclock\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%u}",
+                      s.start / 1000.0, s.duration / 1000.0, s.thread);
+        json += buf;
+        if (s.start + s.duration > last) last = s.start + s.duration;
+    }
+    // Итоговые значения счётчиков — одной отметкой в конце трассы
+    for (TraceCounter* c = CounterHead(); c; c = c->m_next)
+    {
+        if (!first) json += ",\n";
+        first = false;
+        json += "{\"name\":\"";
+        AppendName(&json, c->m_name);
+        std::snprintf(buf, sizeof(buf), "\",\"ph\":\"C\",\"ts\":%.3f,\"pid\":1,\"args\":{\"value\":%llu}}",
+                      last / 1000.0, static_cast<unsigned long long>(c->Value()));
+        json += buf;
+    }
+    json += "\n]}\n";
+
+    OutputFile f;
+    return f.Open(path, true) && f.Write(json.data(), json.size());
+}
@@ -0,0 +1,119 @@
+#pragma once
+// -----------------------------------------------------------------------------
+// Встроенная трассировка и метрики.
+//
+//   TRACE_SPAN("UpdateClock");        — интервал до конца области видимости
+//   TraceCounter g_repaints("repaints"); g_repaints.Add();
+//   TraceHistogram g_late("timer.lateness_us"); g_late.Record(us);
+//
+// Пока трассировка выключена, всё сводится к чтению одного флага. Интервалы
+// копятся в кольце и выгружаются в формате Chrome trace-event (chrome://tracing,
+// Perfetto); счётчики и гистограммы доступны в любой момент через TraceReport().
+// С WRCLOCK_NO_TRACE интервалы TRACE_SPAN не компилируются вовсе.
+// -----------------------------------------------------------------------------
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "file_io.h"
+
+extern std::atomic<bool> g_traceEnabled;
+
+inline bool TraceEnabled() { return g_traceEnabled.load(std::memory_order_relaxed); }
+
+// capacity — сколько последних интервалов хранить
+void    TraceEnable(bool on, size_t capacity = 1 << 16);
+// Сбрасывает интервалы, счётчики и гистограммы
+void    TraceReset();
+int64_t TraceNowNs();
+
+// Завершённый интервал; name — строка со статическим временем жизни
+void    TraceComplete(const char* name, int64_t startNs, int64_t durationNs);
+size_t  TraceSpanCount();
+
+class TraceSpan {
+public:
+    explicit TraceSpan(const char* name)
+        : m_name(name), m_start(TraceEnabled() ? TraceNowNs() : -1) {}
+    ~TraceSpan()
+    {
+        if (m_start >= 0) TraceComplete(m_name, m_start, TraceNowNs() - m_start);
+    }
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+
+private:
+    const char* m_name;
+    int64_t     m_start;
+};
+
+// Объекты ниже регистрируются при создании и должны жить до конца программы
+// (глобальные или static)
+class TraceCounter {
+public:
+    explicit TraceCounter(const char* name);
+
+    void Add(uint64_t n = 1)
+    {
+        if (TraceEnabled()) m_value.fetch_add(n, std::memory_order_relaxed);
+    }
+    uint64_t    Value() const { return m_value.load(std::memory_order_relaxed); }
+    const char* Name() const { return m_name; }
+
+private:
+    friend void TraceReset();
+    friend std::string TraceReport();
+    friend bool TraceWriteChrome(const NativePath&);
+
+    const char*           m_name;
+    std::atomic<uint64_t> m_value{ 0 };
+    TraceCounter*         m_next;
+};
+
+// Лог-линейная гистограмма неотрицательных целых (3 значащих бита, ошибка
+// не больше 12.5%); значения меньше 16 хранятся точно
+class TraceHistogram {
+public:
+    static const int BUCKETS = 16 + 60 * 8;
+
+    explicit TraceHistogram(const char* name);
+
+    void Record(int64_t v)
+    {
+        if (TraceEnabled()) RecordAlways(v);
+    }
+    void RecordAlways(int64_t v);
+
+    uint64_t    Count() const { return m_count.load(std::memory_order_relaxed); }
+    int64_t     Max() const { return m_max.load(std::memory_order_relaxed); }
+    double      Mean() const;
+    // Верхняя граница корзины, в которую попал процентиль p (0..100)
+    int64_t     Percentile(double p) const;
+    const char* Name() const { return m_name; }
+    void        Reset();
+
+private:
+    friend void TraceReset();
+    friend std::string TraceReport();
+
+    const char*           m_name;
+    std::atomic<uint64_t> m_buckets[BUCKETS];
+    std::atomic<uint64_t> m_count{ 0 };
+    std::atomic<int64_t>  m_sum{ 0 };
+    std::atomic<int64_t>  m_max{ 0 };
+    TraceHistogram*       m_next;
+};
+
+// Текстовая сводка: счётчики, гистограммы (count/mean/p50/p99/max), интервалы
+std::string TraceReport();
+
+// Интервалы и итоговые значения счётчиков в формате Chrome trace-event JSON
+bool TraceWriteChrome(const NativePath& path);
+
+#ifdef WRCLOCK_NO_TRACE
+#define TRACE_SPAN(name) ((void)0)
+#else
+#define TRACE_CAT2(a, b) a##b
+#define TRACE_CAT(a, b) TRACE_CAT2(a, b)
+#define TRACE_SPAN(name) TraceSpan TRACE_CAT(traceSpan_, __LINE__)(name)
+#endif
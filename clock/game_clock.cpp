@@ -1,14 +1,34 @@
 #define NOMINMAX
 #include <windows.h>
+#include <mmsystem.h>
 #include <dwmapi.h>
 #include <uxtheme.h>
 #include <shlobj.h>
 #include <string>
-#include <sstream>
-#include <iomanip>
 #include <cmath>
 #include <cstring>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <vector>
 #include "Resource.h"
+#include "core/game_time.h"
+#include "core/clock_source.h"
+#include "core/time_format.h"
+#include "core/time_parse.h"
+#include "core/tick_scheduler.h"
+#include "core/time_events.h"
+#include "core/clock_view.h"
+#include "core/clock_shm.h"
+#include "core/state_journal.h"
+#include "core/correction_history.h"
+#include "core/drift_estimator.h"
+#include "core/event_log.h"
+#include "core/sound_decoder.h"
+#include "core/glyph_atlas.h"
+#include "core/theme_cache.h"
+#include "core/timetable_export.h"
+#include "core/trace.h"
 
 #ifndef DWMWA_USE_IMMERSIVE_DARK_MODE
 #define DWMWA_USE_IMMERSIVE_DARK_MODE 20
@@ -20,28 +40,146 @@
 #define IDC_THEME_SWITCH 1003
 #define IDC_ABOUT        1004
 
+// Пункты системного меню (младшие 4 бита у SC_* заняты системой)
+#define IDM_TRACE        0x0110
+#define IDM_NO_SECONDS   0x0120
+
 #pragma comment(lib, "dwmapi.lib")
 #pragma comment(lib, "uxtheme.lib")
 #pragma comment(lib, "shell32.lib")
+#pragma comment(lib, "winmm.lib")
 
 // -----------------------------------------------------------------------------
-// Константы времени игры
+// Объекты GDI для кэша темы (core/theme_cache.h)
 // -----------------------------------------------------------------------------
-const double GAME_MINUTE_REAL_SECONDS = 8.75; // 1 игровая минута = 8.75 сек
-const int    MINUTES_IN_DAY           = 1440;
+class GdiDrawBackend : public DrawBackend
+{
+public:
+    DrawHandle CreateBrush(ThemeColor color) override { return CreateSolidBrush(color); }
+    DrawHandle CreatePen(ThemeColor color, int width) override { return ::CreatePen(PS_SOLID, width, color); }
+    void       DeleteObject(DrawHandle h) override { ::DeleteObject(h); }
+};
 
 // -----------------------------------------------------------------------------
-// Структура темы и две предустановки (светлая/тёмная)
+// Большие часы из атласа символов (core/glyph_atlas.h)
 // -----------------------------------------------------------------------------
-struct Theme {
-    COLORREF bg;
-    COLORREF text;
-    COLORREF buttonBg;
-    COLORREF buttonText;
-    COLORREF accent;
+// Символы шрифта окна: белым по чёрному в DIB, покрытие — зелёный канал
+class GdiGlyphRasterizer : public GlyphRasterizer
+{
+public:
+    explicit GdiGlyphRasterizer(HFONT font)
+    {
+              m_dc = CreateCompatibleDC(nullptr);
+        m_oldFont = (HFONT)SelectObject(m_dc, font);
+    }
+    ~GdiGlyphRasterizer()
+    {
+              SelectObject(m_dc, m_oldFont);
+        DeleteDC(m_dc);
+    }
+    int CellHeight() override
+    {
+              TEXTMETRIC tm;
+        GetTextMetrics(m_dc, &tm);
+        return tm.tmHeight;
+    }
+    int Advance(char ch) override
+    {
+              SIZE size;
+        GetTextExtentPoint32A(m_dc, &ch, 1, &size);
+        return size.cx;
+    }
+    void Rasterize(char ch, int width, uint8_t* coverage, int stride) override
+    {
+              int height = CellHeight();
+        BITMAPINFO bi{};
+        bi.bmiHeader.biSize = sizeof(bi.bmiHeader);
+        bi.bmiHeader.biWidth = width;
+        bi.bmiHeader.biHeight = -height;
+        bi.bmiHeader.biPlanes = 1;
+        bi.bmiHeader.biBitCount = 32;
+        void* bits = nullptr;
+        HBITMAP bmp = CreateDIBSection(m_dc, &bi, DIB_RGB_COLORS, &bits, nullptr, 0);
+        if (!bmp) return;
+        HBITMAP old = (HBITMAP)SelectObject(m_dc, bmp);
+        memset(bits, 0, size_t(width) * size_t(height) * 4);
+        SetBkMode(m_dc, TRANSPARENT);
+        SetTextColor(m_dc, RGB(255,255,255));
+        RECT rc = { 0, 0, width, height };
+        DrawTextA(m_dc, &ch, 1, &rc, DT_CENTER | DT_TOP | DT_SINGLELINE | DT_NOPREFIX);
+        GdiFlush();
+        const uint32_t* px = static_cast<const uint32_t*>(bits);
+        for (int y = 0; y < height; ++y)
+            for (int x = 0; x < width; ++x)
+                coverage[size_t(y) * size_t(stride) + x] =
+                    static_cast<uint8_t>((px[size_t(y) * size_t(width) + x] >> 8) & 0xFF);
+        SelectObject(m_dc, old);
+        DeleteObject(bmp);
+    }
+
+private:
+    HDC   m_dc;
+    HFONT m_oldFont;
+};
+
+// Кадр собирается в памяти; окну достаются только прямоугольники изменений
+class GlyphClockPresenter
+{
+public:
+    void Attach(HWND hwnd)
+    {
+              m_hwnd = hwnd;
+        RECT rc;
+        GetClientRect(hwnd, &rc);
+        m_compositor.Resize(rc.right - rc.left, rc.bottom - rc.top);
+    }
+    void SetTheme(HFONT font, const Theme& t)
+    {
+              GdiGlyphRasterizer rasterizer(font);
+        m_compositor.SetAtlas(m_atlases.Get(0, &rasterizer, t.text, t.bg));
+        Show(m_text);
+    }
+    void Show(const wchar_t* text)
+    {
+              size_t n = 0;
+        for (; text[n] && n + 1 < MAX_CLOCK_CELLS; ++n)
+        {
+                      m_text[n] = text[n];
+            m_chars[n] = static_cast<char>(text[n]);
+        }
+        m_text[n] = 0;
+        PixelRect damage[MAX_CLOCK_CELLS];
+        size_t k = m_compositor.Compose(m_chars, n, damage, MAX_CLOCK_CELLS);
+        for (size_t i = 0; i < k; ++i)
+        {
+                      RECT r = { damage[i].x, damage[i].y, damage[i].x + damage[i].width,
+                       damage[i].y + damage[i].height };
+            InvalidateRect(m_hwnd, &r, FALSE);
+        }
+    }
+    // WM_DRAWITEM: DC уже обрезан по недействительной области
+    void Paint(HDC hdc)
+    {
+              const PixelBuffer& f = m_compositor.Frame();
+        BITMAPINFO bi{};
+        bi.bmiHeader.biSize = sizeof(bi.bmiHeader);
+        bi.bmiHeader.biWidth = f.width;
+        bi.bmiHeader.biHeight = -f.height;
+        bi.bmiHeader.biPlanes = 1;
+        bi.bmiHeader.biBitCount = 32;
+        SetDIBitsToDevice(hdc, 0, 0, f.width, f.height, 0, 0, 0, f.height,
+                          f.pixels.data(), &bi, DIB_RGB_COLORS);
+    }
+    // Показанный текст (для копирования)
+    const wchar_t* Text() const { return m_text; }
+
+private:
+    HWND            m_hwnd = nullptr;
+    GlyphAtlasCache m_atlases;
+    ClockCompositor m_compositor;
+    wchar_t         m_text[MAX_CLOCK_CELLS] = L"00:00";
+    char            m_chars[MAX_CLOCK_CELLS] = {};
 };
-const Theme LIGHT_THEME{ RGB(250,250,250), RGB(0,0,0),   RGB(230,230,230), RGB(0,0,0),   RGB(0,120,215) };
-const Theme DARK_THEME { RGB(32,32,32),   RGB(255,255,255), RGB(60,60,60),  RGB(255,255,255), RGB(0,120,215) };
 
 // -----------------------------------------------------------------------------
 // Глобальные переменные
@@ -58,24 +196,63 @@ HWND g_hAbout = nullptr;
 
 bool    g_dark = false;
 Theme   g_theme = LIGHT_THEME;
-HBRUSH  g_brBackground = nullptr;
+GdiDrawBackend g_gdi;
+ThemeCache     g_themeCache(&g_gdi);   // кисти и перья обеих тем, создаются один раз
+ThemeResources g_res;                  // объекты текущей темы
 HFONT   g_fontLarge = nullptr;
 HFONT   g_fontSmall = nullptr;
+GlyphClockPresenter g_bigClock;        // большие часы в g_hTime
+
+GameClock   g_clock;                   // игровое время (тики по 100 нс)
+std::unique_ptr<ClockSource> g_source; // откуда берётся "сейчас" (--clock NAME)
+// Реальный остаток в MM:SS будит окно раз в секунду; пункт меню "Остаток
+// без секунд" оставляет только смену игровой минуты. Колесо будильников
+// переносится на "сейчас" в SelectClockSource, до первого ArmAlarm
+TickScheduler g_sched;
+ClockViewModel g_view;                 // что сейчас показано в окне
+ClockPublisher g_publisher;            // состояние часов для других процессов
+JournalWriter g_journal;               // журнал состояния (фоновая запись)
+CorrectionHistory g_history;           // все поправки времени
+DriftEstimator g_drift;                // скорость часов по вводам времени
+EventLog    g_log;                     // журнал событий clock.log
+SoundCache  g_notification;            // IDR_NOTIFICATION, декодируется при первом звуке
+TimeEventBus g_timeEvents;             // подписки на игровые часы и полночь
+WheelTimer  g_timeEventTimer;          // будит g_timeEvents к ближайшему сроку
 
-double      g_offset = 0.0;            // смещение в секундах
-ULONGLONG   g_start  = 0;              // момент запуска (100 нс)
+// Метрики (core/trace.h); собираются, только пока включена трассировка
+TraceCounter   g_repaints("window.repaints");
+TraceCounter   g_textUpdates("window.text_updates");
+TraceCounter   g_allocations("heap.allocations");
+TraceHistogram g_timerLateness("timer.lateness_us");   // WM_TIMER позже срока
+TraceHistogram g_timerJitter("timer.jitter_us");       // разброс опозданий
+int64_t        g_expectedWake = INT64_MAX;             // на когда взведён таймер
+int64_t        g_lastLateness = 0;
 
 // -----------------------------------------------------------------------------
 // Прототипы
 // -----------------------------------------------------------------------------
 ULONGLONG GetTime100ns();
+void      SelectClockSource(LPCWSTR cmdLine);
+void      SetTracing(HWND hwnd, bool on);
 void      UpdateClock();
+void      ScheduleTick(HWND hwnd);
 void      ApplyTheme(HWND hwnd);
 void      DrawButton(LPDRAWITEMSTRUCT dis);
-std::wstring FormatTime(int minutes);
+const wchar_t* ButtonLabel(UINT id);
+const std::wstring& GetDataDir();
 std::wstring GetIniPath();
+std::wstring GetJournalPath();
+std::wstring GetHistoryPath();
+std::wstring GetLogPath();
 void      SaveGameTime();
 void      LoadGameTime();
+void      RestoreDrift();
+bool      RunExportMode(int* exitCode);
+void      CopyTimetable(HWND hwnd);
+void      LoadNotification(HINSTANCE hInst);
+void      PlayNotification();
+void      StartTimeEvents(int64_t now);
+void      ArmTimeEvents();
 INT_PTR CALLBACK SetTimeDlg(HWND, UINT, WPARAM, LPARAM);
 INT_PTR CALLBACK AboutDlg(HWND, UINT, WPARAM, LPARAM);
 
@@ -84,49 +261,92 @@ INT_PTR CALLBACK AboutDlg(HWND, UINT, WPARAM, LPARAM);
 // -----------------------------------------------------------------------------
 ULONGLONG GetTime100ns()
 {
-      FILETIME ft; GetSystemTimeAsFileTime(&ft);
-    return (static_cast<ULONGLONG>(ft.dwHighDateTime) << 32) | ft.dwLowDateTime;
+      return static_cast<ULONGLONG>(g_source->Now());
 }
-std::wstring FormatTime(int minutes)
-{
-      int h = (minutes / 60) % 24;
-    int m = minutes % 60;
-    std::wostringstream ss;
-    ss << std::setw(2) << std::setfill(L'0') << h
-       << L":"
-       << std::setw(2) << std::setfill(L'0') << m;
-    return ss.str();
+// По умолчанию время монотонное с редкой сверкой с системным: перевод
+// системных часов или скачок NTP не сдвигает игровое время
+void SelectClockSource(LPCWSTR cmdLine)
+{
+      char name[32] = "anchored";
+    const wchar_t* p = cmdLine ? wcsstr(cmdLine, L"--clock") : nullptr;
+    if (p)
+    {
+              p += 7;
+        while (*p == L' ' || *p == L'=') ++p;
+        size_t n = 0;
+        while (p[n] && p[n] != L' ' && n + 1 < sizeof(name))
+        {
+                      name[n] = static_cast<char>(p[n]);
+            ++n;
+        }
+        name[n] = 0;
+    }
+    g_source = CreateClockSource(name);
+    if (!g_source) g_source = CreateClockSource("anchored");
+    // Иначе первый срок оказался бы на ~1.3e17 тиков впереди колеса: лишний
+    // WM_TIMER и каскад через все уровни
+    g_sched.Rebase(g_source->Now());
 }
 // -----------------------------------------------------------------------------
-// Работа с INI файлом в AppData
+// Подсчёт выделений памяти для метрик
 // -----------------------------------------------------------------------------
-std::wstring GetIniPath()
+void* operator new(size_t size)
 {
-      wchar_t path[MAX_PATH];
+      g_allocations.Add();
+    if (void* p = malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+// -----------------------------------------------------------------------------
+// Хранение состояния в AppData: журнал, а gameclock.ini только читается
+// при первом запуске новой версии
+// -----------------------------------------------------------------------------
+const std::wstring& GetDataDir()
+{
+      static std::wstring dir;
+    if (!dir.empty()) return dir;
+    wchar_t path[MAX_PATH];
     if (SUCCEEDED(SHGetFolderPath(nullptr, CSIDL_APPDATA | CSIDL_FLAG_CREATE,
                                   nullptr, 0, path)))
     {
-              std::wstring dir = std::wstring(path) + L"\\WRClock";
+              dir = std::wstring(path) + L"\\WRClock";
         CreateDirectory(dir.c_str(), nullptr);
-        return dir + L"\\gameclock.ini";
     }
-      return L"gameclock.ini";
+    else
+        dir = L".";
+      return dir;
+}
+std::wstring GetIniPath()
+{
+      return GetDataDir() + L"\\gameclock.ini";
+}
+std::wstring GetJournalPath()
+{
+      return GetDataDir() + L"\\gameclock.journal";
+}
+std::wstring GetHistoryPath()
+{
+      return GetDataDir() + L"\\gameclock.history";
+}
+std::wstring GetLogPath()
+{
+      return GetDataDir() + L"\\clock.log";
+}
+int LocalMinuteOfDay()
+{
+      SYSTEMTIME st; GetLocalTime(&st);
+    return st.wHour * 60 + st.wMinute;
 }
 void SaveGameTime()
 {
-      ULONGLONG now100 = GetTime100ns();
-    double elapsed = (now100 - g_start) / 10000000.0; // сек
-    double gameMin = (elapsed + g_offset) / GAME_MINUTE_REAL_SECONDS;
-    int    gameInt = static_cast<int>(gameMin);
-
-    wchar_t buf[64];
-    std::wstring ini = GetIniPath();
-    swprintf(buf, 64, L"%d", gameInt);
-    WritePrivateProfileString(L"Game", L"GameTime", buf, ini.c_str());
-    swprintf(buf, 64, L"%llu", now100);
-    WritePrivateProfileString(L"Game", L"CloseTime", buf, ini.c_str());
+      TRACE_SPAN("SaveGameTime");
+    // Последняя контрольная точка и остановка фоновой записи
+    g_journal.Stop();
+    g_history.Close();
+    g_log.Log(LOG_GAME_TIME_SAVED);
 }
-void LoadGameTime()
+void LoadLegacyIni(ULONGLONG now)
 {
       wchar_t buf[64] = {0};
     std::wstring ini = GetIniPath();
@@ -137,27 +357,159 @@ void LoadGameTime()
     if (GetPrivateProfileString(L"Game", L"CloseTime", L"", buf, 64, ini.c_str()) > 0)
         storedClose = _wtoi64(buf);
 
-    ULONGLONG now = GetTime100ns();
     if (storedClose > 0 && now > storedClose)
     {
-              double realElapsed = (now - storedClose) / 10000000.0;
-        double additional = realElapsed / GAME_MINUTE_REAL_SECONDS;
-        g_offset = (storedGame + additional) * GAME_MINUTE_REAL_SECONDS;
+              g_clock.Restore(now, storedGame, storedClose);
+        g_log.Log(LOG_GAME_TIME_INI);
     }
     else
     {
-              SYSTEMTIME st; GetLocalTime(&st);
-        int sysMinutes = st.wHour * 60 + st.wMinute;
-        g_offset = sysMinutes * GAME_MINUTE_REAL_SECONDS;
+              g_clock.SetGameTime(now, LocalMinuteOfDay());
+        g_log.Log(LOG_GAME_TIME_LOCAL);
           }
 }
+void LoadGameTime()
+{
+      TRACE_SPAN("LoadGameTime");
+    ULONGLONG now = GetTime100ns();
+    JournalLoad j;
+    if (LoadJournal(GetJournalPath(), &j) && j.found)
+    {
+              // Состояние абсолютное: часы шли и пока программа была закрыта.
+        // Если системное время ушло назад, поступаем как раньше — берём местное.
+        if (now > static_cast<ULONGLONG>(j.last.at))
+        {
+            g_clock.SetState(j.last.state);
+            g_log.Log(LOG_GAME_TIME_LOADED);
+        }
+        else
+        {
+            g_clock.SetGameTime(now, LocalMinuteOfDay());
+            g_log.Log(LOG_GAME_TIME_LOCAL);
+        }
+    }
+    else
+    {
+              LoadLegacyIni(now);
+    }
+    if (!g_journal.Start(GetJournalPath(), g_clock.State(), static_cast<int64_t>(GetTime100ns())))
+        g_log.Log(LOG_JOURNAL_FAILED);
+    RestoreDrift();
+    g_history.Open(GetHistoryPath());
+}
+// Подгонка скорости пересобирается по вводам времени из истории поправок;
+// сама скорость уже в журнале, здесь восстанавливаются накопленные суммы
+void RestoreDrift()
+{
+      TRACE_SPAN("RestoreDrift");
+    CorrectionReader history;
+    std::vector<int64_t> at;
+    std::vector<double> minute;
+    if (!history.Open(GetHistoryPath()) ||
+        !CollectDriftObservations(history, g_drift.Options(), g_clock.State().minutesPerDay,
+                                  &g_clock, &at, &minute))
+        return;
+    DriftSums sums;
+    FitDriftBatch(at.data(), minute.data(), at.size(), at.back(), g_drift.Options(), &sums);
+    g_drift.Restore(sums);
+}
+// -----------------------------------------------------------------------------
+// Выгрузка расписания
+// -----------------------------------------------------------------------------
+// Расписание в память — для буфера обмена
+class StringScheduleSink : public ScheduleSink
+{
+public:
+    bool Write(const char* data, size_t size) override
+    {
+              text.append(data, data + size);
+        return true;
+    }
+    std::wstring text;
+};
+
+// "--export PATH [--format csv|json|ics] [--days N] [--every MIN]": события
+// каждые MIN игровых минут (60) на N реальных суток вперёд (30), без окна
+bool RunExportMode(int* exitCode)
+{
+      int argc = 0;
+    LPWSTR* argv = CommandLineToArgvW(GetCommandLineW(), &argc);
+    if (!argv) return false;
+    const wchar_t* path = nullptr;
+    char format[8] = "csv";
+    int days = 30, every = 60;
+    for (int i = 1; i + 1 < argc; ++i)
+    {
+              if (!wcscmp(argv[i], L"--export")) path = argv[++i];
+        else if (!wcscmp(argv[i], L"--days")) days = _wtoi(argv[++i]);
+        else if (!wcscmp(argv[i], L"--every")) every = _wtoi(argv[++i]);
+        else if (!wcscmp(argv[i], L"--format"))
+        {
+                      const wchar_t* f = argv[++i];
+            size_t n = 0;
+            for (; f[n] && n + 1 < sizeof(format); ++n) format[n] = static_cast<char>(f[n]);
+            format[n] = 0;
+        }
+    }
+    if (!path)
+    {
+              LocalFree(argv);
+        return false;
+    }
+
+    TimetableFormat fmt;
+    *exitCode = 2;
+    if (ParseTimetableFormat(format, &fmt) && days > 0 && every > 0)
+    {
+              // Часы — как при запуске, но без журнала на запись
+        int64_t now = static_cast<int64_t>(GetTime100ns());
+        GameClock clock;
+        JournalLoad j;
+        if (LoadJournal(GetJournalPath(), &j) && j.found && now > j.last.at)
+            clock.SetState(j.last.state);
+        else
+            clock.SetGameTime(now, LocalMinuteOfDay());
+
+        GameCalendar calendar;
+        calendar.Add(CalendarRule::Every(every, 0, 0));
+        OutputFile file;
+        FileScheduleSink sink(&file);
+        *exitCode = file.Open(path, true) &&
+                    ExportTimetable(&calendar, clock, now, now + int64_t(days) * 86400 * TICKS_PER_SECOND,
+                                    now, fmt, &sink) >= 0 ? 0 : 1;
+    }
+    LocalFree(argv);
+    return true;
+}
+
+// Shift + "Копировать": расписание по игровым часам до конца следующих игровых суток
+void CopyTimetable(HWND hwnd)
+{
+      int64_t now = static_cast<int64_t>(GetTime100ns());
+    GameCalendar calendar;
+    calendar.Add(CalendarRule::Every(60, 0, 0));
+    StringScheduleSink sink;
+    ExportTimetable(&calendar, g_clock, now, g_clock.DeadlineOf((g_clock.GameDay(now) + 2) *
+                    g_clock.State().minutesPerDay), now, TimetableFormat::Csv, &sink);
+    if (OpenClipboard(hwnd))
+    {
+              EmptyClipboard();
+        size_t size = (sink.text.size()+1)*sizeof(wchar_t);
+        HGLOBAL hMem = GlobalAlloc(GMEM_MOVEABLE, size);
+        memcpy(GlobalLock(hMem), sink.text.c_str(), size);
+        GlobalUnlock(hMem);
+        SetClipboardData(CF_UNICODETEXT, hMem);
+        CloseClipboard();
+    }
+}
 // -----------------------------------------------------------------------------
 // Темизация
 // -----------------------------------------------------------------------------
 void ApplyTheme(HWND hwnd)
 {
-      if (g_brBackground) DeleteObject(g_brBackground);
-    g_brBackground = CreateSolidBrush(g_theme.bg);
+      TRACE_SPAN("ApplyTheme");
+      g_res = g_themeCache.Resources(g_theme);
+    g_bigClock.SetTheme(g_fontLarge, g_theme);
 
     BOOL useDark = g_dark ? TRUE : FALSE;
     DwmSetWindowAttribute(hwnd, DWMWA_USE_IMMERSIVE_DARK_MODE, &useDark, sizeof(useDark));
@@ -165,62 +517,218 @@ void ApplyTheme(HWND hwnd)
     InvalidateRect(hwnd, nullptr, TRUE);
 }
 
+// Подписи кнопок — константы, текст из окна кнопки при отрисовке не читаем
+const wchar_t* ButtonLabel(UINT id)
+{
+    switch (id)
+    {
+    case IDC_SET_TIME:     return L"Установить время";
+    case IDC_CLIP:         return L"Копировать";
+    case IDC_THEME_SWITCH: return g_dark ? L"Светлая тема" : L"Тёмная тема";
+    case IDC_ABOUT:        return L"О программе";
+    }
+    return L"";
+}
+
 // Отрисовка owner-draw кнопок
 void DrawButton(LPDRAWITEMSTRUCT dis)
 {
-    std::wstring text;
-    int len = GetWindowTextLength(dis->hwndItem);
-    text.resize(len);
-    GetWindowText(dis->hwndItem, text.data(), len + 1);
-
+    TRACE_SPAN("DrawButton");
+    g_repaints.Add();
     const Theme& t = g_theme;
     bool pressed = (dis->itemState & ODS_SELECTED);
 
-    COLORREF bg = pressed ? t.accent : t.buttonBg;
     COLORREF fg = pressed ? RGB(255,255,255) : t.buttonText;
+    FillRect(dis->hDC, &dis->rcItem, (HBRUSH)(pressed ? g_res.pressed : g_res.button));
 
-    HBRUSH br = CreateSolidBrush(bg);
-    FillRect(dis->hDC, &dis->rcItem, br);
-    DeleteObject(br);
-
-    HPEN pen = CreatePen(PS_SOLID, 1, t.accent);
-    HPEN oldPen = (HPEN)SelectObject(dis->hDC, pen);
+    HPEN oldPen = (HPEN)SelectObject(dis->hDC, (HPEN)g_res.border);
     HBRUSH oldBrush = (HBRUSH)SelectObject(dis->hDC, GetStockObject(NULL_BRUSH));
     RoundRect(dis->hDC, dis->rcItem.left, dis->rcItem.top,
               dis->rcItem.right, dis->rcItem.bottom, 6, 6);
     SelectObject(dis->hDC, oldBrush);
     SelectObject(dis->hDC, oldPen);
-    DeleteObject(pen);
 
     SetBkMode(dis->hDC, TRANSPARENT);
     SetTextColor(dis->hDC, fg);
-    DrawText(dis->hDC, text.c_str(), -1, const_cast<RECT*>(&dis->rcItem),
+    DrawText(dis->hDC, ButtonLabel(dis->CtlID), -1, const_cast<RECT*>(&dis->rcItem),
              DT_CENTER | DT_VCENTER | DT_SINGLELINE);
 }
 
 // -----------------------------------------------------------------------------
 // Обновление отображаемого времени
 // -----------------------------------------------------------------------------
+// Поля окна обновляются только изменившиеся; большие часы — из атласа символов
+class WindowViewSink : public ClockViewSink
+{
+public:
+    void Present(const ClockView& v, unsigned changed) override
+    {
+              wchar_t buf[64];
+        if (changed & FIELD_TIME)
+        {
+                      AppendHHMM(buf, v.minuteOfDay);
+            g_bigClock.Show(buf);
+            g_textUpdates.Add();
+        }
+        if (changed & FIELD_COUNTDOWN)
+        {
+                      AppendHHMM(AppendLiteral(buf, L"До полуночи: "), v.minutesToMidnight);
+            SetWindowText(g_hCountdown, buf);
+            g_textUpdates.Add();
+        }
+        if (changed & FIELD_REAL_COUNTDOWN)
+        {
+            if (g_sched.Fields() & FIELD_REAL_COUNTDOWN)
+            {
+                          // Точный остаток реального времени до игровой полуночи
+                AppendMMSS(AppendLiteral(buf, L"Реальное время: "), v.realSeconds);
+            }
+            else
+            {
+                // Без секунд — целые минуты с округлением вверх ("≤ 24 мин"),
+                // обновляются вместе с игровой минутой
+                int64_t minutes = (v.realSeconds + 59) / 60;
+                if (minutes == m_realMinutes) return;
+                m_realMinutes = minutes;
+                wchar_t* p = AppendUInt(AppendLiteral(buf, L"Реальное время: \u2264 "), minutes);
+                AppendLiteral(p, L" мин");
+            }
+            SetWindowText(g_hRealCountdown, buf);
+            g_textUpdates.Add();
+        }
+    }
+
+    // Формат остатка сменился — следующий Present пишет его заново
+    void ResetRealCountdown() { m_realMinutes = -1; }
+
+private:
+    int64_t m_realMinutes = -1;
+};
+WindowViewSink g_windowSink;
+
 void UpdateClock()
 {
+    TRACE_SPAN("UpdateClock");
     ULONGLONG now100 = GetTime100ns();
-    double elapsed = (now100 - g_start) / 10000000.0;
-    double gameMinutes = (elapsed + g_offset) / GAME_MINUTE_REAL_SECONDS;
-
-    int totalMinutes = static_cast<int>(gameMinutes) % MINUTES_IN_DAY;
-    SetWindowText(g_hTime, FormatTime(totalMinutes).c_str());
-
-    int toMidnight = MINUTES_IN_DAY - totalMinutes;
-    std::wstring cd = L"До полуночи: " + FormatTime(toMidnight);
-    SetWindowText(g_hCountdown, cd.c_str());
-
-    double realSeconds = toMidnight * GAME_MINUTE_REAL_SECONDS;
-    int rMin = static_cast<int>(realSeconds) / 60;
-    int rSec = static_cast<int>(realSeconds) % 60;
-    std::wostringstream ss;
-    ss << L"Реальное время: " << std::setw(2) << std::setfill(L'0') << rMin
-       << L":" << std::setw(2) << std::setfill(L'0') << rSec;
-    SetWindowText(g_hRealCountdown, ss.str().c_str());
+    g_view.Update(g_clock, now100);
+    g_sched.OnDisplayed(g_clock, now100);
+}
+
+// -----------------------------------------------------------------------------
+// События игрового времени (core/time_events.h)
+// -----------------------------------------------------------------------------
+// Наступили следующие игровые сутки (а не перевод часов или сон машины).
+// Звук пока идёт через PlaySound: AlarmMixer (core/alarm_mixer.h) ждёт
+// устройства вывода Windows, а в core есть только ClockedAudioDevice
+void OnGameMidnight(const TimeEvent& e, void*)
+{
+    if (!e.skipped)
+        PlayNotification();
+}
+
+void FireTimeEvents(WheelTimer*, int64_t now)
+{
+    g_timeEvents.Advance(g_clock, now);
+    ArmTimeEvents();
+}
+
+void ArmTimeEvents()
+{
+    int64_t next = g_timeEvents.NextDeadline();
+    if (next == INT64_MAX)
+        g_sched.CancelAlarm(&g_timeEventTimer);
+    else
+        g_sched.ArmAlarm(&g_timeEventTimer, next);
+}
+
+// Подписки — при создании окна; после ввода времени отсчёт начинается заново
+void StartTimeEvents(int64_t now)
+{
+    if (!g_timeEventTimer.fire)
+    {
+        g_timeEventTimer.fire = FireTimeEvents;
+        g_timeEvents.Subscribe(TIME_EVENT_MIDNIGHT, OnGameMidnight, nullptr);
+    }
+    g_timeEvents.Reset(g_clock, now);
+    ArmTimeEvents();
+}
+
+// -----------------------------------------------------------------------------
+// Звук уведомления (core/sound_decoder.h)
+// -----------------------------------------------------------------------------
+// Ресурс уже отображён в память процесса: при запуске запоминается только
+// указатель, ничего не читается и не пишется на диск
+void LoadNotification(HINSTANCE hInst)
+{
+    HRSRC res = FindResource(hInst, MAKEINTRESOURCE(IDR_NOTIFICATION), RT_RCDATA);
+    HGLOBAL mem = res ? LoadResource(hInst, res) : nullptr;
+    const void* data = mem ? LockResource(mem) : nullptr;
+    if (data)
+        g_notification.SetSource(static_cast<const uint8_t*>(data), SizeofResource(hInst, res));
+}
+
+// Первый вызов декодирует ADPCM в WAV PCM; дальше звук берётся из памяти
+void PlayNotification()
+{
+    TRACE_SPAN("PlayNotification");
+    bool first = !g_notification.Decoded();
+    const std::vector<uint8_t>* wave = g_notification.Wave();
+    if (!wave)
+    {
+        g_log.Log(LOG_SOUND_FAILED);
+        return;
+    }
+    if (first)
+        g_log.Log(LOG_SOUND_DECODED, g_notification.DecodeNs() / 1000,
+                  static_cast<int64_t>(g_notification.PcmBytes()));
+    PlaySoundW(reinterpret_cast<LPCWSTR>(wave->data()), nullptr, SND_MEMORY | SND_ASYNC | SND_NODEFAULT);
+}
+
+// Перевзвод таймера ровно на момент следующего изменения на экране
+void ScheduleTick(HWND hwnd)
+{
+    int64_t next = g_sched.NextWakeup();
+    g_expectedWake = next;
+    if (next == INT64_MAX)
+    {
+        KillTimer(hwnd, 1);
+        return;
+    }
+    // Срок — во времени источника; у virtual:N оно идёт в N раз быстрее
+    // реального, а SetTimer ждёт реальные миллисекунды
+    int64_t delay = g_source->RealDelay(next - static_cast<int64_t>(GetTime100ns()));
+    if (delay == INT64_MAX)
+    {
+        KillTimer(hwnd, 1);
+        return;
+    }
+    // WM_TIMER не приходит раньше срока, но округляем вверх до миллисекунды
+    int64_t wait = delay > 0 ? (delay + 9999) / 10000 : 0;
+    UINT ms = static_cast<UINT>(wait < USER_TIMER_MAXIMUM ? wait : USER_TIMER_MAXIMUM);
+    if (ms < USER_TIMER_MINIMUM) ms = USER_TIMER_MINIMUM;
+    SetTimer(hwnd, 1, ms, nullptr);
+}
+
+// Включение трассировки; при выключении трасса и сводка метрик пишутся
+// в clock-trace.json и clock-metrics.txt рядом с журналом
+void SetTracing(HWND hwnd, bool on)
+{
+    if (on)
+    {
+        TraceReset();
+        TraceEnable(true);
+    }
+    else if (TraceEnabled())
+    {
+        TraceEnable(false);
+        TraceWriteChrome(GetDataDir() + L"\\clock-trace.json");
+        std::string report = TraceReport();
+        OutputFile f;
+        if (f.Open(GetDataDir() + L"\\clock-metrics.txt", true))
+            f.Write(report.data(), report.size());
+    }
+    if (hwnd)
+        CheckMenuItem(GetSystemMenu(hwnd, FALSE), IDM_TRACE, on ? MF_CHECKED : MF_UNCHECKED);
 }
 
 // -----------------------------------------------------------------------------
@@ -234,7 +742,7 @@ INT_PTR CALLBACK SetTimeDlg(HWND hDlg, UINT msg, WPARAM wParam, LPARAM)
                 ApplyTheme(hDlg);
         return TRUE;
     case WM_CTLCOLORDLG:
-                return (INT_PTR)g_brBackground;
+                return (INT_PTR)g_res.background;
     case WM_CTLCOLORSTATIC:
     case WM_CTLCOLOREDIT:
             case WM_CTLCOLORBTN:
@@ -242,19 +750,27 @@ INT_PTR CALLBACK SetTimeDlg(HWND hDlg, UINT msg, WPARAM wParam, LPARAM)
               HDC hdc = (HDC)wParam;
         SetBkColor(hdc, g_theme.bg);
         SetTextColor(hdc, g_theme.text);
-        return (INT_PTR)g_brBackground;
+        return (INT_PTR)g_res.background;
     }
     case WM_COMMAND:
         if (LOWORD(wParam) == IDOK)
         {
                       wchar_t buf[16];
             GetWindowText(GetDlgItem(hDlg, IDC_EDIT_TIME), buf, 16);
-            int h,m;
-            if (swscanf(buf, L"%d%*[^0-9]%d", &h, &m) == 2 &&
-                h >=0 && h <24 && m>=0 && m<60)
+            int minute;
+            if (ParseClockText(buf, buf + wcslen(buf), &minute))
             {
-                              g_start = GetTime100ns();
-                g_offset = (h*60 + m) * GAME_MINUTE_REAL_SECONDS;
+                              ULONGLONG now = GetTime100ns();
+                GameClockState before = g_clock.State();
+                // Ввод — ещё и наблюдение для подгонки скорости часов
+                DriftVerdict verdict = ApplyObservation(&g_drift, &g_clock,
+                                                        static_cast<int64_t>(now), minute);
+                g_history.Append(MakeCorrection(static_cast<int64_t>(now), before,
+                                                g_clock.State(), CORRECTION_DIALOG));
+                g_publisher.Publish(g_clock.State());
+                g_journal.Record(JOURNAL_SET, g_clock.State(), static_cast<int64_t>(now));
+                g_log.Log(LOG_GAME_TIME_SET, minute / 60, minute % 60);
+                g_log.Log(LOG_DRIFT_FITTED, g_clock.State().ticksPerMinute, static_cast<int>(verdict));
                 EndDialog(hDlg, IDOK);
                 return TRUE;
             }
@@ -281,14 +797,14 @@ INT_PTR CALLBACK AboutDlg(HWND hDlg, UINT msg, WPARAM wParam, LPARAM)
                   ApplyTheme(hDlg);
         return TRUE;
     case WM_CTLCOLORDLG:
-        return (INT_PTR)g_brBackground;
+        return (INT_PTR)g_res.background;
     case WM_CTLCOLORSTATIC:
     case WM_CTLCOLORBTN:
     {
               HDC hdc = (HDC)wParam;
         SetBkColor(hdc, g_theme.bg);
         SetTextColor(hdc, g_theme.text);
-        return (INT_PTR)g_brBackground;
+        return (INT_PTR)g_res.background;
     }
               case WM_COMMAND:
                   if (LOWORD(wParam) == IDOK)
@@ -309,18 +825,22 @@ LRESULT CALLBACK WndProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam)
     {
     case WM_CREATE:
     {
-              g_hInst = ((LPCREATESTRUCT)lParam)->hInstance;
-        g_start = GetTime100ns();
+              TRACE_SPAN("startup.WM_CREATE");
+        g_hInst = ((LPCREATESTRUCT)lParam)->hInstance;
+        g_log.Start(GetLogPath());
+        LoadNotification(g_hInst);
         LoadGameTime();
+        if (g_publisher.Open())
+            g_publisher.Publish(g_clock.State());
               g_fontLarge = CreateFont(36,0,0,0,FW_BOLD,FALSE,FALSE,FALSE,
                                  DEFAULT_CHARSET,OUT_DEFAULT_PRECIS,CLIP_DEFAULT_PRECIS,
                                  CLEARTYPE_QUALITY,DEFAULT_PITCH|FF_SWISS,L"Segoe UI");
         g_fontSmall = CreateFont(18,0,0,0,FW_NORMAL,FALSE,FALSE,FALSE,
                                  DEFAULT_CHARSET,OUT_DEFAULT_PRECIS,CLIP_DEFAULT_PRECIS,
                                  CLEARTYPE_QUALITY,DEFAULT_PITCH|FF_SWISS,L"Segoe UI");
-              g_hTime = CreateWindow(L"STATIC", L"00:00", WS_CHILD|WS_VISIBLE|SS_CENTER,
+              g_hTime = CreateWindow(L"STATIC", L"00:00", WS_CHILD|WS_VISIBLE|SS_OWNERDRAW,
                                10,10,230,40, hwnd, nullptr, g_hInst, nullptr);
-        SendMessage(g_hTime, WM_SETFONT, (WPARAM)g_fontLarge, TRUE);
+        g_bigClock.Attach(g_hTime);
               g_hCountdown = CreateWindow(L"STATIC", L"", WS_CHILD|WS_VISIBLE|SS_CENTER,
                                     10,60,230,20, hwnd, nullptr, g_hInst, nullptr);
         SendMessage(g_hCountdown, WM_SETFONT, (WPARAM)g_fontSmall, TRUE);
@@ -328,50 +848,108 @@ LRESULT CALLBACK WndProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam)
                                         10,85,230,20, hwnd, nullptr, g_hInst, nullptr);
         SendMessage(g_hRealCountdown, WM_SETFONT, (WPARAM)g_fontSmall, TRUE);
 
-        g_hSetTime = CreateWindow(L"BUTTON", L"Установить время", WS_CHILD|WS_VISIBLE|BS_OWNERDRAW,
+        g_hSetTime = CreateWindow(L"BUTTON", ButtonLabel(IDC_SET_TIME), WS_CHILD|WS_VISIBLE|BS_OWNERDRAW,
                                   10,120,230,26, hwnd, (HMENU)IDC_SET_TIME, g_hInst, nullptr);
 
-        g_hCopy = CreateWindow(L"BUTTON", L"Копировать", WS_CHILD|WS_VISIBLE|BS_OWNERDRAW,
+        g_hCopy = CreateWindow(L"BUTTON", ButtonLabel(IDC_CLIP), WS_CHILD|WS_VISIBLE|BS_OWNERDRAW,
                                10,152,110,26, hwnd, (HMENU)IDC_CLIP, g_hInst, nullptr);
 
-        g_hTheme = CreateWindow(L"BUTTON", L"Тёмная тема", WS_CHILD|WS_VISIBLE|BS_OWNERDRAW,
+        g_hTheme = CreateWindow(L"BUTTON", ButtonLabel(IDC_THEME_SWITCH), WS_CHILD|WS_VISIBLE|BS_OWNERDRAW,
                                 130,152,110,26, hwnd, (HMENU)IDC_THEME_SWITCH, g_hInst, nullptr);
 
-        g_hAbout = CreateWindow(L"BUTTON", L"О программе", WS_CHILD|WS_VISIBLE|BS_OWNERDRAW,
+        g_hAbout = CreateWindow(L"BUTTON", ButtonLabel(IDC_ABOUT), WS_CHILD|WS_VISIBLE|BS_OWNERDRAW,
                                 10,184,230,26, hwnd, (HMENU)IDC_ABOUT, g_hInst, nullptr);
 
         ApplyTheme(hwnd);
+        g_view.Attach(&g_windowSink);
+        AppendMenu(GetSystemMenu(hwnd, FALSE), MF_STRING | (TraceEnabled() ? MF_CHECKED : 0),
+                   IDM_TRACE, L"Трассировка");
+        AppendMenu(GetSystemMenu(hwnd, FALSE), MF_STRING, IDM_NO_SECONDS, L"Остаток без секунд");
+        StartTimeEvents(static_cast<int64_t>(GetTime100ns()));
         UpdateClock();
-        SetTimer(hwnd, 1, 1000, nullptr);
+        ScheduleTick(hwnd);
         return 0;
     }
             case WM_TIMER:
-        UpdateClock();
+    {
+        TRACE_SPAN("WM_TIMER");
+        ULONGLONG now100 = GetTime100ns();
+        if (g_expectedWake != INT64_MAX)
+        {
+                      // Опоздание относительно идеального срока и его разброс, мкс
+            int64_t late = (static_cast<int64_t>(now100) - g_expectedWake) / 10;
+            g_timerLateness.Record(late);
+            g_timerJitter.Record(late > g_lastLateness ? late - g_lastLateness : g_lastLateness - late);
+            g_lastLateness = late;
+        }
+        g_sched.RunAlarms(now100);
+        if (g_sched.DisplayDue(now100))
+            UpdateClock();
+        ScheduleTick(hwnd);
+        return 0;
+    }
+    case WM_SIZE:
+        // Свёрнутое окно не перерисовываем; после восстановления сразу догоняем
+        if (wParam == SIZE_MINIMIZED)
+            g_log.Log(LOG_WINDOW_HIDDEN);
+        else if (wParam == SIZE_RESTORED && !g_sched.Visible())
+            g_log.Log(LOG_WINDOW_SHOWN);
+        g_sched.SetVisible(wParam != SIZE_MINIMIZED);
+        if (g_sched.DisplayDue(GetTime100ns()))
+            UpdateClock();
+        ScheduleTick(hwnd);
         return 0;
     case WM_CTLCOLORSTATIC:
     {
-              HDC hdc = (HDC)wParam;
+              g_repaints.Add();
+        HDC hdc = (HDC)wParam;
         SetBkColor(hdc, g_theme.bg);
         SetTextColor(hdc, g_theme.text);
-        return (LRESULT)g_brBackground;
+        return (LRESULT)g_res.background;
     }
     case WM_CTLCOLORDLG:
-        return (LRESULT)g_brBackground;
+        return (LRESULT)g_res.background;
+    case WM_SYSCOMMAND:
+        if ((wParam & 0xFFF0) == IDM_TRACE)
+        {
+                      SetTracing(hwnd, !TraceEnabled());
+            return 0;
+        }
+        if ((wParam & 0xFFF0) == IDM_NO_SECONDS)
+        {
+            bool minutesOnly = (g_sched.Fields() & FIELD_REAL_COUNTDOWN) != 0;
+            g_sched.SetFields(minutesOnly ? FIELD_TIME | FIELD_COUNTDOWN : FIELD_ALL);
+            CheckMenuItem(GetSystemMenu(hwnd, FALSE), IDM_NO_SECONDS, minutesOnly ? MF_CHECKED : MF_UNCHECKED);
+            g_windowSink.ResetRealCountdown();
+            g_view.Invalidate(FIELD_REAL_COUNTDOWN);
+            UpdateClock();
+            ScheduleTick(hwnd);
+            return 0;
+        }
+        break;
     case WM_DRAWITEM:
-        DrawButton((LPDRAWITEMSTRUCT)lParam);
+        if (((LPDRAWITEMSTRUCT)lParam)->hwndItem == g_hTime)
+            g_bigClock.Paint(((LPDRAWITEMSTRUCT)lParam)->hDC);
+        else
+            DrawButton((LPDRAWITEMSTRUCT)lParam);
         return TRUE;
     case WM_COMMAND:
                 switch (LOWORD(wParam))
         {
         case IDC_SET_TIME:
                                 DialogBox(g_hInst, MAKEINTRESOURCE(IDD_SET_TIME), hwnd, SetTimeDlg);
+            StartTimeEvents(static_cast<int64_t>(GetTime100ns()));
             UpdateClock();
+            ScheduleTick(hwnd);
             break;
         case IDC_CLIP:
                             {
-            int len = GetWindowTextLength(g_hTime);
-            std::wstring txt(len, L'\0');
-            GetWindowText(g_hTime, txt.data(), len+1);
+            if (GetKeyState(VK_SHIFT) < 0)
+            {
+                              CopyTimetable(hwnd);
+                break;
+            }
+            std::wstring txt = g_bigClock.Text();
             if (OpenClipboard(hwnd))
             {
                               EmptyClipboard();
@@ -381,14 +959,16 @@ LRESULT CALLBACK WndProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam)
                 GlobalUnlock(hMem);
                 SetClipboardData(CF_UNICODETEXT, hMem);
                 CloseClipboard();
+                g_log.Log(LOG_COPIED, g_clock.MinuteOfDay(GetTime100ns()));
             }
                                           break;
         }
         case IDC_THEME_SWITCH:
             g_dark = !g_dark;
             g_theme = g_dark ? DARK_THEME : LIGHT_THEME;
-            SetWindowText(g_hTheme, g_dark ? L"Светлая тема" : L"Тёмная тема");
+            SetWindowText(g_hTheme, ButtonLabel(IDC_THEME_SWITCH));
             ApplyTheme(hwnd);
+            g_log.Log(LOG_THEME_CHANGED, g_dark);
             break;
         case IDC_ABOUT:
                                 break;
@@ -397,13 +977,16 @@ LRESULT CALLBACK WndProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam)
     case WM_ERASEBKGND:
     {
         RECT rc; GetClientRect(hwnd, &rc);
-        FillRect((HDC)wParam, &rc, g_brBackground);
+        FillRect((HDC)wParam, &rc, (HBRUSH)g_res.background);
         return 1;
     }
             case WM_DESTROY:
                 KillTimer(hwnd,1);
+                PlaySoundW(nullptr, nullptr, 0);   // звук играет из g_notification
                 SaveGameTime();
-                if (g_brBackground) DeleteObject(g_brBackground);
+                SetTracing(nullptr, false);
+                g_log.Stop();
+                g_themeCache.Clear();
         if (g_fontLarge) DeleteObject(g_fontLarge);
         if (g_fontSmall) DeleteObject(g_fontSmall);
         PostQuitMessage(0);
@@ -414,9 +997,16 @@ LRESULT CALLBACK WndProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam)
 // -----------------------------------------------------------------------------
 // Точка входа
 // -----------------------------------------------------------------------------
-int APIENTRY wWinMain(HINSTANCE hInstance, HINSTANCE, LPWSTR, int nCmdShow)
+int APIENTRY wWinMain(HINSTANCE hInstance, HINSTANCE, LPWSTR lpCmdLine, int nCmdShow)
 {
-      const wchar_t CLASS_NAME[] = L"WRClockWindow";
+      SelectClockSource(lpCmdLine);
+    int exitCode;
+    if (RunExportMode(&exitCode))
+        return exitCode;
+    // "--trace": трассировка с самого запуска, включая загрузку состояния
+    if (lpCmdLine && wcsstr(lpCmdLine, L"--trace"))
+        SetTracing(nullptr, true);
+    const wchar_t CLASS_NAME[] = L"WRClockWindow";
     WNDCLASSEX wc{ sizeof(WNDCLASSEX) };
     wc.lpfnWndProc   = WndProc;
     wc.hInstance     = hInstance;
@@ -433,8 +1023,11 @@ int APIENTRY wWinMain(HINSTANCE hInstance, HINSTANCE, LPWSTR, int nCmdShow)
         nullptr, nullptr, hInstance, nullptr);
     if (!hwnd) return 0;
 
-    ShowWindow(hwnd, nCmdShow);
-    UpdateWindow(hwnd);
+    {
+        TRACE_SPAN("startup.show");
+        ShowWindow(hwnd, nCmdShow);
+        UpdateWindow(hwnd);
+    }
 
     MSG msg;
       while (GetMessage(&msg, nullptr, 0, 0))
@@ -0,0 +1,120 @@
+// Проверки модели отображения и кэша тем: запускаются через ctest
+#include <cstdio>
+#include "clock_view.h"
+#include "theme_cache.h"
+
+static int g_failures = 0;
+
+#define CHECK(cond)                                                              \
+    do {                                                                         \
+        if (!(cond)) {                                                           \
+            std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+            ++g_failures;                                                        \
+        }                                                                        \
+    } while (0)
+
+// -----------------------------------------------------------------------------
+// ClockViewModel: получателю уходят только изменившиеся поля, Attach — полная
+// перерисовка
+// -----------------------------------------------------------------------------
+static void TestClockView()
+{
+    const int64_t start = 133000000000000000LL;
+    GameClock clock;
+    clock.SetGameTime(start, 600);
+
+    ClockViewModel model;
+    RecordingViewSink rec;
+    model.Attach(&rec);
+
+    // Первое обновление после Attach — все поля
+    CHECK(model.Update(clock, start) == FIELD_ALL);
+    CHECK(rec.entries.size() == 1 && rec.entries.back().changed == FIELD_ALL);
+
+    // Те же значения — ничего не передаётся
+    CHECK(model.Update(clock, start) == 0);
+    CHECK(rec.entries.size() == 1);
+
+    // Через секунду внутри игровой минуты меняются только реальные секунды
+    CHECK(model.Update(clock, start + TICKS_PER_SECOND) == FIELD_REAL_COUNTDOWN);
+    CHECK(rec.entries.size() == 2 && rec.entries.back().changed == FIELD_REAL_COUNTDOWN);
+
+    // Через игровую минуту — все три поля
+    const int64_t next = start + clock.State().ticksPerMinute;
+    CHECK(model.Update(clock, next) == FIELD_ALL);
+    CHECK(rec.entries.size() == 3 && rec.entries.back().view.minuteOfDay == 601);
+
+    // Новый получатель: следующий Update пересылает всё, хоть значения и те же
+    RecordingViewSink late;
+    model.Attach(&late);
+    CHECK(model.Update(clock, next) == FIELD_ALL);
+    CHECK(late.entries.size() == 1 && late.entries.back().changed == FIELD_ALL);
+    CHECK(late.entries.back().view.minuteOfDay == 601);
+
+    // Повторный Attach того же получателя ничего не добавляет
+    model.Attach(&late);
+    CHECK(model.Update(clock, next) == 0);
+    CHECK(late.entries.size() == 1);
+
+    // Invalidate пересылает ровно запрошенные поля
+    model.Invalidate(FIELD_TIME);
+    CHECK(model.Update(clock, next) == FIELD_TIME);
+    CHECK(late.entries.back().changed == FIELD_TIME);
+
+    // После Detach получатель больше ничего не получает
+    model.Detach(&late);
+    size_t before = late.entries.size();
+    model.Update(clock, next + TICKS_PER_SECOND);
+    CHECK(late.entries.size() == before);
+    CHECK(rec.CountOf(FIELD_TIME) == 4);
+}
+
+// -----------------------------------------------------------------------------
+// ThemeCache: объекты создаются один раз на тему и все удаляются в Clear
+// -----------------------------------------------------------------------------
+static void TestThemeCache()
+{
+    CountingDrawBackend gdi;
+    {
+        ThemeCache cache(&gdi);
+        ThemeResources light = cache.Resources(LIGHT_THEME);
+        ThemeResources dark = cache.Resources(DARK_THEME);
+        CHECK(light.background && light.button && light.pressed && light.border);
+        CHECK(dark.background != light.background);
+        CHECK(dark.pressed == light.pressed);   // общий accent — одна кисть
+
+        // Обе темы в кэше: переключения ничего не создают
+        const uint64_t created = gdi.Created();
+        for (int i = 0; i < 100; ++i)
+        {
+            ThemeResources r = cache.Resources(i & 1 ? LIGHT_THEME : DARK_THEME);
+            CHECK(r.background == (i & 1 ? light.background : dark.background));
+        }
+        CHECK(gdi.Created() == created);
+        CHECK(gdi.Live() == created);
+        CHECK(cache.Objects() == created);
+
+        cache.Clear();
+        CHECK(gdi.Live() == 0);
+        CHECK(cache.Objects() == 0);
+
+        // После Clear тема строится заново и снова удаляется деструктором
+        cache.Resources(DARK_THEME);
+        CHECK(gdi.Created() > created);
+        CHECK(gdi.Live() != 0);
+    }
+    CHECK(gdi.Live() == 0);
+}
+
+int main()
+{
+    TestClockView();
+    TestThemeCache();
+    if (g_failures)
+    {
+        std::fprintf(stderr, "%d check(s) failed\n", g_failures);
+        return 1;
+    }
+    std::printf("all checks passed\n");
+    return 0;
+}
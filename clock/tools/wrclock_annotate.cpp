@@ -0,0 +1,138 @@
+// -----------------------------------------------------------------------------
+// wrclock_annotate — игровое время в строках логов сервера и чата.
+//
+//   wrclock_annotate [--time HH:MM | --journal PATH] [--threads N]
+//                    [--utc-offset +HH:MM | --local] INPUT [OUTPUT]
+// После метки реального времени в начале строки вставляется
+// " [day N HH:MM]" по часам (core/log_annotate.h), N — сутки относительно
+// текущих игровых. Без OUTPUT — в stdout.
+// -----------------------------------------------------------------------------
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <fcntl.h>
+#include <string>
+#include <unistd.h>
+#include "log_annotate.h"
+#include "state_journal.h"
+#include "time_parse.h"
+
+static int LocalMinuteOfDay()
+{
+    time_t t = time(nullptr);
+    struct tm lt;
+    localtime_r(&t, &lt);
+    return lt.tm_hour * 60 + lt.tm_min;
+}
+
+// Смещение местного пояса сейчас (переходы на летнее время внутри лога не
+// учитываются — для таких логов лучше метки с зоной)
+static int64_t LocalUtcOffset()
+{
+    time_t t = time(nullptr);
+    struct tm lt;
+    localtime_r(&t, &lt);
+    return static_cast<int64_t>(lt.tm_gmtoff) * TICKS_PER_SECOND;
+}
+
+static bool ParseUtcOffset(const std::string& s, int64_t* offset)
+{
+    if (s.empty() || (s[0] != '+' && s[0] != '-')) return false;
+    int minute;
+    const char* end = s.data() + s.size();
+    const char* q = ParseClockText(s.data() + 1, end, &minute);
+    if (!q || q != end) return false;
+    *offset = (s[0] == '-' ? -minute : minute) * 60 * TICKS_PER_SECOND;
+    return true;
+}
+
+static void Usage()
+{
+    std::fprintf(stderr,
+        "usage: wrclock_annotate [--time HH:MM | --journal PATH] [--threads N]\n"
+        "                        [--utc-offset +HH:MM | --local] INPUT [OUTPUT]\n"
+        "  --time HH:MM        current game time (default: local time)\n"
+        "  --journal PATH      take the clock from gameclock.journal\n"
+        "  --threads N         worker threads (default: all cores)\n"
+        "  --utc-offset +HH:MM zone of timestamps without one (default: UTC)\n"
+        "  --local             timestamps without a zone are in local time\n");
+}
+
+int main(int argc, char** argv)
+{
+    int setMinute = -1;
+    const char* journalPath = nullptr;
+    LogAnnotateOptions options;
+    const char* input = nullptr;
+    const char* output = nullptr;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if (arg == "--journal" && i + 1 < argc) journalPath = argv[++i];
+        else if (arg == "--threads" && i + 1 < argc) options.threads = static_cast<unsigned>(std::atoi(argv[++i]));
+        else if (arg == "--local") options.utcOffset = LocalUtcOffset();
+        else if (arg == "--utc-offset" && i + 1 < argc)
+        {
+            if (!ParseUtcOffset(argv[++i], &options.utcOffset))
+            {
+                std::fprintf(stderr, "wrclock_annotate: bad offset '%s'\n", argv[i]);
+                return 2;
+            }
+        }
+        else if (arg == "--time" && i + 1 < argc)
+        {
+            std::string s = argv[++i];
+            if (!ParseClockText(s.data(), s.data() + s.size(), &setMinute))
+            {
+                std::fprintf(stderr, "wrclock_annotate: bad time '%s'\n", argv[i]);
+                return 2;
+            }
+        }
+        else if (arg.size() > 1 && arg[0] == '-') { Usage(); return 2; }
+        else if (!input) input = argv[i];
+        else if (!output) output = argv[i];
+        else { Usage(); return 2; }
+    }
+    if (!input)
+    {
+        Usage();
+        return 2;
+    }
+
+    GameClock clock;
+    int64_t now = WallTicksNow();
+    JournalLoad journal;
+    if (setMinute >= 0)
+        clock.SetGameTime(now, setMinute);
+    else if (journalPath && LoadJournal(journalPath, &journal) && journal.found)
+        clock.SetState(journal.last.state);
+    else
+    {
+        if (journalPath)
+            std::fprintf(stderr, "wrclock_annotate: no state in %s, using local time\n", journalPath);
+        clock.SetGameTime(now, LocalMinuteOfDay());
+    }
+
+    int fd = STDOUT_FILENO;
+    if (output)
+    {
+        fd = open(output, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (fd < 0)
+        {
+            std::fprintf(stderr, "wrclock_annotate: cannot create %s\n", output);
+            return 1;
+        }
+    }
+    FdLogSink sink(fd);
+    LogAnnotateReport report;
+    bool ok = AnnotateLogFile(input, clock, now, options, &sink, &report);
+    if (output && close(fd) != 0) ok = false;
+    if (!ok)
+    {
+        std::fprintf(stderr, "wrclock_annotate: %s: cannot read input or write output\n", input);
+        return 1;
+    }
+    std::fprintf(stderr, "wrclock_annotate: %zu lines, %zu annotated, %llu bytes written\n",
+                 report.lines, report.annotated, static_cast<unsigned long long>(report.bytesOut));
+    return 0;
+}
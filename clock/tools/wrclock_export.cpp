@@ -0,0 +1,139 @@
+// -----------------------------------------------------------------------------
+// wrclock_export — расписание игровых событий с реальным временем.
+//
+//   wrclock_export [--time HH:MM | --journal PATH] [--days N] [--every MIN]
+//                  [--at HH:MM] [--format csv|json|ics] [OUTPUT]
+// По умолчанию — каждый игровой час на 30 реальных суток вперёд в CSV;
+// --at HH:MM — одно событие в сутки. Без OUTPUT пишет в stdout.
+// -----------------------------------------------------------------------------
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <string>
+#include "state_journal.h"
+#include "time_parse.h"
+#include "timetable_export.h"
+
+class StdoutScheduleSink : public ScheduleSink {
+public:
+    bool Write(const char* data, size_t size) override
+    {
+        return std::fwrite(data, 1, size, stdout) == size;
+    }
+};
+
+static int LocalMinuteOfDay()
+{
+    time_t t = time(nullptr);
+    struct tm lt;
+    localtime_r(&t, &lt);
+    return lt.tm_hour * 60 + lt.tm_min;
+}
+
+static void Usage()
+{
+    std::fprintf(stderr,
+        "usage: wrclock_export [--time HH:MM | --journal PATH] [--days N] [--every MIN]\n"
+        "                      [--at HH:MM] [--format csv|json|ics] [OUTPUT]\n"
+        "  --time HH:MM   current game time (default: local time)\n"
+        "  --journal PATH take the clock from gameclock.journal\n"
+        "  --days N       real days to cover (default 30)\n"
+        "  --every MIN    one event every MIN game minutes (default 60)\n"
+        "  --at HH:MM     one event per game day at this time instead\n"
+        "  --format F     csv (default), json or ics\n");
+}
+
+static bool ParseMinute(const char* s, int* minute)
+{
+    std::string t = s;
+    return ParseClockText(t.data(), t.data() + t.size(), minute) != nullptr;
+}
+
+int main(int argc, char** argv)
+{
+    int setMinute = -1, atMinute = -1;
+    const char* journalPath = nullptr;
+    const char* output = nullptr;
+    double days = 30;
+    long every = 60;
+    TimetableFormat format = TimetableFormat::Csv;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if (arg == "--journal" && i + 1 < argc) journalPath = argv[++i];
+        else if (arg == "--days" && i + 1 < argc) days = std::atof(argv[++i]);
+        else if (arg == "--every" && i + 1 < argc) every = std::atol(argv[++i]);
+        else if (arg == "--format" && i + 1 < argc)
+        {
+            if (!ParseTimetableFormat(argv[++i], &format)) { Usage(); return 2; }
+        }
+        else if (arg == "--time" && i + 1 < argc)
+        {
+            if (!ParseMinute(argv[++i], &setMinute))
+            {
+                std::fprintf(stderr, "wrclock_export: bad time '%s'\n", argv[i]);
+                return 2;
+            }
+        }
+        else if (arg == "--at" && i + 1 < argc)
+        {
+            if (!ParseMinute(argv[++i], &atMinute))
+            {
+                std::fprintf(stderr, "wrclock_export: bad time '%s'\n", argv[i]);
+                return 2;
+            }
+        }
+        else if (arg.size() > 1 && arg[0] == '-') { Usage(); return 2; }
+        else if (!output) output = argv[i];
+        else { Usage(); return 2; }
+    }
+    if (days <= 0 || every <= 0)
+    {
+        Usage();
+        return 2;
+    }
+
+    GameClock clock;
+    int64_t now = WallTicksNow();
+    JournalLoad journal;
+    if (setMinute >= 0)
+        clock.SetGameTime(now, setMinute);
+    else if (journalPath && LoadJournal(journalPath, &journal) && journal.found)
+        clock.SetState(journal.last.state);
+    else
+    {
+        if (journalPath)
+            std::fprintf(stderr, "wrclock_export: no state in %s, using local time\n", journalPath);
+        clock.SetGameTime(now, LocalMinuteOfDay());
+    }
+
+    GameCalendar calendar;
+    if (atMinute >= 0)
+        calendar.Add(CalendarRule::Daily(atMinute, 0, clock.State().minutesPerDay));
+    else
+        calendar.Add(CalendarRule::Every(every, 0, 0));
+
+    OutputFile file;
+    FileScheduleSink fileSink(&file);
+    StdoutScheduleSink stdoutSink;
+    ScheduleSink* sink = &stdoutSink;
+    if (output)
+    {
+        if (!file.Open(output, true))
+        {
+            std::fprintf(stderr, "wrclock_export: cannot create %s\n", output);
+            return 1;
+        }
+        sink = &fileSink;
+    }
+    int64_t to = now + static_cast<int64_t>(days * 86400.0 * TICKS_PER_SECOND);
+    int64_t rows = ExportTimetable(&calendar, clock, now, to, now, format, sink);
+    std::fflush(stdout);
+    if (rows < 0)
+    {
+        std::fprintf(stderr, "wrclock_export: write failed\n");
+        return 1;
+    }
+    std::fprintf(stderr, "wrclock_export: %lld events\n", static_cast<long long>(rows));
+    return 0;
+}
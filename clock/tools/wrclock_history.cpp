@@ -0,0 +1,130 @@
+// -----------------------------------------------------------------------------
+// wrclock_history — просмотр истории поправок (gameclock.history).
+//
+//   wrclock_history [--days N] [--list] [--daily] [--drift] FILE
+// Без ключей печатает сводку за всё время и за последние N суток (30);
+// --drift подгоняет скорость часов по вводам времени из истории.
+// -----------------------------------------------------------------------------
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <vector>
+#include "correction_history.h"
+#include "drift_estimator.h"
+
+static const int64_t UNIX_EPOCH_TICKS = 116444736000000000LL;
+static const int64_t DAY_TICKS = 86400 * TICKS_PER_SECOND;
+
+static const char* FormatDate(int64_t at, char* buf, size_t cap)
+{
+    time_t t = static_cast<time_t>(FloorDiv(at - UNIX_EPOCH_TICKS, TICKS_PER_SECOND));
+    struct tm lt;
+    localtime_r(&t, &lt);
+    std::strftime(buf, cap, "%Y-%m-%d %H:%M:%S", &lt);
+    return buf;
+}
+
+static const char* SourceName(uint16_t source)
+{
+    switch (source)
+    {
+    case CORRECTION_DIALOG: return "dialog";
+    case CORRECTION_FOLLOW: return "follow";
+    case CORRECTION_AUTO:   return "auto";
+    default:                return "?";
+    }
+}
+
+static void PrintStats(const char* title, const CorrectionStats& s, int64_t from, int64_t to)
+{
+    if (!s.count)
+    {
+        std::printf("%-12s no corrections\n", title);
+        return;
+    }
+    std::printf("%-12s %6zu corrections  total %+10.1f s  mean |%.1f| s  range %+.1f..%+.1f s"
+                "  drift %+.2f s/day\n",
+                title, s.count, double(s.sum) / TICKS_PER_SECOND,
+                double(s.sumAbs) / TICKS_PER_SECOND / double(s.count),
+                double(s.min) / TICKS_PER_SECOND, double(s.max) / TICKS_PER_SECOND,
+                DriftPerDay(s, from, to) / TICKS_PER_SECOND);
+}
+
+int main(int argc, char** argv)
+{
+    int days = 30;
+    bool list = false, daily = false, drift = false;
+    const char* path = nullptr;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (!std::strcmp(argv[i], "--days") && i + 1 < argc) days = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "--list")) list = true;
+        else if (!std::strcmp(argv[i], "--daily")) daily = true;
+        else if (!std::strcmp(argv[i], "--drift")) drift = true;
+        else path = argv[i];
+    }
+    if (!path || days <= 0)
+    {
+        std::fprintf(stderr, "usage: %s [--days N] [--list] [--daily] [--drift] FILE\n", argv[0]);
+        return 2;
+    }
+
+    CorrectionReader r;
+    if (!r.Open(path))
+    {
+        std::fprintf(stderr, "%s: cannot open\n", path);
+        return 1;
+    }
+    if (!r.Size())
+    {
+        std::printf("%s: no corrections\n", path);
+        return 0;
+    }
+
+    char a[32], b[32];
+    int64_t to = r.LastAt() + 1;
+    int64_t from = to - days * DAY_TICKS;
+    std::printf("%s: %zu corrections in %zu blocks, %s .. %s\n", path, r.Size(), r.Blocks(),
+                FormatDate(r.FirstAt(), a, sizeof(a)), FormatDate(r.LastAt(), b, sizeof(b)));
+    if (r.CorruptBlocks())
+        std::fprintf(stderr, "%s: %zu damaged blocks skipped\n", path, r.CorruptBlocks());
+    PrintStats("all time", r.Aggregate(INT64_MIN, INT64_MAX), r.FirstAt(), to);
+    char title[32];
+    std::snprintf(title, sizeof(title), "last %d d", days);
+    PrintStats(title, r.Aggregate(from, to), from, to);
+
+    if (daily)
+    {
+        std::vector<CorrectionStats> buckets;
+        r.Buckets(from, to, DAY_TICKS, &buckets);
+        for (size_t i = 0; i < buckets.size(); ++i)
+        {
+            if (!buckets[i].count) continue;
+            int64_t day = from + static_cast<int64_t>(i) * DAY_TICKS;
+            PrintStats(FormatDate(day, a, sizeof(a)), buckets[i], day, day + DAY_TICKS);
+        }
+    }
+    if (drift)
+    {
+        std::vector<int64_t> at;
+        std::vector<double> minute;
+        CollectDriftObservations(r, DriftOptions(), MINUTES_IN_DAY, nullptr, &at, &minute);
+        DriftFit fit = FitDriftBatch(at.data(), minute.data(), at.size(), to);
+        double error = fit.minutesPerSecond * double(GAME_MINUTE_TICKS) / TICKS_PER_SECOND - 1;
+        std::printf("drift fit    %6zu observations  %s  %lld ticks/minute (nominal %lld)"
+                    "  %+.1f s/day  sigma %.2f min\n",
+                    at.size(), fit.rateFitted ? "fitted " : "nominal",
+                    static_cast<long long>(fit.TicksPerMinute()),
+                    static_cast<long long>(GAME_MINUTE_TICKS), error * 86400.0, fit.sigma);
+    }
+    if (list)
+    {
+        std::vector<Correction> cs;
+        r.Range(from, to, &cs);
+        for (const Correction& c : cs)
+            std::printf("%s  %+10.1f s  %s\n", FormatDate(c.at, a, sizeof(a)),
+                        double(c.Shift()) / TICKS_PER_SECOND, SourceName(c.source));
+    }
+    return 0;
+}
@@ -0,0 +1,141 @@
+// -----------------------------------------------------------------------------
+// wrclock_loadtest — нагрузка на wrclockd: много клиентов в замкнутом цикле
+// (запрос -> ответ -> следующий запрос), отчёт о задержках и запросах в секунду.
+// -----------------------------------------------------------------------------
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "clock_protocol.h"
+
+static int64_t NowNs()
+{
+    using namespace std::chrono;
+    return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+struct Conn {
+    int      fd = -1;
+    uint32_t seq = 0;
+    int64_t  sentAt = 0;
+};
+
+int main(int argc, char** argv)
+{
+    const char* dir = std::getenv("XDG_RUNTIME_DIR");
+    std::string socketPath = std::string(dir && *dir ? dir : "/tmp") + "/wrclock.sock";
+    int clients = 1000, batch = 16;
+    double seconds = 5;
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        std::string arg = argv[i];
+        if (arg == "--socket") socketPath = argv[i + 1];
+        else if (arg == "--clients") clients = std::atoi(argv[i + 1]);
+        else if (arg == "--batch") batch = std::atoi(argv[i + 1]);
+        else if (arg == "--seconds") seconds = std::atof(argv[i + 1]);
+        else
+        {
+            std::fprintf(stderr, "usage: wrclock_loadtest [--socket PATH] [--clients N] "
+                                 "[--batch N] [--seconds S]\n");
+            return 2;
+        }
+    }
+    if (batch < 1 || batch > static_cast<int>(WIRE_MAX_BATCH)) batch = 16;
+
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    std::snprintf(addr.sun_path, sizeof(addr.sun_path), "%s", socketPath.c_str());
+
+    // Смесь всех видов запросов в одном сообщении
+    std::vector<ClockQuery> queries(batch);
+    for (int i = 0; i < batch; ++i)
+    {
+        static const uint8_t ops[] = { OP_GAME_NOW, OP_NEXT_MIDNIGHT, OP_GAME_AT, OP_DEADLINE_OF };
+        queries[i].op  = ops[i % 4];
+        queries[i].arg = queries[i].op == OP_DEADLINE_OF ? 1000 + i : (i % 4 == 2 ? 133000000000000000LL : 0);
+    }
+
+    int ep = epoll_create1(0);
+    std::vector<Conn> conns(clients);
+    uint8_t req[WIRE_MAX_REQUEST];
+    uint8_t resp[WIRE_MAX_RESPONSE];
+    std::vector<ClockAnswer> answers(WIRE_MAX_BATCH);
+
+    auto sendNext = [&](int idx) {
+        Conn& c = conns[idx];
+        size_t size = EncodeRequest(req, sizeof(req), ++c.seq, queries.data(), queries.size());
+        c.sentAt = NowNs();
+        return send(c.fd, req, size, MSG_NOSIGNAL) == static_cast<ssize_t>(size);
+    };
+
+    for (int i = 0; i < clients; ++i)
+    {
+        int fd = socket(AF_UNIX, SOCK_SEQPACKET, 0);
+        if (fd < 0 || connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0)
+        {
+            std::fprintf(stderr, "connect %s: %s (client %d)\n", socketPath.c_str(),
+                         std::strerror(errno), i);
+            return 1;
+        }
+        conns[i].fd = fd;
+        epoll_event ev{};
+        ev.events = EPOLLIN;
+        ev.data.u32 = static_cast<uint32_t>(i);
+        epoll_ctl(ep, EPOLL_CTL_ADD, fd, &ev);
+    }
+
+    std::vector<int64_t> latencies;
+    latencies.reserve(1 << 22);
+    int64_t errors = 0;
+
+    int64_t start = NowNs();
+    int64_t stopAt = start + static_cast<int64_t>(seconds * 1e9);
+    for (int i = 0; i < clients; ++i) sendNext(i);
+
+    epoll_event events[512];
+    int64_t now = start;
+    while (now < stopAt)
+    {
+        int n = epoll_wait(ep, events, 512, 100);
+        now = NowNs();
+        for (int k = 0; k < n; ++k)
+        {
+            int idx = static_cast<int>(events[k].data.u32);
+            Conn& c = conns[idx];
+            ssize_t r = recv(c.fd, resp, sizeof(resp), 0);
+            uint32_t seq = 0;
+            int got = r > 0 ? DecodeResponse(resp, static_cast<size_t>(r), &seq, answers.data(), answers.size()) : -1;
+            if (got != batch || seq != c.seq)
+                ++errors;
+            latencies.push_back(now - c.sentAt);
+            if (now < stopAt) sendNext(idx);
+        }
+    }
+    double elapsed = double(NowNs() - start) / 1e9;
+
+    std::sort(latencies.begin(), latencies.end());
+    auto pct = [&](double p) {
+        if (latencies.empty()) return 0.0;
+        size_t i = static_cast<size_t>(p * double(latencies.size() - 1));
+        return double(latencies[i]) / 1000.0;
+    };
+    double messages = double(latencies.size());
+    std::printf("clients %d, batch %d, %.1f s\n", clients, batch, elapsed);
+    std::printf("messages/s %12.0f\n", messages / elapsed);
+    std::printf("queries/s  %12.0f\n", messages * batch / elapsed);
+    std::printf("latency us p50 %.1f  p99 %.1f  p99.9 %.1f  max %.1f\n",
+                pct(0.50), pct(0.99), pct(0.999), pct(1.0));
+    if (errors) std::printf("errors     %12lld\n", static_cast<long long>(errors));
+
+    for (auto& c : conns) close(c.fd);
+    close(ep);
+    return errors ? 1 : 0;
+}
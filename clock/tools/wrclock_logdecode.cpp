@@ -0,0 +1,59 @@
+// -----------------------------------------------------------------------------
+// wrclock_logdecode — расшифровка двоичного журнала событий (EventLog,
+// LogFormat::Binary) в тот же текст, что пишет текстовый режим.
+//
+//   wrclock_logdecode [--threads] clock.evlog
+// -----------------------------------------------------------------------------
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include "event_log.h"
+#include "file_io.h"
+
+template <typename T>
+static inline T Get(const uint8_t* p) { T v; std::memcpy(&v, p, sizeof(T)); return v; }
+
+int main(int argc, char** argv)
+{
+    bool threads = false;
+    const char* path = nullptr;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (!std::strcmp(argv[i], "--threads")) threads = true;
+        else path = argv[i];
+    }
+    if (!path)
+    {
+        std::fprintf(stderr, "usage: %s [--threads] FILE\n", argv[0]);
+        return 2;
+    }
+
+    MappedFile f;
+    if (!f.Open(path))
+    {
+        std::fprintf(stderr, "%s: cannot open\n", path);
+        return 1;
+    }
+    const uint8_t* d = f.Data();
+    if (f.Size() < LOG_HEADER_SIZE || Get<uint32_t>(d) != LOG_FILE_MAGIC ||
+        Get<uint32_t>(d + 4) != LOG_FILE_VERSION || Get<uint32_t>(d + 8) != sizeof(LogRecord))
+    {
+        std::fprintf(stderr, "%s: not an event log\n", path);
+        return 1;
+    }
+
+    size_t n = (f.Size() - LOG_HEADER_SIZE) / sizeof(LogRecord);
+    char line[512];
+    for (size_t i = 0; i < n; ++i)
+    {
+        LogRecord r;
+        std::memcpy(&r, d + LOG_HEADER_SIZE + i * sizeof(LogRecord), sizeof(r));
+        size_t len = FormatLogRecord(r, line, sizeof(line));
+        if (!len) continue;
+        if (threads) std::printf("[%08x] ", r.thread);
+        std::fwrite(line, 1, len, stdout);
+    }
+    if ((f.Size() - LOG_HEADER_SIZE) % sizeof(LogRecord))
+        std::fprintf(stderr, "%s: torn record at the end ignored\n", path);
+    return 0;
+}
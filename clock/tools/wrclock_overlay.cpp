@@ -0,0 +1,212 @@
+// -----------------------------------------------------------------------------
+// wrclock_overlay — кадры часов для оверлея трансляции, без окна.
+//
+//   wrclock_overlay [--time HH:MM | --follow NAME] [--fps N] [--keyframe SEC]
+//                   [--ring NAME] [--frames N] [--full] [--dark] [--size PX]
+//                   [--clock SOURCE]
+//   wrclock_overlay --read NAME
+// Кадры (core/frame_stream.h) идут в stdout или в кольцо NAME в разделяемой
+// памяти; --full посылает каждый кадр целиком (для сравнения), --read —
+// читатель кольца, печатающий сводку по кадрам.
+// -----------------------------------------------------------------------------
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <string>
+#include <unistd.h>
+#include "clock_shm.h"
+#include "clock_source.h"
+#include "frame_stream.h"
+#include "time_parse.h"
+
+static volatile sig_atomic_t g_stop = 0;
+static void OnSignal(int) { g_stop = 1; }
+
+static int LocalMinuteOfDay()
+{
+    time_t t = time(nullptr);
+    struct tm lt;
+    localtime_r(&t, &lt);
+    return lt.tm_hour * 60 + lt.tm_min;
+}
+
+static void SleepTicks(int64_t ticks)
+{
+    if (ticks <= 0) return;
+    timespec ts{ static_cast<time_t>(ticks / TICKS_PER_SECOND),
+                 static_cast<long>(ticks % TICKS_PER_SECOND) * 100 };
+    nanosleep(&ts, nullptr);
+}
+
+static void Usage()
+{
+    std::fprintf(stderr,
+        "usage: wrclock_overlay [--time HH:MM | --follow NAME] [--fps N] [--keyframe SEC]\n"
+        "                       [--ring NAME] [--frames N] [--full] [--dark] [--size PX]\n"
+        "                       [--clock SOURCE]\n"
+        "       wrclock_overlay --read NAME\n"
+        "  --fps N          frames per second (default 10)\n"
+        "  --keyframe SEC   full frame every SEC seconds (default 10)\n"
+        "  --ring NAME      write to a shared-memory ring instead of stdout\n"
+        "  --frames N       stop after N frames\n"
+        "  --full           send every frame whole (no damage rectangles)\n"
+        "  --size PX        height of the big digits (default 48)\n"
+        "  --clock SOURCE   wall|monotonic|coarse|anchored|virtual[:N] (default anchored,\n"
+        "                   same as the app)\n"
+        "  --read NAME      read a ring and print one line per frame\n");
+}
+
+static int ReadRing(const char* name)
+{
+    FrameRingReader reader;
+    if (!reader.Open(name))
+    {
+        std::fprintf(stderr, "wrclock_overlay: no ring '%s'\n", name);
+        return 1;
+    }
+    std::signal(SIGINT, OnSignal);
+    std::signal(SIGTERM, OnSignal);
+    std::vector<uint8_t> msg;
+    PixelBuffer frame;
+    while (!g_stop)
+    {
+        if (!reader.Next(&msg))
+        {
+            SleepTicks(TICKS_PER_SECOND / 100);
+            continue;
+        }
+        if (msg.size() < sizeof(FrameHeader))
+        {
+            std::printf("short message, %zu bytes (skipped)\n", msg.size());
+            std::fflush(stdout);
+            continue;
+        }
+        FrameHeader h;
+        std::memcpy(&h, msg.data(), sizeof(h));
+        bool ok = ApplyFrame(msg.data(), msg.size(), &frame);
+        std::printf("frame %llu %s rects %u bytes %zu%s\n", static_cast<unsigned long long>(h.frame),
+                    (h.flags & FRAME_KEY) ? "key " : "diff", h.rects, msg.size(),
+                    ok ? "" : " (skipped)");
+        std::fflush(stdout);
+    }
+    std::fprintf(stderr, "wrclock_overlay: %llu overruns\n",
+                 static_cast<unsigned long long>(reader.Overruns()));
+    return 0;
+}
+
+int main(int argc, char** argv)
+{
+    int setMinute = -1;
+    const char* followName = nullptr;
+    const char* ringName = nullptr;
+    const char* clockSpec = "anchored";
+    double fps = 10, keyframe = 10;
+    long frames = -1;
+    int size = 48;
+    bool full = false, dark = false;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if (arg == "--read" && i + 1 < argc) return ReadRing(argv[++i]);
+        else if (arg == "--follow" && i + 1 < argc) followName = argv[++i];
+        else if (arg == "--ring" && i + 1 < argc) ringName = argv[++i];
+        else if (arg == "--clock" && i + 1 < argc) clockSpec = argv[++i];
+        else if (arg == "--fps" && i + 1 < argc) fps = std::atof(argv[++i]);
+        else if (arg == "--keyframe" && i + 1 < argc) keyframe = std::atof(argv[++i]);
+        else if (arg == "--frames" && i + 1 < argc) frames = std::atol(argv[++i]);
+        else if (arg == "--size" && i + 1 < argc) size = std::atoi(argv[++i]);
+        else if (arg == "--full") full = true;
+        else if (arg == "--dark") dark = true;
+        else if (arg == "--time" && i + 1 < argc)
+        {
+            std::string s = argv[++i];
+            if (!ParseClockText(s.data(), s.data() + s.size(), &setMinute))
+            {
+                std::fprintf(stderr, "wrclock_overlay: bad time '%s'\n", argv[i]);
+                return 2;
+            }
+        }
+        else { Usage(); return 2; }
+    }
+    if (fps <= 0 || fps > 240 || keyframe <= 0 || size < 8 || size > 512)
+    {
+        Usage();
+        return 2;
+    }
+    if (!ringName && isatty(STDOUT_FILENO))
+    {
+        std::fprintf(stderr, "wrclock_overlay: refusing to write frames to a terminal\n");
+        return 2;
+    }
+
+    // Источник времени тот же, что у приложения и wrclock_watch
+    std::unique_ptr<ClockSource> source = CreateClockSource(clockSpec);
+    if (!source)
+    {
+        std::fprintf(stderr, "wrclock_overlay: unknown clock source '%s'\n", clockSpec);
+        return 2;
+    }
+
+    GameClock clock;
+    int64_t now = source->Now();
+    ClockSubscriber follow;
+    ClockSnapshot snap;
+    if (followName && follow.Open(followName) && follow.Read(&snap))
+        clock.SetState(snap.state);
+    else
+        clock.SetGameTime(now, setMinute >= 0 ? setMinute : LocalMinuteOfDay());
+
+    FrameRing ring;
+    PipeFrameSink pipe(STDOUT_FILENO);
+    FrameSink* sink = &pipe;
+    if (ringName)
+    {
+        if (!ring.Open(ringName))
+        {
+            std::fprintf(stderr, "wrclock_overlay: cannot create ring '%s'\n", ringName);
+            return 1;
+        }
+        sink = &ring;
+    }
+
+    SegmentRasterizer big(size), small(size / 2);
+    OverlayRenderer renderer;
+    renderer.Setup(&big, &small, dark ? DARK_THEME : LIGHT_THEME, size * 4);
+
+    std::signal(SIGINT, OnSignal);
+    std::signal(SIGTERM, OnSignal);
+    std::signal(SIGPIPE, SIG_IGN);
+
+    const int64_t period = static_cast<int64_t>(TICKS_PER_SECOND / fps);
+    const int64_t keyEvery = static_cast<int64_t>(keyframe * TICKS_PER_SECOND);
+    int64_t nextFrame = now, nextKey = now;
+    uint64_t number = 0, sent = 0, bytes = 0;
+    std::vector<uint8_t> msg;
+    PixelRect damage[16];
+    while (!g_stop && frames != 0)
+    {
+        SleepTicks(source->RealDelay(nextFrame - source->Now()));
+        now = source->Now();
+        nextFrame += period;
+        if (nextFrame < now) nextFrame = now + period;   // отстали — не догоняем пачкой
+        if (follow.IsOpen() && follow.Generation() != snap.generation && follow.Read(&snap))
+            clock.SetState(snap.state);
+
+        size_t n = renderer.Render(ComputeClockView(clock, now), damage, 16);
+        bool key = full || now >= nextKey;
+        if (key) nextKey = now + keyEvery;
+        ++number;
+        if (frames > 0) --frames;
+        if (!key && !n) continue;   // ничего не изменилось — кадра нет
+        EncodeFrame(renderer.Frame(), damage, n, number, now, key, &msg);
+        if (!sink->Send(msg.data(), msg.size())) break;
+        ++sent;
+        bytes += msg.size();
+    }
+    std::fprintf(stderr, "wrclock_overlay: %llu frames, %llu sent, %llu bytes\n",
+                 static_cast<unsigned long long>(number), static_cast<unsigned long long>(sent),
+                 static_cast<unsigned long long>(bytes));
+    return 0;
+}
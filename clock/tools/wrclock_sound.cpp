@@ -0,0 +1,113 @@
+// -----------------------------------------------------------------------------
+// wrclock_sound — подготовка звука уведомления для ресурса IDR_NOTIFICATION.
+//
+//   wrclock_sound info INPUT
+//   wrclock_sound encode [--block N] INPUT OUTPUT   (PCM -> IMA ADPCM)
+//   wrclock_sound decode INPUT OUTPUT               (любой -> PCM 16 бит)
+// encode печатает отношение сигнал/шум после обратного декодирования.
+// -----------------------------------------------------------------------------
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include "file_io.h"
+#include "sound_decoder.h"
+
+static void Usage()
+{
+    std::fprintf(stderr,
+        "usage: wrclock_sound info INPUT\n"
+        "       wrclock_sound encode [--block N] INPUT OUTPUT\n"
+        "       wrclock_sound decode INPUT OUTPUT\n"
+        "  --block N   ADPCM bytes per channel per block (default 1024)\n");
+}
+
+static bool Load(const char* path, MappedFile* file, WaveInfo* info, PcmBuffer* pcm)
+{
+    if (!file->Open(path))
+    {
+        std::fprintf(stderr, "wrclock_sound: cannot read %s\n", path);
+        return false;
+    }
+    SoundDecoder* decoder = nullptr;
+    if (!ParseWave(file->Data(), file->Size(), info) || !(decoder = FindSoundDecoder(*info)) ||
+        !decoder->Decode(*info, pcm))
+    {
+        std::fprintf(stderr, "wrclock_sound: %s: not a supported WAV file\n", path);
+        return false;
+    }
+    return true;
+}
+
+static bool Save(const char* path, const std::vector<uint8_t>& data)
+{
+    OutputFile out;
+    if (!out.Open(path, true) || !out.Write(data.data(), data.size()))
+    {
+        std::fprintf(stderr, "wrclock_sound: cannot write %s\n", path);
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 3)
+    {
+        Usage();
+        return 2;
+    }
+    std::string mode = argv[1];
+    unsigned block = IMA_ADPCM_CHANNEL_BLOCK;
+    int i = 2;
+    if (mode == "encode" && std::string(argv[i]) == "--block" && i + 1 < argc)
+    {
+        block = static_cast<unsigned>(std::atoi(argv[i + 1]));
+        i += 2;
+    }
+    const char* input = i < argc ? argv[i] : nullptr;
+    const char* output = i + 1 < argc ? argv[i + 1] : nullptr;
+    bool needOutput = mode == "encode" || mode == "decode";
+    if (!input || (needOutput && (!output || i + 2 != argc)) || (!needOutput && i + 1 != argc) ||
+        (mode != "info" && !needOutput) || block > 0xFFFF)
+    {
+        Usage();
+        return 2;
+    }
+
+    MappedFile file;
+    WaveInfo info;
+    PcmBuffer pcm;
+    if (!Load(input, &file, &info, &pcm)) return 1;
+    std::printf("%s: format 0x%04x, %u ch, %u Hz, %zu frames (%.2f s), %zu bytes -> %zu bytes PCM\n",
+                input, info.format, info.channels, info.sampleRate, pcm.Frames(),
+                double(pcm.Frames()) / info.sampleRate, file.Size(), pcm.Bytes());
+    if (mode == "info") return 0;
+
+    std::vector<uint8_t> wave;
+    if (mode == "decode")
+        EncodePcmWave(pcm, &wave);
+    else if (!EncodeImaAdpcmWave(pcm, static_cast<uint16_t>(block), &wave))
+    {
+        std::fprintf(stderr, "wrclock_sound: bad block size %u\n", block);
+        return 2;
+    }
+    if (!Save(output, wave)) return 1;
+
+    if (mode == "encode")
+    {
+        PcmBuffer back;
+        DecodeSound(wave.data(), wave.size(), &back);
+        double signal = 0, noise = 0;
+        for (size_t k = 0; k < pcm.samples.size() && k < back.samples.size(); ++k)
+        {
+            double s = pcm.samples[k], e = s - back.samples[k];
+            signal += s * s;
+            noise += e * e;
+        }
+        std::printf("%s: %zu bytes (%.1fx smaller), SNR %.1f dB\n", output, wave.size(),
+                    double(file.Size()) / double(wave.size()),
+                    noise > 0 ? 10 * std::log10(signal / noise) : 99.0);
+    }
+    return 0;
+}
@@ -0,0 +1,160 @@
+// -----------------------------------------------------------------------------
+// wrclock_watch — игровые часы в терминале.
+//
+// Показывает те же три строки, что и окно, через ClockViewModel: на терминал
+// уходят только изменившиеся строки. Если вывод не терминал — по строке
+// на каждое изменение.
+// -----------------------------------------------------------------------------
+#include <csignal>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <string>
+#include <unistd.h>
+#include "clock_shm.h"
+#include "clock_source.h"
+#include "clock_view.h"
+#include "time_format.h"
+
+static volatile sig_atomic_t g_stop = 0;
+static void OnSignal(int) { g_stop = 1; }
+
+class TerminalViewSink : public ClockViewSink {
+public:
+    explicit TerminalViewSink(bool tty) : m_tty(tty) {}
+
+    void Present(const ClockView& v, unsigned changed) override
+    {
+        char line[64];
+        if (!m_tty)
+        {
+            if (changed & FIELD_TIME)
+                std::printf("time %s\n", (AppendHHMM(line, v.minuteOfDay), line));
+            if (changed & FIELD_COUNTDOWN)
+                std::printf("to-midnight %s\n", (AppendHHMM(line, v.minutesToMidnight), line));
+            if (changed & FIELD_REAL_COUNTDOWN)
+                std::printf("real %s\n", (AppendMMSS(line, v.realSeconds), line));
+            std::fflush(stdout);
+            return;
+        }
+        if (!m_drawn)
+        {
+            std::fputs("\n\n\n", stdout);
+            m_drawn = true;
+        }
+        // Курсор стоит под третьей строкой; переписываем только нужные
+        for (int row = 0; row < 3; ++row)
+        {
+            if (!(changed & (1u << row))) continue;
+            if (row == 0) AppendHHMM(line, v.minuteOfDay);
+            else if (row == 1) AppendHHMM(AppendLiteral(line, "До полуночи: "), v.minutesToMidnight);
+            else AppendMMSS(AppendLiteral(line, "Реальное время: "), v.realSeconds);
+            std::printf("\033[%dF\033[2K%s\033[%dE", 3 - row, line, 3 - row);
+        }
+        std::fflush(stdout);
+    }
+
+private:
+    bool m_tty;
+    bool m_drawn = false;
+};
+
+static int LocalMinuteOfDay()
+{
+    time_t t = time(nullptr);
+    struct tm lt;
+    localtime_r(&t, &lt);
+    return lt.tm_hour * 60 + lt.tm_min;
+}
+
+static void Usage()
+{
+    std::fprintf(stderr,
+        "usage: wrclock_watch [--time HH:MM | --follow NAME] [--clock SOURCE] [--updates N]\n"
+        "  --time HH:MM    start from this game time\n"
+        "  --follow NAME   follow the clock published to shared memory (default wrclock)\n"
+        "  --clock SOURCE  wall|monotonic|coarse|anchored|virtual[:N], as the app's --clock\n"
+        "                  (default anchored, same as the app)\n"
+        "  --updates N     exit after N screen updates\n");
+}
+
+int main(int argc, char** argv)
+{
+    int setMinute = -1;
+    const char* followName = CLOCK_SHM_DEFAULT_NAME;
+    const char* clockSpec = "anchored";
+    long updates = -1;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if (arg == "--follow" && i + 1 < argc) followName = argv[++i];
+        else if (arg == "--clock" && i + 1 < argc) clockSpec = argv[++i];
+        else if (arg == "--updates" && i + 1 < argc) updates = std::atol(argv[++i]);
+        else if (arg == "--time" && i + 1 < argc)
+        {
+            int h, m;
+            if (std::sscanf(argv[++i], "%d%*[^0-9]%d", &h, &m) != 2 ||
+                h < 0 || h >= 24 || m < 0 || m >= 60)
+            {
+                std::fprintf(stderr, "wrclock_watch: bad time '%s'\n", argv[i]);
+                return 2;
+            }
+            setMinute = h * 60 + m;
+            followName = nullptr;
+        }
+        else { Usage(); return 2; }
+    }
+
+    // Источник времени тот же, что у приложения: иначе после перевода
+    // системных часов окно и терминал показывали бы разное время
+    std::unique_ptr<ClockSource> source = CreateClockSource(clockSpec);
+    if (!source)
+    {
+        std::fprintf(stderr, "wrclock_watch: unknown clock source '%s'\n", clockSpec);
+        return 2;
+    }
+
+    GameClock clock;
+    int64_t now = source->Now();
+    ClockSubscriber follow;
+    ClockSnapshot snap;
+    if (followName && follow.Open(followName) && follow.Read(&snap))
+        clock.SetState(snap.state);
+    else
+        clock.SetGameTime(now, setMinute >= 0 ? setMinute : LocalMinuteOfDay());
+
+    std::signal(SIGINT, OnSignal);
+    std::signal(SIGTERM, OnSignal);
+
+    TerminalViewSink sink(isatty(STDOUT_FILENO) != 0);
+    ClockViewModel model;
+    model.Attach(&sink);
+    TickScheduler sched(now);
+
+    while (!g_stop && updates != 0)
+    {
+        now = source->Now();
+        if (follow.IsOpen() && follow.Generation() != snap.generation && follow.Read(&snap))
+        {
+            clock.SetState(snap.state);
+            sched.Invalidate();
+        }
+        if (sched.DisplayDue(now))
+        {
+            if (model.Update(clock, now) && updates > 0) --updates;
+            sched.OnDisplayed(clock, now);
+        }
+
+        // Спим до следующего изменения; за издателем следим раз в 250 мс
+        int64_t wait = source->RealDelay(sched.NextWakeup() - source->Now());
+        if (follow.IsOpen() && wait > TICKS_PER_SECOND / 4) wait = TICKS_PER_SECOND / 4;
+        if (wait > 0)
+        {
+            timespec ts{ static_cast<time_t>(wait / TICKS_PER_SECOND),
+                         static_cast<long>(wait % TICKS_PER_SECOND) * 100 };
+            nanosleep(&ts, nullptr);
+        }
+    }
+    if (isatty(STDOUT_FILENO)) std::fputs("\n", stdout);
+    return 0;
+}
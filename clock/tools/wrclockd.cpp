@@ -0,0 +1,401 @@
+// -----------------------------------------------------------------------------
+// wrclockd — демон игрового времени для Linux.
+//
+// Отвечает на пакетные запросы (см. clock_protocol.h) через Unix-сокет
+// SOCK_SEQPACKET; все клиенты обслуживаются одним потоком на epoll.
+// -----------------------------------------------------------------------------
+#include <cerrno>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <memory>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "clock_protocol.h"
+#include "clock_source.h"
+#include "clock_shm.h"
+#include "correction_history.h"
+#include "game_ini.h"
+#include "rate_profile.h"
+#include "state_journal.h"
+#include "trace.h"
+
+static volatile sig_atomic_t g_stop = 0;
+static void OnSignal(int) { g_stop = 1; }
+
+struct Client {
+    int fd = -1;
+    std::vector<uint8_t> pending;   // ответ, не влезший в сокет
+};
+
+static TraceHistogram s_batchUs("serve.batch_us");       // обработка одной пачки epoll
+static TraceHistogram s_batchEvents("serve.batch_events");
+
+static std::vector<Client> g_clients;
+static int g_epoll = -1;
+static int g_listenFd = -1;
+static bool g_acceptPaused = false;   // дескрипторов нет, слушающий сокет снят с epoll
+
+// Запасной дескриптор: когда дескрипторы кончились (EMFILE/ENFILE), входящее
+// соединение всё равно остаётся в очереди, и epoll по уровню будил бы нас
+// без конца. Запасной закрывается, соединение принимается и сразу
+// закрывается — клиент видит отказ, а очередь пустеет
+static int g_spareFd = -1;
+
+static void ReserveSpareFd()
+{
+    if (g_spareFd < 0) g_spareFd = open("/dev/null", O_RDONLY | O_CLOEXEC);
+}
+
+static std::string DefaultSocketPath()
+{
+    const char* dir = std::getenv("XDG_RUNTIME_DIR");
+    return std::string(dir && *dir ? dir : "/tmp") + "/wrclock.sock";
+}
+
+static int LocalMinuteOfDay()
+{
+    time_t t = time(nullptr);
+    struct tm lt;
+    localtime_r(&t, &lt);
+    return lt.tm_hour * 60 + lt.tm_min;
+}
+
+static void Watch(int fd, uint32_t events, int op)
+{
+    epoll_event ev{};
+    ev.events = events;
+    ev.data.fd = fd;
+    epoll_ctl(g_epoll, op, fd, &ev);
+}
+
+static void CloseClient(int fd)
+{
+    epoll_ctl(g_epoll, EPOLL_CTL_DEL, fd, nullptr);
+    close(fd);
+    g_clients[fd].fd = -1;
+    g_clients[fd].pending.clear();
+    if (g_acceptPaused)
+    {
+        // Дескриптор освободился — снова принимаем соединения
+        g_acceptPaused = false;
+        ReserveSpareFd();
+        Watch(g_listenFd, EPOLLIN, EPOLL_CTL_MOD);
+    }
+}
+
+// Кто-то уже принимает соединения на этом пути? stale — файл сокета есть,
+// но за ним никого (демон упал), его можно удалить
+static bool DaemonAnswers(const sockaddr_un& addr, bool* stale)
+{
+    *stale = false;
+    int fd = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+    if (fd < 0) return false;
+    bool answers = connect(fd, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) == 0;
+    if (!answers && errno == ECONNREFUSED) *stale = true;
+    close(fd);
+    return answers;
+}
+
+static void AcceptAll(int listenFd)
+{
+    for (;;)
+    {
+        int fd = accept4(listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0)
+        {
+            if (errno == EINTR || errno == ECONNABORTED) continue;
+            if (errno != EMFILE && errno != ENFILE) return;
+            if (g_spareFd >= 0)
+            {
+                close(g_spareFd);
+                g_spareFd = -1;
+                fd = accept4(listenFd, nullptr, nullptr, SOCK_CLOEXEC);
+                int err = errno;
+                if (fd >= 0) close(fd);
+                ReserveSpareFd();
+                if (fd >= 0 || err == EINTR || err == ECONNABORTED) continue;
+                if (err == EAGAIN || err == EWOULDBLOCK) return;
+            }
+            // Запасного нет (ENFILE — кончились дескрипторы всей системы):
+            // не слушаем, пока не закроется один из клиентов
+            std::fprintf(stderr, "wrclockd: out of file descriptors, not accepting\n");
+            Watch(listenFd, 0, EPOLL_CTL_MOD);
+            g_acceptPaused = true;
+            return;
+        }
+        if (static_cast<size_t>(fd) >= g_clients.size()) g_clients.resize(fd + 1024);
+        g_clients[fd].fd = fd;
+        Watch(fd, EPOLLIN, EPOLL_CTL_ADD);
+    }
+}
+
+// true — ответ ушёл целиком, false — сокет полон (ответ отложен) или закрыт
+static bool SendReply(Client& c, const uint8_t* data, size_t size)
+{
+    ssize_t n = send(c.fd, data, size, MSG_NOSIGNAL);
+    if (n == static_cast<ssize_t>(size)) return true;
+    if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+    {
+        // Пока клиент не заберёт ответ, новые запросы от него не читаем
+        c.pending.assign(data, data + size);
+        Watch(c.fd, EPOLLOUT, EPOLL_CTL_MOD);
+    }
+    else
+    {
+        CloseClient(c.fd);
+    }
+    return false;
+}
+
+static void ServeClient(Client& c, uint32_t events, const GameClock& clock, ReadClockFn read, int64_t now)
+{
+    static uint8_t in[WIRE_MAX_REQUEST + 1];
+    static uint8_t out[WIRE_MAX_RESPONSE];
+
+    if (events & (EPOLLERR | EPOLLHUP)) { CloseClient(c.fd); return; }
+    if (events & EPOLLOUT)
+    {
+        std::vector<uint8_t> data;
+        data.swap(c.pending);
+        if (!SendReply(c, data.data(), data.size())) return;
+        Watch(c.fd, EPOLLIN, EPOLL_CTL_MOD);
+    }
+    if (!(events & EPOLLIN)) return;
+
+    // Не больше 32 сообщений за раз, чтобы один клиент не занимал цикл
+    for (int i = 0; i < 32; ++i)
+    {
+        ssize_t n = recv(c.fd, in, sizeof(in), 0);
+        if (n == 0) { CloseClient(c.fd); return; }
+        if (n < 0)
+        {
+            if (errno != EAGAIN && errno != EWOULDBLOCK) CloseClient(c.fd);
+            return;
+        }
+        size_t size = HandleRequest(clock.State(), read, now, in, static_cast<size_t>(n), out);
+        if (!size) { CloseClient(c.fd); return; }
+        if (!SendReply(c, out, size)) return;
+    }
+}
+
+static void Usage()
+{
+    std::fprintf(stderr,
+        "usage: wrclockd [--socket PATH] [--journal PATH | --ini PATH | --time HH:MM | --follow NAME]\n"
+        "                [--publish NAME] [--profile NAME] [--clock SOURCE] [--trace FILE]\n"
+        "                [--history PATH]\n"
+        "  --socket PATH  Unix socket (default $XDG_RUNTIME_DIR/wrclock.sock)\n"
+        "  --journal PATH continue from gameclock.journal written by the Windows app\n"
+        "  --ini PATH     continue from gameclock.ini saved by older versions\n"
+        "  --time HH:MM   current game time\n"
+        "  --follow NAME  take the clock from shared memory published by another process\n"
+        "  --publish NAME publish this daemon's clock to shared memory\n"
+        "  --profile NAME game speed (default, realtime, fast, shortday, test)\n"
+        "  --clock SOURCE anchored (default), wall, monotonic, coarse, virtual[:SPEED]\n"
+        "  --trace FILE   write a Chrome trace and print metrics on exit\n"
+        "  --history PATH record clock changes picked up with --follow\n");
+}
+
+int main(int argc, char** argv)
+{
+    std::string socketPath = DefaultSocketPath();
+    const char* iniPath = nullptr;
+    const char* journalPath = nullptr;
+    int setMinute = -1;
+    const char* followName = nullptr;
+    const char* publishName = nullptr;
+    const RateProfileInfo* profile = nullptr;
+    const char* sourceName = "anchored";
+    const char* tracePath = nullptr;
+    const char* historyPath = nullptr;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if (arg == "--socket" && i + 1 < argc) socketPath = argv[++i];
+        else if (arg == "--ini" && i + 1 < argc) iniPath = argv[++i];
+        else if (arg == "--journal" && i + 1 < argc) journalPath = argv[++i];
+        else if (arg == "--follow" && i + 1 < argc) followName = argv[++i];
+        else if (arg == "--publish" && i + 1 < argc) publishName = argv[++i];
+        else if (arg == "--clock" && i + 1 < argc) sourceName = argv[++i];
+        else if (arg == "--trace" && i + 1 < argc) tracePath = argv[++i];
+        else if (arg == "--history" && i + 1 < argc) historyPath = argv[++i];
+        else if (arg == "--profile" && i + 1 < argc)
+        {
+            if (!(profile = FindRateProfile(argv[++i])))
+            {
+                std::fprintf(stderr, "wrclockd: unknown profile '%s'\n", argv[i]);
+                return 2;
+            }
+        }
+        else if (arg == "--time" && i + 1 < argc)
+        {
+            int h, m;
+            if (std::sscanf(argv[++i], "%d%*[^0-9]%d", &h, &m) != 2 ||
+                h < 0 || h >= 24 || m < 0 || m >= 60)
+            {
+                std::fprintf(stderr, "wrclockd: bad time '%s'\n", argv[i]);
+                return 2;
+            }
+            setMinute = h * 60 + m;
+        }
+        else { Usage(); return 2; }
+    }
+
+    if (tracePath)
+        TraceEnable(true);
+    std::unique_ptr<ClockSource> source = CreateClockSource(sourceName);
+    if (!source)
+    {
+        std::fprintf(stderr, "wrclockd: unknown clock source '%s'\n", sourceName);
+        return 2;
+    }
+
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    if (socketPath.size() >= sizeof(addr.sun_path))
+    {
+        std::fprintf(stderr, "wrclockd: socket path too long\n");
+        return 1;
+    }
+    std::memcpy(addr.sun_path, socketPath.c_str(), socketPath.size() + 1);
+
+    // Сокет занимается до чтения журнала и публикации: второй демон на том
+    // же пути не должен ни отобрать его у первого, ни перезаписать его часы
+    bool stale = false;
+    if (DaemonAnswers(addr, &stale))
+    {
+        std::fprintf(stderr, "wrclockd: another daemon is listening on %s\n", socketPath.c_str());
+        return 1;
+    }
+    if (stale) unlink(socketPath.c_str());
+    int listenFd = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (listenFd < 0 || bind(listenFd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 ||
+        listen(listenFd, SOMAXCONN) < 0)
+    {
+        std::fprintf(stderr, "wrclockd: %s: %s\n", socketPath.c_str(), std::strerror(errno));
+        return 1;
+    }
+
+    GameClock clock;
+    int64_t now = source->Now();
+    SavedGameTime saved;
+    JournalLoad journal;
+    if (setMinute >= 0)
+        clock.SetGameTime(now, setMinute);
+    else if (journalPath && LoadJournal(journalPath, &journal) && journal.found && now > journal.last.at)
+        clock.SetState(journal.last.state);
+    else
+    {
+        // Как в приложении: если время ушло назад от последней записи,
+        // журналу не верим и берём местное
+        if (journalPath && journal.found)
+            std::fprintf(stderr, "wrclockd: %s is ahead of the clock, using local time\n", journalPath);
+        else if (journalPath)
+            std::fprintf(stderr, "wrclockd: no state in %s, using local time\n", journalPath);
+        else if (iniPath && !ReadGameIni(iniPath, &saved))
+            std::fprintf(stderr, "wrclockd: cannot read %s, using local time\n", iniPath);
+        RestoreGameClock(&clock, saved, now, LocalMinuteOfDay());
+    }
+    // Скорость из профиля; текущее время суток сохраняется
+    if (profile && !followName)
+        ApplyRateProfile(&clock, *profile, now);
+
+    ClockSubscriber follow;
+    ClockSnapshot snap;
+    if (followName)
+    {
+        if (!follow.Open(followName) || !follow.Read(&snap))
+        {
+            std::fprintf(stderr, "wrclockd: nothing published as '%s'\n", followName);
+            return 1;
+        }
+        clock.SetState(snap.state);
+    }
+    // Чтение часов с делением на константы профиля выбирается один раз;
+    // заново — только когда скорость сменилась при слежении
+    ReadClockFn read = profile && !followName ? profile->read : SelectReadClock(clock.State());
+    CorrectionHistory history;
+    if (historyPath && !history.Open(historyPath))
+    {
+        std::fprintf(stderr, "wrclockd: cannot open %s\n", historyPath);
+        return 1;
+    }
+
+    ClockPublisher publisher;
+    if (publishName)
+    {
+        if (!publisher.Open(publishName))
+        {
+            std::fprintf(stderr, "wrclockd: cannot publish '%s' (another publisher is running?)\n", publishName);
+            return 1;
+        }
+        publisher.Publish(clock.State());
+    }
+
+    struct sigaction sa{};
+    sa.sa_handler = OnSignal;
+    sigaction(SIGINT, &sa, nullptr);
+    sigaction(SIGTERM, &sa, nullptr);
+    signal(SIGPIPE, SIG_IGN);
+
+    g_epoll = epoll_create1(EPOLL_CLOEXEC);
+    g_clients.resize(4096);
+    g_listenFd = listenFd;
+    ReserveSpareFd();
+    Watch(listenFd, EPOLLIN, EPOLL_CTL_ADD);
+    std::fprintf(stderr, "wrclockd: listening on %s, game time %02d:%02d\n",
+                 socketPath.c_str(), clock.MinuteOfDay(now) / 60, clock.MinuteOfDay(now) % 60);
+
+    epoll_event events[256];
+    while (!g_stop)
+    {
+        int n = epoll_wait(g_epoll, events, 256, -1);
+        if (n < 0)
+        {
+            if (errno == EINTR) continue;
+            break;
+        }
+        TRACE_SPAN("serve.batch");
+        int64_t t0 = TraceEnabled() ? TraceNowNs() : 0;
+        now = source->Now();   // один замер времени на всю пачку событий
+        if (followName && follow.Generation() != snap.generation && follow.Read(&snap))
+        {
+            if (history.IsOpen())
+                history.Append(MakeCorrection(now, clock.State(), snap.state, CORRECTION_FOLLOW));
+            clock.SetState(snap.state);
+            read = SelectReadClock(clock.State());
+        }
+        for (int i = 0; i < n; ++i)
+        {
+            int fd = events[i].data.fd;
+            if (fd == listenFd)
+                AcceptAll(listenFd);
+            else if (g_clients[fd].fd == fd)
+                ServeClient(g_clients[fd], events[i].events, clock, read, now);
+        }
+        if (t0)
+        {
+            s_batchUs.Record((TraceNowNs() - t0) / 1000);
+            s_batchEvents.Record(n);
+        }
+    }
+
+    close(listenFd);
+    unlink(socketPath.c_str());
+    if (tracePath)
+    {
+        TraceEnable(false);
+        if (!TraceWriteChrome(tracePath))
+            std::fprintf(stderr, "wrclockd: cannot write %s\n", tracePath);
+        std::fputs(TraceReport().c_str(), stderr);
+    }
+    return 0;
+}